@@ -43,12 +43,14 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
   // 3.     Delete R from the page table and insert P.
   // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
   std::lock_guard<std::mutex> lock(this->latch_);
-  if (this->allPinned()) return nullptr;
   auto iterator = page_table_.find(page_id);
   if (iterator != page_table_.end()) {
     replacer_->Pin(iterator->second);
-    return GetPages() + iterator->second;
+    auto page = GetPages() + iterator->second;
+    page->pin_count_++;
+    return page;
   }
+  if (this->allPinned()) return nullptr;
   auto frame_id = this->victimPage();
   if (frame_id < 0) {
     return nullptr;
@@ -163,6 +165,9 @@ bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
   }
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
   page->ResetMemory();
+  page->is_dirty_ = false;
+  // the frame is handed out from the free list again, the replacer must not pick it as a victim too
+  replacer_->Pin(iterator->second);
   this->free_list_.push_back(iterator->second);
   page_table_.erase(iterator);
   this->disk_manager_->DeallocatePage(page_id);
@@ -0,0 +1,535 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cuckoo_hash_table.cpp
+//
+// Identification: src/container/hash/cuckoo_hash_table.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "container/hash/cuckoo_hash_table.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+CUCKOO_HASH_TABLE_TYPE::CuckooHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                        const KeyComparator &comparator, size_t num_buckets,
+                                        HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), random_(15445), hash_fn_(std::move(hash_fn)) {
+  header_page_id_ = NewLayout(num_buckets);
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HashTableHeaderPage *CUCKOO_HASH_TABLE_TYPE::FetchHeaderPage() {
+  auto *page = buffer_pool_manager_->FetchPage(header_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while FetchHeaderPage");
+  }
+  return reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+}
+
+/*
+ * The size field of the header page counts buckets. A layout always consists
+ * of whole block pages, so bucket i lives in block i / BUCKETS_PER_BLOCK.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t CUCKOO_HASH_TABLE_TYPE::NewLayout(size_t num_buckets) {
+  static_assert(BUCKETS_PER_BLOCK >= 2, "a block page must hold both candidate buckets of a key");
+  size_t num_blocks = (num_buckets + BUCKETS_PER_BLOCK - 1) / BUCKETS_PER_BLOCK;
+  num_blocks = std::max<size_t>(1, std::min<size_t>(num_blocks, HEADER_ARRAY_SIZE));
+  page_id_t header_page_id;
+  auto *page = buffer_pool_manager_->NewPage(&header_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while NewLayout");
+  }
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  header->SetPageId(header_page_id);
+  header->SetSize(num_blocks * BUCKETS_PER_BLOCK);
+  for (size_t i = 0; i < num_blocks; i++) {
+    page_id_t block_page_id;
+    if (buffer_pool_manager_->NewPage(&block_page_id) == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while NewLayout");
+    }
+    header->AddBlockPageId(block_page_id);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, true);
+  return header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void CUCKOO_HASH_TABLE_TYPE::DeleteLayout(page_id_t header_page_id) {
+  auto *page = buffer_pool_manager_->FetchPage(header_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while DeleteLayout");
+  }
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  for (size_t i = 0; i < header->NumBlocks(); i++) {
+    buffer_pool_manager_->DeletePage(header->GetBlockPageId(i));
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  buffer_pool_manager_->DeletePage(header_page_id);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *CUCKOO_HASH_TABLE_TYPE::FetchBlockPage(page_id_t block_page_id, bool exclusive) {
+  auto *page = buffer_pool_manager_->FetchPage(block_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while FetchBlockPage");
+  }
+  if (exclusive) {
+    page->WLatch();
+  } else {
+    page->RLatch();
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void CUCKOO_HASH_TABLE_TYPE::ReleaseBlockPage(Page *page, bool exclusive, bool dirty) {
+  if (exclusive) {
+    page->WUnlatch();
+  } else {
+    page->RUnlatch();
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), dirty);
+}
+
+/*
+ * Both pages stay latched during visit, taken in page id order, so two inserts
+ * of the same pair serialize on them without ever waiting for each other in a
+ * cycle. Both buckets may share a page, which is then latched once.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+void CUCKOO_HASH_TABLE_TYPE::VisitBuckets(HashTableHeaderPage *header, uint64_t hash, bool exclusive, Visitor visit) {
+  size_t num_buckets = header->GetSize();
+  size_t bucket_ids[2] = {FirstBucket(hash, num_buckets), SecondBucket(hash, num_buckets)};
+  page_id_t page_ids[2] = {header->GetBlockPageId(bucket_ids[0] / BUCKETS_PER_BLOCK),
+                           header->GetBlockPageId(bucket_ids[1] / BUCKETS_PER_BLOCK)};
+  int first = page_ids[0] <= page_ids[1] ? 0 : 1;
+  Page *pages[2];
+  pages[first] = FetchBlockPage(page_ids[first], exclusive);
+  pages[1 - first] = page_ids[0] == page_ids[1] ? pages[first] : FetchBlockPage(page_ids[1 - first], exclusive);
+  Bucket buckets[2];
+  for (int i = 0; i < 2; i++) {
+    buckets[i] = {reinterpret_cast<BlockPage *>(pages[i]->GetData()),
+                  static_cast<slot_offset_t>(bucket_ids[i] % BUCKETS_PER_BLOCK * BUCKET_SIZE)};
+  }
+  bool dirty = false;
+  visit(buckets, &dirty);
+  if (page_ids[0] != page_ids[1]) {
+    ReleaseBlockPage(pages[1 - first], exclusive, dirty);
+  }
+  ReleaseBlockPage(pages[first], exclusive, dirty);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+typename CUCKOO_HASH_TABLE_TYPE::InsertResult CUCKOO_HASH_TABLE_TYPE::InsertIntoBuckets(HashTableHeaderPage *header,
+                                                                                        const KeyType &key,
+                                                                                        uint64_t hash,
+                                                                                        const ValueType &value,
+                                                                                        bool check_duplicate) {
+  uint8_t tag = BlockPage::HashTag(hash);
+  if (check_duplicate) {
+    for (const auto &pair : stash_) {
+      if (comparator_(pair.first, key) == 0 && pair.second == value) {
+        return InsertResult::DUPLICATE;
+      }
+    }
+    if (VisitOverflow(key, hash, false, [&](BlockPage *block, slot_offset_t offset, bool *dirty) {
+          return block->ValueAt(offset) == value;
+        })) {
+      return InsertResult::DUPLICATE;
+    }
+  }
+  InsertResult result = InsertResult::FULL;
+  VisitBuckets(header, hash, true, [&](Bucket *buckets, bool *dirty) {
+    for (int i = 0; i < 2 && check_duplicate; i++) {
+      BlockPage *block = buckets[i].block_;
+      slot_offset_t start = buckets[i].start_;
+      for (uint32_t match = block->MatchTag(start, tag) & block->ReadableMask(start) & BUCKET_MASK; match != 0;
+           match &= match - 1) {
+        slot_offset_t offset = start + __builtin_ctz(match);
+        if (comparator_(block->KeyAt(offset), key) == 0 && block->ValueAt(offset) == value) {
+          result = InsertResult::DUPLICATE;
+          return;
+        }
+      }
+    }
+    for (int i = 0; i < 2; i++) {
+      uint32_t free = ~buckets[i].block_->ReadableMask(buckets[i].start_) & BUCKET_MASK;
+      if (free != 0) {
+        buckets[i].block_->Insert(buckets[i].start_ + __builtin_ctz(free), key, value, tag);
+        *dirty = true;
+        result = InsertResult::INSERTED;
+        return;
+      }
+    }
+    for (int i = 0; i < 2; i++) {
+      BlockPage *block = buckets[i].block_;
+      slot_offset_t start = buckets[i].start_;
+      if ((block->MatchTag(start, tag) & BUCKET_MASK) != BUCKET_MASK) {
+        return;
+      }
+      for (slot_offset_t offset = start; offset < start + BUCKET_SIZE; offset++) {
+        if (comparator_(block->KeyAt(offset), key) != 0) {
+          return;
+        }
+      }
+    }
+    result = InsertResult::FULL_OF_KEY;
+  });
+  return result;
+}
+
+/*
+ * Random walk: put the pair into a random slot of one of its full buckets and
+ * move the pair it evicts to that pair's other bucket, until an evicted pair
+ * finds a free slot. After MAX_KICKS evictions the walk is rolled back, so
+ * that a failed insert leaves the table as it was.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::CuckooInsert(HashTableHeaderPage *header, const KeyType &key, uint64_t hash,
+                                          const ValueType &value) {
+  struct Eviction {
+    size_t bucket_;
+    slot_offset_t offset_;
+    MappingType pair_;
+    uint64_t hash_;
+  };
+  std::vector<Eviction> evictions;
+  size_t num_buckets = header->GetSize();
+  MappingType pair(key, value);
+  size_t bucket = random_() % 2 == 0 ? FirstBucket(hash, num_buckets) : SecondBucket(hash, num_buckets);
+  for (int kick = 0; kick < MAX_KICKS; kick++) {
+    auto *page = FetchBlockPage(header->GetBlockPageId(bucket / BUCKETS_PER_BLOCK), true);
+    auto *block = reinterpret_cast<BlockPage *>(page->GetData());
+    auto offset = static_cast<slot_offset_t>(bucket % BUCKETS_PER_BLOCK * BUCKET_SIZE + random_() % BUCKET_SIZE);
+    MappingType evicted(block->KeyAt(offset), block->ValueAt(offset));
+    block->Remove(offset);
+    block->Insert(offset, pair.first, pair.second, BlockPage::HashTag(hash));
+    ReleaseBlockPage(page, true, true);
+
+    pair = evicted;
+    hash = hash_fn_.GetHash(pair.first);
+    evictions.push_back({bucket, offset, pair, hash});
+    size_t first_bucket = FirstBucket(hash, num_buckets);
+    bucket = first_bucket != bucket ? first_bucket : SecondBucket(hash, num_buckets);
+    page = FetchBlockPage(header->GetBlockPageId(bucket / BUCKETS_PER_BLOCK), true);
+    block = reinterpret_cast<BlockPage *>(page->GetData());
+    auto start = static_cast<slot_offset_t>(bucket % BUCKETS_PER_BLOCK * BUCKET_SIZE);
+    uint32_t free = ~block->ReadableMask(start) & BUCKET_MASK;
+    if (free != 0) {
+      block->Insert(start + __builtin_ctz(free), pair.first, pair.second, BlockPage::HashTag(hash));
+      ReleaseBlockPage(page, true, true);
+      return true;
+    }
+    ReleaseBlockPage(page, true, false);
+  }
+  for (auto it = evictions.rbegin(); it != evictions.rend(); ++it) {
+    auto *page = FetchBlockPage(header->GetBlockPageId(it->bucket_ / BUCKETS_PER_BLOCK), true);
+    auto *block = reinterpret_cast<BlockPage *>(page->GetData());
+    block->Remove(it->offset_);
+    block->Insert(it->offset_, it->pair_.first, it->pair_.second, BlockPage::HashTag(it->hash_));
+    ReleaseBlockPage(page, true, true);
+  }
+  return false;
+}
+
+/*
+ * Evictions, the stash and growing only help a pair whose buckets hold other
+ * keys, which may move elsewhere. Values of a key that fill both of its
+ * buckets go to the overflow chain right away, as does a pair that still finds
+ * no room after one growth.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void CUCKOO_HASH_TABLE_TYPE::InsertExclusive(const KeyType &key, uint64_t hash, const ValueType &value,
+                                             bool may_grow) {
+  auto *header = FetchHeaderPage();
+  InsertResult result = InsertIntoBuckets(header, key, hash, value, false);
+  bool inserted =
+      result == InsertResult::INSERTED || (result == InsertResult::FULL && CuckooInsert(header, key, hash, value));
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (inserted) {
+    return;
+  }
+  if (result == InsertResult::FULL && stash_.size() < STASH_SIZE) {
+    stash_.emplace_back(key, value);
+    return;
+  }
+  if (result == InsertResult::FULL && may_grow && Grow()) {
+    InsertExclusive(key, hash, value, false);
+    return;
+  }
+  InsertIntoOverflow(key, hash, value);
+}
+
+/*
+ * The pairs of all buckets and of the stash are reinserted into a layout
+ * twice as large. A pair that finds no room there goes to the overflow chains,
+ * which do not depend on the layout and are kept as they are.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::Grow() {
+  auto *header = FetchHeaderPage();
+  size_t num_blocks = header->NumBlocks();
+  if (num_blocks == HEADER_ARRAY_SIZE) {
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    return false;
+  }
+  std::vector<MappingType> pairs;
+  for (size_t i = 0; i < num_blocks; i++) {
+    auto *page = FetchBlockPage(header->GetBlockPageId(i), false);
+    auto *block = reinterpret_cast<BlockPage *>(page->GetData());
+    for (slot_offset_t offset = 0; offset < BUCKETS_PER_BLOCK * BUCKET_SIZE; offset++) {
+      if (block->IsReadable(offset)) {
+        pairs.emplace_back(block->KeyAt(offset), block->ValueAt(offset));
+      }
+    }
+    ReleaseBlockPage(page, false, false);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+
+  page_id_t old_header_page_id = header_page_id_;
+  pairs.insert(pairs.end(), stash_.begin(), stash_.end());
+  stash_.clear();
+  header_page_id_ = NewLayout(2 * num_blocks * BUCKETS_PER_BLOCK);
+  for (const auto &pair : pairs) {
+    InsertExclusive(pair.first, hash_fn_.GetHash(pair.first), pair.second, false);
+  }
+  DeleteLayout(old_header_page_id);
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::RemoveFromBuckets(HashTableHeaderPage *header, const KeyType &key, uint64_t hash,
+                                               const ValueType &value) {
+  uint8_t tag = BlockPage::HashTag(hash);
+  bool removed = false;
+  VisitBuckets(header, hash, true, [&](Bucket *buckets, bool *dirty) {
+    for (int i = 0; i < 2; i++) {
+      BlockPage *block = buckets[i].block_;
+      slot_offset_t start = buckets[i].start_;
+      for (uint32_t match = block->MatchTag(start, tag) & block->ReadableMask(start) & BUCKET_MASK; match != 0;
+           match &= match - 1) {
+        slot_offset_t offset = start + __builtin_ctz(match);
+        if (comparator_(block->KeyAt(offset), key) == 0 && block->ValueAt(offset) == value) {
+          block->Remove(offset);
+          *dirty = true;
+          removed = true;
+          return;
+        }
+      }
+    }
+  });
+  return removed;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+bool CUCKOO_HASH_TABLE_TYPE::VisitOverflow(const KeyType &key, uint64_t hash, bool exclusive, Visitor visit) {
+  auto chain = overflow_.find(hash);
+  if (chain == overflow_.end()) {
+    return false;
+  }
+  uint8_t tag = BlockPage::HashTag(hash);
+  for (page_id_t block_page_id : chain->second) {
+    auto *page = FetchBlockPage(block_page_id, exclusive);
+    auto *block = reinterpret_cast<BlockPage *>(page->GetData());
+    bool dirty = false;
+    for (slot_offset_t start = 0; start < BUCKETS_PER_BLOCK * BUCKET_SIZE; start += BUCKET_SIZE) {
+      for (uint32_t match = block->MatchTag(start, tag) & block->ReadableMask(start) & BUCKET_MASK; match != 0;
+           match &= match - 1) {
+        slot_offset_t offset = start + __builtin_ctz(match);
+        if (comparator_(block->KeyAt(offset), key) == 0 && visit(block, offset, &dirty)) {
+          ReleaseBlockPage(page, exclusive, dirty);
+          return true;
+        }
+      }
+    }
+    ReleaseBlockPage(page, exclusive, dirty);
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void CUCKOO_HASH_TABLE_TYPE::InsertIntoOverflow(const KeyType &key, uint64_t hash, const ValueType &value) {
+  uint8_t tag = BlockPage::HashTag(hash);
+  auto &chain = overflow_[hash];
+  for (page_id_t block_page_id : chain) {
+    auto *page = FetchBlockPage(block_page_id, true);
+    auto *block = reinterpret_cast<BlockPage *>(page->GetData());
+    for (slot_offset_t start = 0; start < BUCKETS_PER_BLOCK * BUCKET_SIZE; start += BUCKET_SIZE) {
+      uint32_t free = ~block->ReadableMask(start) & BUCKET_MASK;
+      if (free != 0) {
+        block->Insert(start + __builtin_ctz(free), key, value, tag);
+        ReleaseBlockPage(page, true, true);
+        return;
+      }
+    }
+    ReleaseBlockPage(page, true, false);
+  }
+  page_id_t block_page_id;
+  auto *page = buffer_pool_manager_->NewPage(&block_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while InsertIntoOverflow");
+  }
+  reinterpret_cast<BlockPage *>(page->GetData())->Insert(0, key, value, tag);
+  buffer_pool_manager_->UnpinPage(block_page_id, true);
+  chain.push_back(block_page_id);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::RemoveFromOverflow(const KeyType &key, uint64_t hash, const ValueType &value) {
+  return VisitOverflow(key, hash, true, [&](BlockPage *block, slot_offset_t offset, bool *dirty) {
+    if (!(block->ValueAt(offset) == value)) {
+      return false;
+    }
+    block->Remove(offset);
+    *dirty = true;
+    return true;
+  });
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t CUCKOO_HASH_TABLE_TYPE::GetSize() {
+  table_latch_.RLock();
+  size_t size = FetchHeaderPage()->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t CUCKOO_HASH_TABLE_TYPE::GetStashSize() {
+  table_latch_.RLock();
+  size_t size = stash_.size();
+  table_latch_.RUnlock();
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t CUCKOO_HASH_TABLE_TYPE::GetOverflowSize() {
+  table_latch_.RLock();
+  size_t size = 0;
+  for (const auto &chain : overflow_) {
+    size += chain.second.size();
+  }
+  table_latch_.RUnlock();
+  return size;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
+  uint64_t hash = hash_fn_.GetHash(key);
+  uint8_t tag = BlockPage::HashTag(hash);
+  size_t num_values = result->size();
+  table_latch_.RLock();
+  VisitBuckets(FetchHeaderPage(), hash, false, [&](Bucket *buckets, bool *dirty) {
+    for (int i = 0; i < 2; i++) {
+      BlockPage *block = buckets[i].block_;
+      slot_offset_t start = buckets[i].start_;
+      for (uint32_t match = block->MatchTag(start, tag) & block->ReadableMask(start) & BUCKET_MASK; match != 0;
+           match &= match - 1) {
+        slot_offset_t offset = start + __builtin_ctz(match);
+        if (comparator_(block->KeyAt(offset), key) == 0) {
+          result->push_back(block->ValueAt(offset));
+        }
+      }
+    }
+  });
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  for (const auto &pair : stash_) {
+    if (comparator_(pair.first, key) == 0) {
+      result->push_back(pair.second);
+    }
+  }
+  VisitOverflow(key, hash, false, [&](BlockPage *block, slot_offset_t offset, bool *dirty) {
+    result->push_back(block->ValueAt(offset));
+    return false;
+  });
+  table_latch_.RUnlock();
+  return result->size() > num_values;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  uint64_t hash = hash_fn_.GetHash(key);
+  table_latch_.RLock();
+  InsertResult result = InsertIntoBuckets(FetchHeaderPage(), key, hash, value, true);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  if (result == InsertResult::INSERTED || result == InsertResult::DUPLICATE) {
+    return result == InsertResult::INSERTED;
+  }
+
+  // both buckets are full, evictions and overflow chains need the table to themselves
+  table_latch_.WLock();
+  result = InsertIntoBuckets(FetchHeaderPage(), key, hash, value, true);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (result == InsertResult::FULL || result == InsertResult::FULL_OF_KEY) {
+    InsertExclusive(key, hash, value, true);
+  }
+  table_latch_.WUnlock();
+  return result != InsertResult::DUPLICATE;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool CUCKOO_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  uint64_t hash = hash_fn_.GetHash(key);
+  table_latch_.RLock();
+  bool removed = RemoveFromBuckets(FetchHeaderPage(), key, hash, value);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  // overflow chains only change shape under the exclusive latch, their slots are latched with their pages
+  removed = removed || RemoveFromOverflow(key, hash, value);
+  bool check_stash = !removed && !stash_.empty();
+  table_latch_.RUnlock();
+  if (!check_stash) {
+    return removed;
+  }
+
+  // the stash only changes under the exclusive latch; a growth may have moved the pair to the buckets meanwhile
+  table_latch_.WLock();
+  removed = RemoveFromBuckets(FetchHeaderPage(), key, hash, value);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  removed = removed || RemoveFromOverflow(key, hash, value);
+  for (auto it = stash_.begin(); it != stash_.end() && !removed; ++it) {
+    if (comparator_(it->first, key) == 0 && it->second == value) {
+      stash_.erase(it);
+      removed = true;
+    }
+  }
+  table_latch_.WUnlock();
+  return removed;
+}
+
+template class CuckooHashTable<int, int, IntComparator>;
+
+template class CuckooHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class CuckooHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class CuckooHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class CuckooHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class CuckooHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
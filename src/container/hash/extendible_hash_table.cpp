@@ -0,0 +1,437 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.cpp
+//
+// Identification: src/container/hash/extendible_hash_table.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "container/hash/extendible_hash_table.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+EXTENDIBLE_HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                                const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  auto *page = buffer_pool_manager_->NewPage(&directory_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while ExtendibleHashTable");
+  }
+  auto *directory = reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
+  directory->SetPageId(directory_page_id_);
+  page_id_t bucket_page_id;
+  if (buffer_pool_manager_->NewPage(&bucket_page_id) == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while ExtendibleHashTable");
+  }
+  directory->SetBucketPageId(0, bucket_page_id);
+  directory->SetLocalDepth(0, 0);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HashTableDirectoryPage *EXTENDIBLE_HASH_TABLE_TYPE::FetchDirectoryPage() {
+  auto *page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while FetchDirectoryPage");
+  }
+  return reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *EXTENDIBLE_HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id, bool exclusive) {
+  auto *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while FetchBucketPage");
+  }
+  if (exclusive) {
+    page->WLatch();
+  } else {
+    page->RLatch();
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::vector<page_id_t> EXTENDIBLE_HASH_TABLE_TYPE::BucketPages(page_id_t bucket_page_id) {
+  std::vector<page_id_t> page_ids{bucket_page_id};
+  auto chain = overflow_.find(bucket_page_id);
+  if (chain != overflow_.end()) {
+    page_ids.insert(page_ids.end(), chain->second.begin(), chain->second.end());
+  }
+  return page_ids;
+}
+
+/*
+ * Buckets and their overflow pages are filled from the first slot on and
+ * removes leave tombstones, so a scan of a page stops at the first slot that
+ * was never occupied; the pair goes to the first tombstone or free slot.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+typename EXTENDIBLE_HASH_TABLE_TYPE::InsertResult EXTENDIBLE_HASH_TABLE_TYPE::InsertIntoBucket(
+    page_id_t bucket_page_id, BucketPage *bucket, const KeyType &key, const ValueType &value) {
+  page_id_t free_page_id = INVALID_PAGE_ID;
+  slot_offset_t free_slot = 0;
+  for (page_id_t page_id : BucketPages(bucket_page_id)) {
+    Page *page = page_id == bucket_page_id ? nullptr : FetchBucketPage(page_id, true);
+    auto *block = page == nullptr ? bucket : reinterpret_cast<BucketPage *>(page->GetData());
+    bool duplicate = false;
+    for (slot_offset_t i = 0; i < BLOCK_ARRAY_SIZE; i++) {
+      if (!block->IsOccupied(i) || !block->IsReadable(i)) {
+        if (free_page_id == INVALID_PAGE_ID) {
+          free_page_id = page_id;
+          free_slot = i;
+        }
+        if (!block->IsOccupied(i)) {
+          break;
+        }
+      } else if (comparator_(block->KeyAt(i), key) == 0 && block->ValueAt(i) == value) {
+        duplicate = true;
+        break;
+      }
+    }
+    if (page != nullptr) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+    }
+    if (duplicate) {
+      return InsertResult::DUPLICATE;
+    }
+  }
+  if (free_page_id == INVALID_PAGE_ID) {
+    return InsertResult::FULL;
+  }
+  if (free_page_id == bucket_page_id) {
+    bucket->Insert(free_slot, key, value);
+    return InsertResult::INSERTED;
+  }
+  auto *page = FetchBucketPage(free_page_id, true);
+  reinterpret_cast<BucketPage *>(page->GetData())->Insert(free_slot, key, value);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(free_page_id, true);
+  return InsertResult::INSERTED;
+}
+
+/*
+ * Splits from local_depth on use the hash bits up to DIRECTORY_MAX_DEPTH. If
+ * all pairs agree with key on them, every split leaves the bucket as full as
+ * it was and only doubles the directory.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::CanSplit(page_id_t bucket_page_id, uint32_t local_depth, const KeyType &key) {
+  uint32_t split_bits = (DIRECTORY_ARRAY_SIZE - 1) & ~((1U << local_depth) - 1);
+  uint32_t hash = Hash(key);
+  bool can_split = false;
+  for (page_id_t page_id : BucketPages(bucket_page_id)) {
+    auto *page = buffer_pool_manager_->FetchPage(page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while CanSplit");
+    }
+    auto *block = reinterpret_cast<BucketPage *>(page->GetData());
+    for (slot_offset_t i = 0; i < BLOCK_ARRAY_SIZE && block->IsOccupied(i) && !can_split; i++) {
+      can_split = block->IsReadable(i) && ((Hash(block->KeyAt(i)) ^ hash) & split_bits) != 0;
+    }
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    if (can_split) {
+      break;
+    }
+  }
+  return can_split;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *EXTENDIBLE_HASH_TABLE_TYPE::NewOverflowPage(page_id_t bucket_page_id) {
+  page_id_t overflow_page_id;
+  auto *page = buffer_pool_manager_->NewPage(&overflow_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while NewOverflowPage");
+  }
+  overflow_[bucket_page_id].push_back(overflow_page_id);
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::FillBucket(page_id_t bucket_page_id, BucketPage *bucket,
+                                            const std::vector<MappingType> &pairs) {
+  BucketPage *block = bucket;
+  Page *page = nullptr;
+  slot_offset_t slot = 0;
+  for (const auto &pair : pairs) {
+    if (slot == BLOCK_ARRAY_SIZE) {
+      if (page != nullptr) {
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+      }
+      page = NewOverflowPage(bucket_page_id);
+      block = reinterpret_cast<BucketPage *>(page->GetData());
+      slot = 0;
+    }
+    block->Insert(slot++, pair.first, pair.second);
+  }
+  if (page != nullptr) {
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::GetGlobalDepth() {
+  table_latch_.RLock();
+  uint32_t global_depth = FetchDirectoryPage()->GetGlobalDepth();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return global_depth;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                          std::vector<ValueType> *result) {
+  table_latch_.RLock();
+  auto *directory = FetchDirectoryPage();
+  page_id_t bucket_page_id = directory->GetBucketPageId(Hash(key) & directory->GetGlobalDepthMask());
+  bool found = false;
+  for (page_id_t page_id : BucketPages(bucket_page_id)) {
+    auto *page = FetchBucketPage(page_id, false);
+    auto *bucket = reinterpret_cast<BucketPage *>(page->GetData());
+    for (slot_offset_t i = 0; i < BLOCK_ARRAY_SIZE && bucket->IsOccupied(i); i++) {
+      if (bucket->IsReadable(i) && comparator_(bucket->KeyAt(i), key) == 0) {
+        result->push_back(bucket->ValueAt(i));
+        found = true;
+      }
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  auto *directory = FetchDirectoryPage();
+  page_id_t bucket_page_id = directory->GetBucketPageId(Hash(key) & directory->GetGlobalDepthMask());
+  auto *page = FetchBucketPage(bucket_page_id, true);
+  InsertResult result =
+      InsertIntoBucket(bucket_page_id, reinterpret_cast<BucketPage *>(page->GetData()), key, value);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, result == InsertResult::INSERTED);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (result == InsertResult::FULL) {
+    return SplitInsert(key, value);
+  }
+  return result == InsertResult::INSERTED;
+}
+
+/*
+ * Split the full bucket of key by its next hash bit, moving the pairs with
+ * that bit set to a new bucket, and retry; the directory doubles first if
+ * the bucket is as deep as the directory. A bucket that no split can divide
+ * gets an overflow page for the pair instead. Another thread may have split
+ * the bucket already, then the insert just succeeds.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::SplitInsert(const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  auto *directory = FetchDirectoryPage();
+  bool directory_dirty = false;
+  InsertResult result;
+  while (true) {
+    uint32_t bucket_idx = Hash(key) & directory->GetGlobalDepthMask();
+    page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+    auto *page = FetchBucketPage(bucket_page_id, true);
+    auto *bucket = reinterpret_cast<BucketPage *>(page->GetData());
+    result = InsertIntoBucket(bucket_page_id, bucket, key, value);
+    uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+    if (result == InsertResult::FULL && !CanSplit(bucket_page_id, local_depth, key)) {
+      auto *overflow_page = NewOverflowPage(bucket_page_id);
+      reinterpret_cast<BucketPage *>(overflow_page->GetData())->Insert(0, key, value);
+      buffer_pool_manager_->UnpinPage(overflow_page->GetPageId(), true);
+      result = InsertResult::INSERTED;
+    }
+    if (result != InsertResult::FULL) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(bucket_page_id, result == InsertResult::INSERTED);
+      break;
+    }
+    if (local_depth == directory->GetGlobalDepth()) {
+      directory->IncrGlobalDepth();
+    }
+
+    page_id_t image_page_id;
+    auto *image_page = buffer_pool_manager_->NewPage(&image_page_id);
+    if (image_page == nullptr) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+      table_latch_.WUnlock();
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while SplitInsert");
+    }
+    uint32_t split_bit = 1U << local_depth;
+    for (uint32_t i = 0; i < directory->Size(); i++) {
+      if (directory->GetBucketPageId(i) == bucket_page_id) {
+        directory->SetLocalDepth(i, local_depth + 1);
+        if ((i & split_bit) != 0) {
+          directory->SetBucketPageId(i, image_page_id);
+        }
+      }
+    }
+    // empty the bucket and its overflow pages, then refill both halves from their first slots on
+    std::vector<MappingType> pairs[2];
+    for (page_id_t page_id : BucketPages(bucket_page_id)) {
+      Page *overflow_page = page_id == bucket_page_id ? nullptr : FetchBucketPage(page_id, true);
+      auto *block = overflow_page == nullptr ? bucket : reinterpret_cast<BucketPage *>(overflow_page->GetData());
+      for (slot_offset_t i = 0; i < BLOCK_ARRAY_SIZE && block->IsOccupied(i); i++) {
+        if (block->IsReadable(i)) {
+          pairs[(Hash(block->KeyAt(i)) & split_bit) != 0 ? 1 : 0].emplace_back(block->KeyAt(i), block->ValueAt(i));
+          block->Remove(i);
+        }
+      }
+      if (overflow_page != nullptr) {
+        overflow_page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(page_id, false);
+        buffer_pool_manager_->DeletePage(page_id);
+      }
+    }
+    overflow_.erase(bucket_page_id);
+    FillBucket(bucket_page_id, bucket, pairs[0]);
+    FillBucket(image_page_id, reinterpret_cast<BucketPage *>(image_page->GetData()), pairs[1]);
+    directory_dirty = true;
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+    buffer_pool_manager_->UnpinPage(image_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, directory_dirty);
+  table_latch_.WUnlock();
+  return result == InsertResult::INSERTED;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  auto *directory = FetchDirectoryPage();
+  page_id_t bucket_page_id = directory->GetBucketPageId(Hash(key) & directory->GetGlobalDepthMask());
+  auto *bucket_page = FetchBucketPage(bucket_page_id, true);
+  bool removed = false;
+  bool empty = true;
+  for (page_id_t page_id : BucketPages(bucket_page_id)) {
+    auto *page = page_id == bucket_page_id ? bucket_page : FetchBucketPage(page_id, true);
+    auto *bucket = reinterpret_cast<BucketPage *>(page->GetData());
+    bool dirty = false;
+    for (slot_offset_t i = 0; i < BLOCK_ARRAY_SIZE && bucket->IsOccupied(i) && (!removed || empty); i++) {
+      if (!bucket->IsReadable(i)) {
+        continue;
+      }
+      if (!removed && comparator_(bucket->KeyAt(i), key) == 0 && bucket->ValueAt(i) == value) {
+        bucket->Remove(i);
+        removed = true;
+        dirty = true;
+      } else {
+        empty = false;
+      }
+    }
+    if (page_id != bucket_page_id) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, dirty);
+    }
+    if (removed && !empty) {
+      break;
+    }
+  }
+  bucket_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, removed);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (removed && empty) {
+    Merge(key);
+  }
+  return removed;
+}
+
+/*
+ * Fold the bucket of key into its split image while the bucket and its
+ * overflow pages are empty and the image has the same local depth, then halve
+ * the directory as far as it can shrink. The emptied pages are deleted.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::Merge(const KeyType &key) {
+  table_latch_.WLock();
+  auto *directory = FetchDirectoryPage();
+  bool directory_dirty = false;
+  while (true) {
+    uint32_t bucket_idx = Hash(key) & directory->GetGlobalDepthMask();
+    uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+    if (local_depth == 0) {
+      break;
+    }
+    uint32_t image_idx = directory->GetSplitImageIndex(bucket_idx);
+    if (directory->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+    page_id_t image_page_id = directory->GetBucketPageId(image_idx);
+    std::vector<page_id_t> page_ids = BucketPages(bucket_page_id);
+    bool empty = true;
+    for (page_id_t page_id : page_ids) {
+      auto *page = FetchBucketPage(page_id, false);
+      auto *bucket = reinterpret_cast<BucketPage *>(page->GetData());
+      for (slot_offset_t i = 0; i < BLOCK_ARRAY_SIZE && bucket->IsOccupied(i) && empty; i++) {
+        empty = !bucket->IsReadable(i);
+      }
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+    }
+    if (!empty) {
+      break;
+    }
+    for (uint32_t i = 0; i < directory->Size(); i++) {
+      if (directory->GetBucketPageId(i) == bucket_page_id || directory->GetBucketPageId(i) == image_page_id) {
+        directory->SetBucketPageId(i, image_page_id);
+        directory->SetLocalDepth(i, local_depth - 1);
+      }
+    }
+    for (page_id_t page_id : page_ids) {
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    overflow_.erase(bucket_page_id);
+    while (directory->CanShrink()) {
+      directory->DecrGlobalDepth();
+    }
+    directory_dirty = true;
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, directory_dirty);
+  table_latch_.WUnlock();
+}
+
+template class ExtendibleHashTable<int, int, IntComparator>;
+
+template class ExtendibleHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class ExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
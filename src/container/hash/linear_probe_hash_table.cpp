@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
@@ -26,21 +28,406 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  header_page_id_ = NewLayout(num_buckets);
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HashTableHeaderPage *HASH_TABLE_TYPE::FetchHeaderPage(page_id_t header_page_id) {
+  auto *page = buffer_pool_manager_->FetchPage(header_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while FetchHeaderPage");
+  }
+  return reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+}
+
+/*
+ * A layout always consists of whole block pages, so slot i lives in block
+ * i / BLOCK_ARRAY_SIZE; the header page caps it at HEADER_ARRAY_SIZE blocks.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t HASH_TABLE_TYPE::NewLayout(size_t num_buckets) {
+  size_t num_blocks = (num_buckets + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE;
+  num_blocks = std::max<size_t>(1, std::min<size_t>(num_blocks, HEADER_ARRAY_SIZE));
+  page_id_t header_page_id;
+  auto *page = buffer_pool_manager_->NewPage(&header_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while NewLayout");
+  }
+  auto *header = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  header->SetPageId(header_page_id);
+  header->SetSize(num_blocks * BLOCK_ARRAY_SIZE);
+  for (size_t i = 0; i < num_blocks; i++) {
+    page_id_t block_page_id;
+    if (buffer_pool_manager_->NewPage(&block_page_id) == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while NewLayout");
+    }
+    header->AddBlockPageId(block_page_id);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, true);
+  return header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *HASH_TABLE_TYPE::FetchBlockPage(page_id_t block_page_id, bool exclusive) {
+  auto *page = buffer_pool_manager_->FetchPage(block_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while FetchBlockPage");
+  }
+  if (exclusive) {
+    page->WLatch();
+  } else {
+    page->RLatch();
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::ReleaseBlockPage(Page *page, bool exclusive, bool dirty) {
+  if (exclusive) {
+    page->WUnlatch();
+  } else {
+    page->RUnlatch();
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), dirty);
+}
+
+/*
+ * While a resize is in progress every operation pays for a batch of the
+ * migration, unless another operation is migrating right now: batches run
+ * one at a time under the shared latch, and the operations in between go
+ * ahead without one. Only the operation that drains the old layout takes
+ * the table latch in write mode, to drop it.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::LatchForOperation() {
+  table_latch_.RLock();
+  if (old_header_page_id_ == INVALID_PAGE_ID || !migrate_latch_.try_lock()) {
+    return;
+  }
+  bool drained = MigrateSlots(MIGRATE_BATCH_SIZE);
+  migrate_latch_.unlock();
+  if (drained) {
+    table_latch_.RUnlock();
+    table_latch_.WLock();
+    FinishResize();
+    table_latch_.WUnlock();
+    table_latch_.RLock();
+  }
+}
+
+/*
+ * Only one block page is latched at a time, so a walk never waits while
+ * holding a latch; only a migration step latches a page of the current
+ * layout while it holds one of the old layout. Slots never go back from occupied to free, which keeps a
+ * walk that lost its latch between two blocks valid.
+ *
+ * The walk goes over TAG_GROUP_SIZE slots at a time: the tag, occupied and
+ * readable masks of a group pick the slots worth visiting, so keys are only
+ * compared where the tag matches.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+bool HASH_TABLE_TYPE::Probe(HashTableHeaderPage *header, uint64_t hash, bool exclusive, bool tombstones,
+                            Visitor visit) {
+  uint8_t tag = BlockPage::HashTag(hash);
+  size_t size = header->GetSize();
+  size_t slot = hash % size;
+  size_t visited = 0;
+  while (visited < size) {
+    auto *page = FetchBlockPage(header->GetBlockPageId(slot / BLOCK_ARRAY_SIZE), exclusive);
+    bool dirty = false;
+    bool stopped = ProbeBlock(reinterpret_cast<BlockPage *>(page->GetData()), tag, size, &slot, &visited, tombstones,
+                              &dirty, visit);
+    ReleaseBlockPage(page, exclusive, dirty);
+    if (stopped) {
+      return true;
+    }
+    slot %= size;
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+bool HASH_TABLE_TYPE::ProbeBlock(BlockPage *block, uint8_t tag, size_t size, size_t *slot, size_t *visited,
+                                 bool tombstones, bool *dirty, Visitor visit) {
+  auto offset = static_cast<slot_offset_t>(*slot % BLOCK_ARRAY_SIZE);
+  while (offset < BLOCK_ARRAY_SIZE && *visited < size) {
+    size_t group = std::min<size_t>({BlockPage::TAG_GROUP_SIZE, BLOCK_ARRAY_SIZE - offset, size - *visited});
+    uint32_t valid = group == 32 ? ~0U : (1U << group) - 1;
+    uint32_t occupied = block->OccupiedMask(offset) & valid;
+    uint32_t readable = block->ReadableMask(offset) & valid;
+    uint32_t candidates = block->MatchTag(offset, tag) & readable;
+    if (tombstones) {
+      candidates |= occupied & ~readable;
+    }
+    uint32_t free = valid & ~occupied;
+    if (free != 0) {
+      // nothing after the first free slot belongs to the probe sequence
+      uint32_t first_free = free & (~free + 1);
+      candidates = (candidates & (first_free - 1)) | first_free;
+    }
+    for (; candidates != 0; candidates &= candidates - 1) {
+      auto i = static_cast<size_t>(__builtin_ctz(candidates));
+      if (visit(block, offset + i, *slot + i, dirty)) {
+        return true;
+      }
+    }
+    offset += group;
+    *slot += group;
+    *visited += group;
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::CollectSlot(BlockPage *block, slot_offset_t offset, const KeyType &key,
+                                  std::vector<ValueType> *result) {
+  if (!block->IsOccupied(offset)) {
+    return true;
+  }
+  if (block->IsReadable(offset) && comparator_(block->KeyAt(offset), key) == 0) {
+    result->push_back(block->ValueAt(offset));
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::CollectValues(HashTableHeaderPage *header, const KeyType &key, uint64_t hash,
+                                    std::vector<ValueType> *result) {
+  Probe(header, hash, false, false, [&](BlockPage *block, slot_offset_t offset, size_t slot, bool *dirty) {
+    return CollectSlot(block, offset, key, result);
+  });
+}
+
+/*
+ * Every round sorts the pending probes by slot and walks the block pages in
+ * order, so that a page is fetched and latched once for all the keys whose
+ * probe is at it. The home slots of those keys are prefetched before the
+ * first one is compared. A probe that runs off the end of its page waits for
+ * the next round, which is rare below the resize threshold.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::CollectBatch(HashTableHeaderPage *header, const std::vector<KeyType> &keys,
+                                   const std::vector<uint64_t> &hashes, std::vector<std::vector<ValueType>> *results) {
+  struct Cursor {
+    size_t key_;
+    size_t slot_;
+    size_t visited_;
+  };
+  size_t size = header->GetSize();
+  std::vector<Cursor> cursors;
+  cursors.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    cursors.push_back({i, hashes[i] % size, 0});
+  }
+  std::vector<Cursor> unfinished;
+  while (!cursors.empty()) {
+    std::sort(cursors.begin(), cursors.end(), [](const Cursor &a, const Cursor &b) { return a.slot_ < b.slot_; });
+    size_t end;
+    for (size_t begin = 0; begin < cursors.size(); begin = end) {
+      size_t block_index = cursors[begin].slot_ / BLOCK_ARRAY_SIZE;
+      for (end = begin + 1; end < cursors.size() && cursors[end].slot_ / BLOCK_ARRAY_SIZE == block_index; end++) {
+      }
+      auto *page = FetchBlockPage(header->GetBlockPageId(block_index), false);
+      auto *block = reinterpret_cast<BlockPage *>(page->GetData());
+      for (size_t i = begin; i < end; i++) {
+        block->Prefetch(cursors[i].slot_ % BLOCK_ARRAY_SIZE);
+      }
+      for (size_t i = begin; i < end; i++) {
+        Cursor cursor = cursors[i];
+        const KeyType &key = keys[cursor.key_];
+        std::vector<ValueType> *result = &(*results)[cursor.key_];
+        bool dirty = false;
+        bool stopped = ProbeBlock(block, BlockPage::HashTag(hashes[cursor.key_]), size, &cursor.slot_,
+                                  &cursor.visited_, false, &dirty,
+                                  [&](BlockPage *, slot_offset_t offset, size_t, bool *) {
+                                    return CollectSlot(block, offset, key, result);
+                                  });
+        if (!stopped && cursor.visited_ < size) {
+          cursor.slot_ %= size;
+          unfinished.push_back(cursor);
+        }
+      }
+      ReleaseBlockPage(page, false, false);
+    }
+    cursors.swap(unfinished);
+    unfinished.clear();
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::ContainsPair(HashTableHeaderPage *header, const KeyType &key, uint64_t hash,
+                                   const ValueType &value) {
+  bool found = false;
+  Probe(header, hash, false, false, [&](BlockPage *block, slot_offset_t offset, size_t slot, bool *dirty) {
+    if (!block->IsOccupied(offset)) {
+      return true;
+    }
+    found = block->IsReadable(offset) && comparator_(block->KeyAt(offset), key) == 0 && block->ValueAt(offset) == value;
+    return found;
+  });
+  return found;
+}
+
+/*
+ * The pair goes to the first tombstone or free slot of its probe sequence,
+ * but a duplicate may sit anywhere before the first free slot, so with
+ * check_duplicate the walk goes on and a tombstone is filled afterwards. A
+ * free slot is written under the latch that found it free; a tombstone taken
+ * by another insert in the meantime means walking again.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+typename HASH_TABLE_TYPE::InsertResult HASH_TABLE_TYPE::InsertInto(HashTableHeaderPage *header, const KeyType &key,
+                                                                   uint64_t hash, const ValueType &value,
+                                                                   bool check_duplicate) {
+  uint8_t tag = BlockPage::HashTag(hash);
+  size_t size = header->GetSize();
+  size_t tombstone = size;
+  InsertResult result = InsertResult::FULL;
+  Probe(header, hash, true, true, [&](BlockPage *block, slot_offset_t offset, size_t slot, bool *dirty) {
+    if (!block->IsOccupied(offset)) {
+      if (tombstone == size) {
+        block->Insert(offset, key, value, tag);
+        *dirty = true;
+        num_occupied_++;
+        result = InsertResult::INSERTED;
+      }
+      return true;
+    }
+    if (!block->IsReadable(offset)) {
+      tombstone = std::min(tombstone, slot);
+      return !check_duplicate;
+    }
+    if (check_duplicate && comparator_(block->KeyAt(offset), key) == 0 && block->ValueAt(offset) == value) {
+      result = InsertResult::DUPLICATE;
+      return true;
+    }
+    return false;
+  });
+  if (result != InsertResult::FULL || tombstone == size) {
+    return result;
+  }
+  auto *page = FetchBlockPage(header->GetBlockPageId(tombstone / BLOCK_ARRAY_SIZE), true);
+  bool inserted =
+      reinterpret_cast<BlockPage *>(page->GetData())->Insert(tombstone % BLOCK_ARRAY_SIZE, key, value, tag);
+  ReleaseBlockPage(page, true, inserted);
+  return inserted ? InsertResult::INSERTED : InsertInto(header, key, hash, value, check_duplicate);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::RemoveFrom(HashTableHeaderPage *header, const KeyType &key, uint64_t hash,
+                                 const ValueType &value) {
+  bool removed = false;
+  Probe(header, hash, true, false, [&](BlockPage *block, slot_offset_t offset, size_t slot, bool *dirty) {
+    if (!block->IsOccupied(offset)) {
+      return true;
+    }
+    if (block->IsReadable(offset) && comparator_(block->KeyAt(offset), key) == 0 && block->ValueAt(offset) == value) {
+      block->Remove(offset);
+      *dirty = true;
+      removed = true;
+    }
+    return removed;
+  });
+  return removed;
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
-  return false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  LatchForOperation();
+  size_t num_values = result->size();
+  bool resizing = old_header_page_id_ != INVALID_PAGE_ID;
+  if (resizing) {
+    CollectValues(FetchHeaderPage(old_header_page_id_), key, hash, result);
+    buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+  }
+  size_t mid = result->size();
+  CollectValues(FetchHeaderPage(header_page_id_), key, hash, result);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (resizing) {
+    DropMigrated(result, num_values, mid);
+  }
+  table_latch_.RUnlock();
+  return result->size() > num_values;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::GetValues(Transaction *transaction, const std::vector<KeyType> &keys,
+                                std::vector<std::vector<ValueType>> *results) {
+  std::vector<uint64_t> hashes;
+  hashes.reserve(keys.size());
+  for (const auto &key : keys) {
+    hashes.push_back(hash_fn_.GetHash(key));
+  }
+  results->resize(std::max(results->size(), keys.size()));
+  std::vector<size_t> num_values(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    num_values[i] = (*results)[i].size();
+  }
+  LatchForOperation();
+  bool resizing = old_header_page_id_ != INVALID_PAGE_ID;
+  std::vector<size_t> mids = num_values;
+  if (resizing) {
+    CollectBatch(FetchHeaderPage(old_header_page_id_), keys, hashes, results);
+    buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+    for (size_t i = 0; i < keys.size(); i++) {
+      mids[i] = (*results)[i].size();
+    }
+  }
+  CollectBatch(FetchHeaderPage(header_page_id_), keys, hashes, results);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (resizing) {
+    for (size_t i = 0; i < keys.size(); i++) {
+      DropMigrated(&(*results)[i], num_values[i], mids[i]);
+    }
+  }
+  table_latch_.RUnlock();
 }
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  std::mutex &insert_latch = insert_latches_[hash % NUM_INSERT_LATCHES];
+  while (true) {
+    LatchForOperation();
+    insert_latch.lock();
+    bool duplicate = false;
+    if (old_header_page_id_ != INVALID_PAGE_ID) {
+      duplicate = ContainsPair(FetchHeaderPage(old_header_page_id_), key, hash, value);
+      buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+    }
+    page_id_t header_page_id = header_page_id_;
+    auto *header = FetchHeaderPage(header_page_id);
+    InsertResult result = duplicate ? InsertResult::DUPLICATE : InsertInto(header, key, hash, value, true);
+    size_t size = header->GetSize();
+    buffer_pool_manager_->UnpinPage(header_page_id, false);
+    insert_latch.unlock();
+    table_latch_.RUnlock();
+
+    // grow at three quarters load, or right away if the probe found no free slot
+    if (result != InsertResult::FULL && num_occupied_ * 4 <= size * 3) {
+      return result == InsertResult::INSERTED;
+    }
+    table_latch_.WLock();
+    // another insert may have started the resize already
+    bool grown = header_page_id_ != header_page_id || StartResize(size);
+    table_latch_.WUnlock();
+    if (result != InsertResult::FULL || !grown) {
+      return result == InsertResult::INSERTED;
+    }
+  }
 }
 
 /*****************************************************************************
@@ -48,21 +435,157 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  LatchForOperation();
+  bool removed = false;
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    removed = RemoveFrom(FetchHeaderPage(old_header_page_id_), key, hash, value);
+    buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+  }
+  if (!removed) {
+    removed = RemoveFrom(FetchHeaderPage(header_page_id_), key, hash, value);
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  }
+  table_latch_.RUnlock();
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  StartResize(initial_size);
+  table_latch_.WUnlock();
+}
+
+/*
+ * A resize still in progress is drained in one go first. It cannot have
+ * filled the current layout to three quarters unless the header page capped
+ * its growth, and then the old layout simply stays until there is room.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::StartResize(size_t initial_size) {
+  MigrateSlots(std::numeric_limits<size_t>::max());
+  FinishResize();
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    return false;
+  }
+  size_t size = FetchHeaderPage(header_page_id_)->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  size_t num_buckets = std::min<size_t>(2 * initial_size, HEADER_ARRAY_SIZE * BLOCK_ARRAY_SIZE);
+  if (num_buckets <= size) {
+    return false;
+  }
+  old_header_page_id_ = header_page_id_;
+  header_page_id_ = NewLayout(num_buckets);
+  migrate_slot_ = 0;
+  num_occupied_ = 0;
+  return true;
+}
+
+/*
+ * Migrated slots become tombstones in the old layout, so the probe sequences
+ * of pairs not yet migrated stay intact. A pair is written to the current
+ * layout before its old slot is cleared, both under the write latch of the
+ * old block page, so a concurrent walk of the old layout and then the
+ * current one sees it at least once, and a remove in the old layout cannot
+ * slip in between.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::MigrateSlots(size_t num_slots) {
+  if (old_header_page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  auto *old_header = FetchHeaderPage(old_header_page_id_);
+  auto *header = FetchHeaderPage(header_page_id_);
+  size_t old_size = old_header->GetSize();
+  size_t end = old_size - migrate_slot_ > num_slots ? migrate_slot_ + num_slots : old_size;
+  bool full = false;
+  while (migrate_slot_ < end && !full) {
+    auto *page = FetchBlockPage(old_header->GetBlockPageId(migrate_slot_ / BLOCK_ARRAY_SIZE), true);
+    auto *block = reinterpret_cast<BlockPage *>(page->GetData());
+    bool dirty = false;
+    do {
+      auto offset = static_cast<slot_offset_t>(migrate_slot_ % BLOCK_ARRAY_SIZE);
+      if (block->IsReadable(offset)) {
+        // pairs are unique across both layouts, only a capped layout can run full
+        KeyType key = block->KeyAt(offset);
+        full = InsertInto(header, key, hash_fn_.GetHash(key), block->ValueAt(offset), false) == InsertResult::FULL;
+        if (full) {
+          break;
+        }
+        block->Remove(offset);
+        dirty = true;
+      }
+      migrate_slot_++;
+    } while (migrate_slot_ < end && migrate_slot_ % BLOCK_ARRAY_SIZE != 0);
+    ReleaseBlockPage(page, true, dirty);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+  return migrate_slot_ >= old_size;
+}
+
+/*
+ * Operations under the shared latch may still walk the old layout, so its
+ * pages only go once the write latch is held. Another operation may have
+ * dropped it in the meantime.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::FinishResize() {
+  if (old_header_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  auto *old_header = FetchHeaderPage(old_header_page_id_);
+  if (migrate_slot_ < old_header->GetSize()) {
+    buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+    return;
+  }
+  for (size_t i = 0; i < old_header->NumBlocks(); i++) {
+    buffer_pool_manager_->DeletePage(old_header->GetBlockPageId(i));
+  }
+  buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+  buffer_pool_manager_->DeletePage(old_header_page_id_);
+  old_header_page_id_ = INVALID_PAGE_ID;
+}
+
+/*
+ * Pairs are unique across both layouts, so a value found in both was
+ * migrated between the two walks.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::DropMigrated(std::vector<ValueType> *result, size_t begin, size_t mid) {
+  if (begin == mid) {
+    return;
+  }
+  auto first = result->begin();
+  result->erase(std::remove_if(first + mid, result->end(),
+                               [&](const ValueType &value) {
+                                 return std::find(first + begin, first + mid, value) != first + mid;
+                               }),
+                result->end());
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 size_t HASH_TABLE_TYPE::GetSize() {
-  return 0;
+  table_latch_.RLock();
+  size_t size = FetchHeaderPage(header_page_id_)->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::IsResizing() {
+  table_latch_.RLock();
+  bool resizing = old_header_page_id_ != INVALID_PAGE_ID;
+  table_latch_.RUnlock();
+  return resizing;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
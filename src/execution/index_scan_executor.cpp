@@ -11,12 +11,655 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "common/exception.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "storage/index/art_index.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "storage/index/skip_list_index.h"
+#include "storage/index/var_key_b_plus_tree_index.h"
+#include "type/value_factory.h"
+
 namespace bustub {
+
+namespace {
+// append the table columns read by expr
+void CollectColumns(const AbstractExpression *expr, std::vector<uint32_t> *columns) {
+  if (expr == nullptr) {
+    return;
+  }
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr)) {
+    columns->push_back(column->GetColIdx());
+  }
+  for (const auto *child : expr->GetChildren()) {
+    CollectColumns(child, columns);
+  }
+}
+
+// match expr against (column op constant) or (constant op column); op is returned as if the column were on the left
+bool MatchColumnComparison(const AbstractExpression *expr, uint32_t *column, ComparisonType *type, Value *constant) {
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(expr);
+  if (comparison == nullptr) {
+    return false;
+  }
+  const auto *lhs = comparison->GetChildAt(0);
+  const auto *rhs = comparison->GetChildAt(1);
+  *type = comparison->GetComparisonType();
+  if (dynamic_cast<const ColumnValueExpression *>(lhs) == nullptr) {
+    std::swap(lhs, rhs);
+    switch (*type) {
+      case ComparisonType::LessThan:
+        *type = ComparisonType::GreaterThan;
+        break;
+      case ComparisonType::LessThanOrEqual:
+        *type = ComparisonType::GreaterThanOrEqual;
+        break;
+      case ComparisonType::GreaterThan:
+        *type = ComparisonType::LessThan;
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        *type = ComparisonType::LessThanOrEqual;
+        break;
+      default:
+        break;
+    }
+  }
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(lhs);
+  if (column_expr == nullptr || dynamic_cast<const ConstantValueExpression *>(rhs) == nullptr) {
+    return false;
+  }
+  *column = column_expr->GetColIdx();
+  *constant = rhs->Evaluate(nullptr, nullptr);
+  return true;
+}
+
+/*
+ * The part of a cursor shared by the indexes keyed by GenericKey<KeySize>:
+ * deriving the key range from the predicate, the key filter, and rebuilding
+ * table tuples from keys. Subclasses read the (key, RID) pairs of the range.
+ */
+template <size_t KeySize>
+class GenericKeyCursor : public IndexScanExecutor::Cursor {
+ public:
+  using KeyType = GenericKey<KeySize>;
+
+  GenericKeyCursor(Index *index, TableMetadata *table_info, const AbstractExpression *predicate,
+                   const std::vector<uint32_t> &columns, Transaction *txn)
+      : index_(index), table_info_(table_info), predicate_(predicate), txn_(txn) {
+    covering_ = index_->Covers(columns);
+    std::vector<uint32_t> predicate_columns;
+    CollectColumns(predicate_, &predicate_columns);
+    const auto &key_attrs = index_->GetKeyAttrs();
+    bool key_only = std::all_of(predicate_columns.begin(), predicate_columns.end(), [&key_attrs](uint32_t column) {
+      return std::find(key_attrs.begin(), key_attrs.end(), column) != key_attrs.end();
+    });
+    if (predicate_ != nullptr && key_only) {
+      // evaluated while the keys are read, the table tuples of failing keys are never fetched
+      filter_ = [this](const KeyType &key) {
+        Tuple tuple = TupleFromKey(key, false);
+        return predicate_->Evaluate(&tuple, &table_info_->schema_).GetAs<bool>();
+      };
+    }
+    SetBounds();
+  }
+
+  bool Next(Tuple *tuple, RID *rid) override {
+    while (batch_index_ < batch_.size() || Refill()) {
+      const auto &entry = batch_[batch_index_++];
+      if (covering_ && HoldsIncludedColumns(entry.first, entry.second)) {
+        *tuple = TupleFromKey(entry.first, true);
+      } else if (!table_info_->table_->GetTuple(entry.second, tuple, txn_)) {
+        continue;
+      }
+      if (!filter_ && predicate_ != nullptr && !predicate_->Evaluate(tuple, &table_info_->schema_).GetAs<bool>()) {
+        continue;
+      }
+      *rid = entry.second;
+      return true;
+    }
+    return false;
+  }
+
+ protected:
+  /**
+   * Replace batch with the next pairs of the range that pass filter_, after the last pair of batch (from the start
+   * of the range if it is empty).
+   * @return false if the range has no more pairs
+   */
+  virtual bool NextBatch(std::vector<std::pair<KeyType, RID>> *batch) = 0;
+
+  /** Number of index entries fetched per batch. */
+  static constexpr size_t SCAN_BATCH_SIZE = 128;
+
+  Index *index_;
+  /** Bounds of the scanned key range, nullptr when open. */
+  const KeyType *lo_{nullptr};
+  const KeyType *hi_{nullptr};
+  bool lo_inclusive_{true};
+  bool hi_inclusive_{true};
+  /** Predicate evaluated on the keys, empty if the predicate reads columns the index does not store. */
+  std::function<bool(const KeyType &)> filter_;
+
+ private:
+  bool Refill() {
+    batch_index_ = 0;
+    if (done_) {
+      batch_.clear();
+      return false;
+    }
+    done_ = !NextBatch(&batch_);
+    return !batch_.empty();
+  }
+
+  // a comparison of the leading key column with a constant bounds the range; the keys must be normalized, where the
+  // bytes after the leading column decide the order among keys with the same leading value
+  void SetBounds() {
+    uint32_t column;
+    ComparisonType type;
+    Value constant;
+    const Schema *key_schema = index_->GetKeySchema();
+    if (!KeyType::IsNormalizable(key_schema) || !MatchColumnComparison(predicate_, &column, &type, &constant) ||
+        column != index_->GetKeyAttrs()[0] || constant.IsNull() ||
+        constant.GetTypeId() != key_schema->GetColumn(0).GetType()) {
+      return;
+    }
+    // keys before (0x00) and after (0xff) every key starting with constant
+    KeyType first = BoundKey(constant, 0);
+    KeyType last = BoundKey(constant, static_cast<char>(0xff));
+    switch (type) {
+      case ComparisonType::Equal:
+        SetLo(first, true);
+        SetHi(last, true);
+        break;
+      case ComparisonType::LessThan:
+        SetHi(first, false);
+        break;
+      case ComparisonType::LessThanOrEqual:
+        SetHi(last, true);
+        break;
+      case ComparisonType::GreaterThan:
+        SetLo(last, false);
+        break;
+      case ComparisonType::GreaterThanOrEqual:
+        SetLo(first, true);
+        break;
+      default:
+        break;
+    }
+  }
+
+  KeyType BoundKey(const Value &leading, char fill) const {
+    const Schema *key_schema = index_->GetKeySchema();
+    std::vector<Value> values;
+    values.reserve(key_schema->GetColumnCount());
+    for (const auto &column : key_schema->GetColumns()) {
+      values.push_back(ValueFactory::GetNullValueByType(column.GetType()));
+    }
+    values[0] = leading;
+    KeyType key;
+    key.SetFromKey(Tuple(values, key_schema), key_schema);
+    uint32_t leading_length = key_schema->GetColumn(0).GetFixedLength();
+    memset(key.data_ + leading_length, fill, key_schema->GetLength() - leading_length);
+    return key;
+  }
+
+  void SetLo(const KeyType &key, bool inclusive) {
+    lo_key_ = key;
+    lo_ = &lo_key_;
+    lo_inclusive_ = inclusive;
+  }
+
+  void SetHi(const KeyType &key, bool inclusive) {
+    hi_key_ = key;
+    hi_ = &hi_key_;
+    hi_inclusive_ = inclusive;
+  }
+
+  // a key shared by several tuples only holds the included columns of one of them
+  bool HoldsIncludedColumns(const KeyType &key, RID rid) const {
+    const IndexMetadata *metadata = index_->GetMetadata();
+    return metadata->GetIncludeColumnCount() == 0 || key.PayloadOwnedBy(rid, metadata->GetIncludeSchema());
+  }
+
+  // rebuild the table tuple from an index key, columns not stored in it are NULL
+  Tuple TupleFromKey(const KeyType &key, bool with_included) const {
+    const IndexMetadata *metadata = index_->GetMetadata();
+    const Schema *table_schema = &table_info_->schema_;
+    std::vector<Value> values;
+    values.reserve(table_schema->GetColumnCount());
+    for (const auto &column : table_schema->GetColumns()) {
+      values.push_back(ValueFactory::GetNullValueByType(column.GetType()));
+    }
+    const auto &key_attrs = metadata->GetKeyAttrs();
+    for (uint32_t i = 0; i < key_attrs.size(); i++) {
+      values[key_attrs[i]] = key.ToValue(metadata->GetKeySchema(), i);
+    }
+    const auto &include_attrs = metadata->GetIncludeAttrs();
+    for (uint32_t i = 0; with_included && i < include_attrs.size(); i++) {
+      values[include_attrs[i]] = key.PayloadValue(metadata->GetIncludeSchema(), i);
+    }
+    return Tuple(values, table_schema);
+  }
+
+  TableMetadata *table_info_;
+  const AbstractExpression *predicate_;
+  Transaction *txn_;
+  /** Whether the index stores all columns read by the plan. */
+  bool covering_{false};
+  KeyType lo_key_;
+  KeyType hi_key_;
+  /** Current batch of index entries and the position in it. */
+  std::vector<std::pair<KeyType, RID>> batch_;
+  size_t batch_index_{0};
+  /** Whether the last batch reached the end of the range. */
+  bool done_{false};
+};
+
+/*
+ * Cursor over a B+ tree, one ScanRange call per batch. When the predicate is
+ * evaluated on the keys and the range is large (the plan asks for a parallel
+ * scan, or the whole tree is scanned and holds PARALLEL_MIN_ENTRIES keys or
+ * more), the range is split with GetPartitionKeys instead. Each round reads
+ * the next chunk of every partition on its own thread, where the keys are
+ * filtered; chunks are handed out one partition after the other, so the scan
+ * stays in key order, and a partition stops reading ahead once
+ * MAX_BUFFERED_CHUNKS of its chunks are waiting.
+ */
+template <size_t KeySize>
+class BPlusTreeCursor : public GenericKeyCursor<KeySize> {
+ public:
+  using KeyType = GenericKey<KeySize>;
+  using IndexType = BPlusTreeIndex<KeyType, RID, GenericComparator<KeySize>>;
+
+  BPlusTreeCursor(IndexType *index, TableMetadata *table_info, const AbstractExpression *predicate,
+                  const std::vector<uint32_t> &columns, Transaction *txn, bool parallel)
+      : GenericKeyCursor<KeySize>(index, table_info, predicate, columns, txn), tree_(index) {
+    // a requested parallel scan uses two threads even where hardware_concurrency() is unknown (0) or 1
+    int threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), parallel ? 2 : 1);
+    bool large = this->lo_ == nullptr && this->hi_ == nullptr &&
+                 tree_->GetStats().leaf_entries_ >= PARALLEL_MIN_ENTRIES;
+    if (this->filter_ && threads > 1 && (parallel || large)) {
+      SplitRange(threads);
+    }
+  }
+
+  // the cursor for index, or nullptr if it is not a B+ tree with keys of this size
+  static std::unique_ptr<IndexScanExecutor::Cursor> Make(Index *index, TableMetadata *table_info,
+                                                         const IndexScanPlanNode *plan,
+                                                         const std::vector<uint32_t> &columns, Transaction *txn) {
+    auto *tree = dynamic_cast<IndexType *>(index);
+    if (tree == nullptr) {
+      return nullptr;
+    }
+    return std::make_unique<BPlusTreeCursor>(tree, table_info, plan->GetPredicate(), columns, txn,
+                                             plan->IsParallel());
+  }
+
+ protected:
+  bool NextBatch(std::vector<std::pair<KeyType, RID>> *batch) override {
+    if (!partitions_.empty()) {
+      return ParallelBatch(batch);
+    }
+    if (batch->empty()) {
+      return tree_->ScanRange(this->lo_, this->lo_inclusive_, this->hi_, this->hi_inclusive_, this->filter_, batch,
+                              this->SCAN_BATCH_SIZE);
+    }
+    KeyType last_key = batch->back().first;
+    return tree_->ScanRange(&last_key, false, this->hi_, this->hi_inclusive_, this->filter_, batch,
+                            this->SCAN_BATCH_SIZE);
+  }
+
+ private:
+  /** Number of keys of a tree from which a scan of all of it is parallel. */
+  static constexpr size_t PARALLEL_MIN_ENTRIES = 1 << 16;
+  /** Number of index entries a partition reads per round. */
+  static constexpr size_t PARALLEL_CHUNK_SIZE = 1024;
+  /** Number of chunks a partition may read ahead of the one being handed out. */
+  static constexpr size_t MAX_BUFFERED_CHUNKS = 4;
+
+  // one key range of a parallel scan, lo is moved past every chunk read
+  struct Partition {
+    KeyType lo_;
+    bool has_lo_;
+    bool lo_inclusive_;
+    KeyType hi_;
+    bool has_hi_;
+    bool hi_inclusive_;
+    std::deque<std::vector<std::pair<KeyType, RID>>> chunks_;
+    bool done_{false};
+  };
+
+  // partition i runs from partition key i - 1 (inclusive) to partition key i (exclusive); no split if there is no key
+  void SplitRange(int threads) {
+    std::vector<KeyType> keys = tree_->GetPartitionKeys(this->lo_, this->hi_, threads);
+    if (keys.empty()) {
+      return;
+    }
+    partitions_.resize(keys.size() + 1);
+    for (size_t i = 0; i < partitions_.size(); i++) {
+      auto &partition = partitions_[i];
+      if (i == 0) {
+        partition.has_lo_ = this->lo_ != nullptr;
+        partition.lo_ = partition.has_lo_ ? *this->lo_ : KeyType();
+        partition.lo_inclusive_ = this->lo_inclusive_;
+      } else {
+        partition.has_lo_ = true;
+        partition.lo_ = keys[i - 1];
+        partition.lo_inclusive_ = true;
+      }
+      if (i == keys.size()) {
+        partition.has_hi_ = this->hi_ != nullptr;
+        partition.hi_ = partition.has_hi_ ? *this->hi_ : KeyType();
+        partition.hi_inclusive_ = this->hi_inclusive_;
+      } else {
+        partition.has_hi_ = true;
+        partition.hi_ = keys[i];
+        partition.hi_inclusive_ = false;
+      }
+    }
+  }
+
+  // the next chunk of the partition being handed out, reading a round first if none is waiting
+  bool ParallelBatch(std::vector<std::pair<KeyType, RID>> *batch) {
+    while (true) {
+      while (current_ < partitions_.size() && partitions_[current_].chunks_.empty() && partitions_[current_].done_) {
+        current_++;
+      }
+      if (current_ == partitions_.size()) {
+        batch->clear();
+        return false;
+      }
+      if (!partitions_[current_].chunks_.empty()) {
+        break;
+      }
+      ReadRound();
+    }
+    *batch = std::move(partitions_[current_].chunks_.front());
+    partitions_[current_].chunks_.pop_front();
+    return true;
+  }
+
+  // read a chunk of the current partition on this thread, and of every later one with room on a thread of its own
+  void ReadRound() {
+    std::vector<std::thread> threads;
+    for (size_t i = current_ + 1; i < partitions_.size(); i++) {
+      if (!partitions_[i].done_ && partitions_[i].chunks_.size() < MAX_BUFFERED_CHUNKS) {
+        threads.emplace_back(&BPlusTreeCursor::ReadChunk, this, &partitions_[i]);
+      }
+    }
+    ReadChunk(&partitions_[current_]);
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+  void ReadChunk(Partition *partition) {
+    std::vector<std::pair<KeyType, RID>> chunk;
+    partition->done_ =
+        !tree_->ScanRange(partition->has_lo_ ? &partition->lo_ : nullptr, partition->lo_inclusive_,
+                          partition->has_hi_ ? &partition->hi_ : nullptr, partition->hi_inclusive_, this->filter_,
+                          &chunk, PARALLEL_CHUNK_SIZE);
+    if (chunk.empty()) {
+      return;
+    }
+    partition->lo_ = chunk.back().first;
+    partition->has_lo_ = true;
+    partition->lo_inclusive_ = false;
+    partition->chunks_.push_back(std::move(chunk));
+  }
+
+  IndexType *tree_;
+  /** Key ranges of a parallel scan, empty for batched ScanRange calls. */
+  std::vector<Partition> partitions_;
+  /** Partition whose chunks are handed out. */
+  size_t current_{0};
+};
+
+/*
+ * Cursor over an adaptive radix tree. Its scans visit the raw key bytes in
+ * order, which is the key order for normalized keys; otherwise SetBounds()
+ * leaves the range open and the order is arbitrary. A batch never ends in the
+ * middle of a key's values, the next one starts at the first key left out.
+ */
+template <size_t KeySize>
+class ARTCursor : public GenericKeyCursor<KeySize> {
+ public:
+  using KeyType = GenericKey<KeySize>;
+  using IndexType = ARTIndex<KeyType, RID, GenericComparator<KeySize>>;
+
+  ARTCursor(IndexType *index, TableMetadata *table_info, const AbstractExpression *predicate,
+            const std::vector<uint32_t> &columns, Transaction *txn)
+      : GenericKeyCursor<KeySize>(index, table_info, predicate, columns, txn), art_(index) {}
+
+  // the cursor for index, or nullptr if it is not an ART with keys of this size
+  static std::unique_ptr<IndexScanExecutor::Cursor> Make(Index *index, TableMetadata *table_info,
+                                                         const IndexScanPlanNode *plan,
+                                                         const std::vector<uint32_t> &columns, Transaction *txn) {
+    auto *art = dynamic_cast<IndexType *>(index);
+    if (art == nullptr) {
+      return nullptr;
+    }
+    return std::make_unique<ARTCursor>(art, table_info, plan->GetPredicate(), columns, txn);
+  }
+
+ protected:
+  bool NextBatch(std::vector<std::pair<KeyType, RID>> *batch) override {
+    // ART bounds are inclusive, the predicate drops the bound keys of exclusive ones
+    const KeyType *lo = batch->empty() ? this->lo_ : &resume_key_;
+    batch->clear();
+    bool more = false;
+    art_->ScanRange(lo, this->hi_, [&](const KeyType &key, const RID &rid) {
+      if (batch->size() >= this->SCAN_BATCH_SIZE && memcmp(key.data_, batch->back().first.data_, KeySize) != 0) {
+        resume_key_ = key;
+        more = true;
+        return false;
+      }
+      if (!this->filter_ || this->filter_(key)) {
+        batch->emplace_back(key, rid);
+      }
+      return true;
+    });
+    return more;
+  }
+
+ private:
+  IndexType *art_;
+  KeyType resume_key_;
+};
+
+/*
+ * Cursor over a skip list. The iterator stays open for the whole scan, which
+ * keeps the list's epoch from advancing until the cursor is destroyed.
+ */
+template <size_t KeySize>
+class SkipListCursor : public GenericKeyCursor<KeySize> {
+ public:
+  using KeyType = GenericKey<KeySize>;
+  using IndexType = SkipListIndex<KeyType, RID, GenericComparator<KeySize>>;
+  using IteratorType = SkipListIterator<KeyType, RID, GenericComparator<KeySize>>;
+
+  SkipListCursor(IndexType *index, TableMetadata *table_info, const AbstractExpression *predicate,
+                 const std::vector<uint32_t> &columns, Transaction *txn)
+      : GenericKeyCursor<KeySize>(index, table_info, predicate, columns, txn),
+        list_(index),
+        comparator_(index->GetKeySchema()) {}
+
+  // the cursor for index, or nullptr if it is not a skip list with keys of this size
+  static std::unique_ptr<IndexScanExecutor::Cursor> Make(Index *index, TableMetadata *table_info,
+                                                         const IndexScanPlanNode *plan,
+                                                         const std::vector<uint32_t> &columns, Transaction *txn) {
+    auto *list = dynamic_cast<IndexType *>(index);
+    if (list == nullptr) {
+      return nullptr;
+    }
+    return std::make_unique<SkipListCursor>(list, table_info, plan->GetPredicate(), columns, txn);
+  }
+
+ protected:
+  bool NextBatch(std::vector<std::pair<KeyType, RID>> *batch) override {
+    batch->clear();
+    if (it_ == nullptr) {
+      it_ = std::make_unique<IteratorType>(this->lo_ == nullptr ? list_->GetBeginIterator()
+                                                                : list_->GetBeginIterator(*this->lo_));
+      while (this->lo_ != nullptr && !this->lo_inclusive_ && !it_->isEnd() &&
+             comparator_((**it_).first, *this->lo_) == 0) {
+        ++(*it_);
+      }
+    }
+    for (; !it_->isEnd() && batch->size() < this->SCAN_BATCH_SIZE; ++(*it_)) {
+      const auto &item = **it_;
+      if (this->hi_ != nullptr) {
+        int cmp = comparator_(item.first, *this->hi_);
+        if (cmp > 0 || (cmp == 0 && !this->hi_inclusive_)) {
+          return false;
+        }
+      }
+      if (!this->filter_ || this->filter_(item.first)) {
+        batch->push_back(item);
+      }
+    }
+    return !it_->isEnd();
+  }
+
+ private:
+  IndexType *list_;
+  GenericComparator<KeySize> comparator_;
+  std::unique_ptr<IteratorType> it_;
+};
+
+/*
+ * Cursor over a variable length key B+ tree. Its keys are encoded byte
+ * strings that are not decoded here, so neither the key range nor the key
+ * predicate is pushed into the scan: every entry is read in key order, a batch
+ * at a time, and the predicate is evaluated on the table tuples.
+ */
+class VarKeyCursor : public IndexScanExecutor::Cursor {
+ public:
+  VarKeyCursor(VarKeyBPlusTreeIndex *index, TableMetadata *table_info, const AbstractExpression *predicate,
+               Transaction *txn)
+      : index_(index), table_info_(table_info), predicate_(predicate), txn_(txn) {}
+
+  // the cursor for index, or nullptr if it is not a variable length key B+ tree
+  static std::unique_ptr<IndexScanExecutor::Cursor> Make(Index *index, TableMetadata *table_info,
+                                                         const IndexScanPlanNode *plan,
+                                                         const std::vector<uint32_t> &columns, Transaction *txn) {
+    auto *tree = dynamic_cast<VarKeyBPlusTreeIndex *>(index);
+    if (tree == nullptr) {
+      return nullptr;
+    }
+    return std::make_unique<VarKeyCursor>(tree, table_info, plan->GetPredicate(), txn);
+  }
+
+  bool Next(Tuple *tuple, RID *rid) override {
+    while (batch_index_ < batch_.size() || Refill()) {
+      RID entry = batch_[batch_index_++];
+      if (!table_info_->table_->GetTuple(entry, tuple, txn_)) {
+        continue;
+      }
+      if (predicate_ != nullptr && !predicate_->Evaluate(tuple, &table_info_->schema_).GetAs<bool>()) {
+        continue;
+      }
+      *rid = entry;
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  // tree keys are unique (they end with the RID), so the next batch starts at the first key left out of this one
+  bool Refill() {
+    batch_.clear();
+    batch_index_ = 0;
+    if (done_) {
+      return false;
+    }
+    done_ = true;
+    index_->Scan(
+        resume_key_,
+        [this](const std::string &key, const RID &rid) {
+          if (batch_.size() >= SCAN_BATCH_SIZE) {
+            resume_key_ = key;
+            done_ = false;
+            return false;
+          }
+          batch_.push_back(rid);
+          return true;
+        },
+        txn_);
+    return !batch_.empty();
+  }
+
+  /** Number of index entries fetched per batch. */
+  static constexpr size_t SCAN_BATCH_SIZE = 128;
+
+  VarKeyBPlusTreeIndex *index_;
+  TableMetadata *table_info_;
+  const AbstractExpression *predicate_;
+  Transaction *txn_;
+  /** Current batch of RIDs and the position in it. */
+  std::vector<RID> batch_;
+  size_t batch_index_{0};
+  /** Encoded key the next batch starts at. */
+  std::string resume_key_;
+  /** Whether the last batch reached the end of the index. */
+  bool done_{false};
+};
+}  // namespace
+
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
 
-void IndexScanExecutor::Init() {}
+void IndexScanExecutor::Init() {
+  auto *catalog = exec_ctx_->GetCatalog();
+  auto *index_info = catalog->GetIndex(plan_->GetIndexOid());
+  table_info_ = catalog->GetTable(index_info->table_name_);
+  std::vector<uint32_t> columns;
+  CollectColumns(plan_->GetPredicate(), &columns);
+  for (const auto &column : GetOutputSchema()->GetColumns()) {
+    CollectColumns(column.GetExpr(), &columns);
+  }
+  // the ordered index kinds and key sizes a cursor exists for, the catalog instantiates each of them; hash indexes
+  // have no key order to scan in
+  using MakeCursor = std::unique_ptr<Cursor> (*)(Index *, TableMetadata *, const IndexScanPlanNode *,
+                                                  const std::vector<uint32_t> &, Transaction *);
+  for (MakeCursor make :
+       {&BPlusTreeCursor<4>::Make, &BPlusTreeCursor<8>::Make, &BPlusTreeCursor<16>::Make, &BPlusTreeCursor<32>::Make,
+        &BPlusTreeCursor<64>::Make, &ARTCursor<4>::Make, &ARTCursor<8>::Make, &ARTCursor<16>::Make,
+        &ARTCursor<32>::Make, &ARTCursor<64>::Make, &SkipListCursor<4>::Make, &SkipListCursor<8>::Make,
+        &SkipListCursor<16>::Make, &SkipListCursor<32>::Make, &SkipListCursor<64>::Make, &VarKeyCursor::Make}) {
+    cursor_ = make(index_info->index_.get(), table_info_, plan_, columns, exec_ctx_->GetTransaction());
+    if (cursor_ != nullptr) {
+      return;
+    }
+  }
+  throw NotImplementedException("IndexScanExecutor: index " + index_info->name_ + " cannot be scanned in key order");
+}
 
-bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) {
+  Tuple table_tuple;
+  RID tuple_rid;
+  if (!cursor_->Next(&table_tuple, &tuple_rid)) {
+    return false;
+  }
+  const Schema *table_schema = &table_info_->schema_;
+  const Schema *output_schema = GetOutputSchema();
+  std::vector<Value> values;
+  values.reserve(output_schema->GetColumnCount());
+  for (const auto &column : output_schema->GetColumns()) {
+    values.push_back(column.GetExpr()->Evaluate(&table_tuple, table_schema));
+  }
+  *tuple = Tuple(values, output_schema);
+  *rid = tuple_rid;
+  return true;
+}
 
 }  // namespace bustub
@@ -12,14 +12,142 @@
 
 #include "execution/executors/nested_index_join_executor.h"
 
+#include "common/exception.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+
 namespace bustub {
 
+namespace {
+// the inner table column read by column i of the inner table schema, or -1 if it is not a plain column
+int64_t InnerTableColumn(const Schema *inner_schema, uint32_t i) {
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(inner_schema->GetColumn(i).GetExpr());
+  return column == nullptr ? -1 : column->GetColIdx();
+}
+}  // namespace
+
 NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+
+void NestIndexJoinExecutor::Init() {
+  auto *catalog = exec_ctx_->GetCatalog();
+  inner_table_ = catalog->GetTable(plan_->GetInnerTableOid());
+  index_info_ = catalog->GetIndex(plan_->GetIndexName(), inner_table_->name_);
+
+  // outer.column = inner.column, with the inner column mapped back to the inner table
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(plan_->Predicate());
+  int64_t outer_column = -1;
+  int64_t inner_column = -1;
+  if (comparison != nullptr && comparison->GetComparisonType() == ComparisonType::Equal) {
+    const auto *lhs = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+    const auto *rhs = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1));
+    if (lhs != nullptr && rhs != nullptr && lhs->GetTupleIdx() != rhs->GetTupleIdx()) {
+      if (lhs->GetTupleIdx() != 0) {
+        std::swap(lhs, rhs);
+      }
+      outer_column = lhs->GetColIdx();
+      inner_column = InnerTableColumn(plan_->InnerTableSchema(), rhs->GetColIdx());
+    }
+  }
+  outer_key_columns_.clear();
+  for (uint32_t key_attr : index_info_->index_->GetKeyAttrs()) {
+    if (key_attr != inner_column) {
+      throw NotImplementedException("NestIndexJoinExecutor: the predicate does not give every key column of index " +
+                                    index_info_->name_);
+    }
+    outer_key_columns_.push_back(outer_column);
+  }
+
+  child_executor_->Init();
+  outer_batch_.clear();
+  inner_rids_.clear();
+  outer_index_ = 0;
+  rid_index_ = 0;
+}
+
+bool NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  const Schema *outer_schema = plan_->OuterTableSchema();
+  const Schema *inner_schema = plan_->InnerTableSchema();
+  while (outer_index_ < outer_batch_.size() || NextBatch()) {
+    const Tuple &outer_tuple = outer_batch_[outer_index_];
+    const auto &rids = inner_rids_[outer_index_];
+    if (rid_index_ == rids.size()) {
+      outer_index_++;
+      rid_index_ = 0;
+      continue;
+    }
+    RID inner_rid = rids[rid_index_++];
+    Tuple inner_tuple;
+    if (!GetInnerTuple(inner_rid, &inner_tuple) ||
+        !plan_->Predicate()->EvaluateJoin(&outer_tuple, outer_schema, &inner_tuple, inner_schema).GetAs<bool>()) {
+      continue;
+    }
+    const Schema *output_schema = GetOutputSchema();
+    std::vector<Value> values;
+    values.reserve(output_schema->GetColumnCount());
+    for (const auto &column : output_schema->GetColumns()) {
+      values.push_back(column.GetExpr()->EvaluateJoin(&outer_tuple, outer_schema, &inner_tuple, inner_schema));
+    }
+    *tuple = Tuple(values, output_schema);
+    *rid = inner_rid;
+    return true;
+  }
+  return false;
+}
+
+bool NestIndexJoinExecutor::NextBatch() {
+  outer_batch_.clear();
+  outer_index_ = 0;
+  rid_index_ = 0;
+  const Schema *outer_schema = plan_->OuterTableSchema();
+  const Schema *key_schema = index_info_->index_->GetKeySchema();
+  std::vector<Tuple> keys;
+  // outer tuples with a NULL key match nothing and are not probed
+  std::vector<size_t> probed;
+  Tuple outer_tuple;
+  RID outer_rid;
+  while (outer_batch_.size() < PROBE_BATCH_SIZE && child_executor_->Next(&outer_tuple, &outer_rid)) {
+    std::vector<Value> key_values;
+    key_values.reserve(outer_key_columns_.size());
+    bool has_null = false;
+    for (uint32_t i = 0; i < outer_key_columns_.size(); i++) {
+      Value value = outer_tuple.GetValue(outer_schema, outer_key_columns_[i]);
+      has_null = has_null || value.IsNull();
+      key_values.push_back(has_null ? value : value.CastAs(key_schema->GetColumn(i).GetType()));
+    }
+    if (!has_null) {
+      probed.push_back(outer_batch_.size());
+      keys.emplace_back(key_values, key_schema);
+    }
+    outer_batch_.push_back(outer_tuple);
+  }
+  if (outer_batch_.empty()) {
+    return false;
+  }
 
-void NestIndexJoinExecutor::Init() {}
+  std::vector<std::vector<RID>> probe_rids;
+  index_info_->index_->ScanKeys(keys, &probe_rids, exec_ctx_->GetTransaction());
+  inner_rids_.assign(outer_batch_.size(), std::vector<RID>());
+  for (size_t i = 0; i < probed.size(); i++) {
+    inner_rids_[probed[i]] = std::move(probe_rids[i]);
+  }
+  return true;
+}
 
-bool NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool NestIndexJoinExecutor::GetInnerTuple(RID rid, Tuple *tuple) {
+  Tuple table_tuple;
+  if (!inner_table_->table_->GetTuple(rid, &table_tuple, exec_ctx_->GetTransaction())) {
+    return false;
+  }
+  const Schema *inner_schema = plan_->InnerTableSchema();
+  std::vector<Value> values;
+  values.reserve(inner_schema->GetColumnCount());
+  for (const auto &column : inner_schema->GetColumns()) {
+    values.push_back(column.GetExpr()->Evaluate(&table_tuple, &inner_table_->schema_));
+  }
+  *tuple = Tuple(values, inner_schema);
+  return true;
+}
 
 }  // namespace bustub
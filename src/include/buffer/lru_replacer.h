@@ -58,7 +58,7 @@ class LRUReplacer : public Replacer {
   // capacity
   size_t capacity_;
 
-  size_t size_;
+  size_t size_{0};
 
   std::unordered_map<frame_id_t, LinkNode*> map_cache;
 
@@ -8,8 +8,13 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "storage/index/art_index.h"
 #include "storage/index/b_plus_tree_index.h"
+#include "storage/index/cuckoo_hash_table_index.h"
+#include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
+#include "storage/index/skip_list_index.h"
+#include "storage/index/var_key_b_plus_tree_index.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -21,6 +26,18 @@ using table_oid_t = uint32_t;
 using column_oid_t = uint32_t;
 using index_oid_t = uint32_t;
 
+/**
+ * The data structures an index can be built on.
+ */
+enum class IndexKind {
+  BPLUS_TREE,          // BPlusTreeIndex, on buffer pool pages
+  ART,                 // ARTIndex, an in-memory adaptive radix tree
+  SKIP_LIST,           // SkipListIndex, an in-memory lock-free skip list
+  EXTENDIBLE_HASH,     // ExtendibleHashTableIndex, on buffer pool pages, point lookups only
+  CUCKOO_HASH,         // CuckooHashTableIndex, on buffer pool pages, point lookups only
+  VAR_KEY_BPLUS_TREE,  // VarKeyBPlusTreeIndex, on slotted buffer pool pages, VARCHAR keys
+};
+
 /**
  * Metadata about a table.
  */
@@ -77,14 +94,19 @@ class Catalog {
    */
   TableMetadata *CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema) {
     BUSTUB_ASSERT(names_.count(table_name) == 0, "Table names should be unique!");
-    return nullptr;
+    table_oid_t table_oid = next_table_oid_++;
+    auto table = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, txn);
+    auto *table_info = new TableMetadata(schema, table_name, std::move(table), table_oid);
+    tables_.emplace(table_oid, std::unique_ptr<TableMetadata>(table_info));
+    names_.emplace(table_name, table_oid);
+    return table_info;
   }
 
   /** @return table metadata by name */
-  TableMetadata *GetTable(const std::string &table_name) { return nullptr; }
+  TableMetadata *GetTable(const std::string &table_name) { return tables_.at(names_.at(table_name)).get(); }
 
   /** @return table metadata by oid */
-  TableMetadata *GetTable(table_oid_t table_oid) { return nullptr; }
+  TableMetadata *GetTable(table_oid_t table_oid) { return tables_.at(table_oid).get(); }
 
   /**
    * Create a new index, populate existing data of the table and return its metadata.
@@ -95,20 +117,74 @@ class Catalog {
    * @param key_schema the schema of the key
    * @param key_attrs key attributes
    * @param keysize size of the key
+   * @param include_attrs attributes stored in the index entries after the key, so that queries reading only key and
+   * included columns are answered from the index alone (a covering index); keysize must hold them and a RID after
+   * the key, and only B+ tree indexes support them
+   * @param kind the data structure of the index
    * @return a pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
                          const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
-                         size_t keysize) {
-    return nullptr;
+                         size_t keysize, const std::vector<uint32_t> &include_attrs = {},
+                         IndexKind kind = IndexKind::BPLUS_TREE) {
+    BUSTUB_ASSERT(index_names_[table_name].count(index_name) == 0, "Index names should be unique!");
+    if (!include_attrs.empty() && kind != IndexKind::BPLUS_TREE) {
+      throw NotImplementedException("CreateIndex: only B+ tree indexes can include columns");
+    }
+    auto *metadata = new IndexMetadata(index_name, table_name, &schema, key_attrs, include_attrs);
+    if (kind == IndexKind::VAR_KEY_BPLUS_TREE && !VarKeyBPlusTreeIndex::SupportsKeySchema(metadata->GetKeySchema())) {
+      delete metadata;
+      throw NotImplementedException("CreateIndex: variable length key indexes only take VARCHAR key columns");
+    }
+    index_oid_t index_oid = next_index_oid_++;
+    std::unique_ptr<Index> index;
+    if (kind == IndexKind::VAR_KEY_BPLUS_TREE) {
+      // keys are encoded byte strings, KeyType and keysize are unused
+      index = std::make_unique<VarKeyBPlusTreeIndex>(metadata, bpm_);
+    } else if (kind == IndexKind::ART) {
+      index = std::make_unique<ARTIndex<KeyType, ValueType, KeyComparator>>(metadata, bpm_);
+    } else if (kind == IndexKind::SKIP_LIST) {
+      index = std::make_unique<SkipListIndex<KeyType, ValueType, KeyComparator>>(metadata, bpm_);
+    } else if (kind == IndexKind::EXTENDIBLE_HASH) {
+      index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(metadata, bpm_,
+                                                                                             HashFunction<KeyType>());
+    } else if (kind == IndexKind::CUCKOO_HASH) {
+      // start from a single block page, the table doubles as it fills
+      index = std::make_unique<CuckooHashTableIndex<KeyType, ValueType, KeyComparator>>(metadata, bpm_, 1,
+                                                                                         HashFunction<KeyType>());
+    } else {
+      index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(metadata, bpm_);
+    }
+
+    // populate the index with the existing tuples of the table
+    TableHeap *table = GetTable(table_name)->table_.get();
+    for (auto it = table->Begin(txn); it != table->End(); ++it) {
+      index->InsertEntry(it->KeyFromTuple(schema, *index->GetEntrySchema(), index->GetEntryAttrs()), it->GetRid(), txn);
+    }
+
+    auto *index_info = new IndexInfo(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    indexes_.emplace(index_oid, std::unique_ptr<IndexInfo>(index_info));
+    index_names_[table_name].emplace(index_name, index_oid);
+    return index_info;
   }
 
-  IndexInfo *GetIndex(const std::string &index_name, const std::string &table_name) { return nullptr; }
-
-  IndexInfo *GetIndex(index_oid_t index_oid) { return nullptr; }
+  IndexInfo *GetIndex(const std::string &index_name, const std::string &table_name) {
+    return indexes_.at(index_names_.at(table_name).at(index_name)).get();
+  }
 
-  std::vector<IndexInfo *> GetTableIndexes(const std::string &table_name) { return std::vector<IndexInfo *>(); }
+  IndexInfo *GetIndex(index_oid_t index_oid) { return indexes_.at(index_oid).get(); }
+
+  std::vector<IndexInfo *> GetTableIndexes(const std::string &table_name) {
+    std::vector<IndexInfo *> index_infos;
+    auto it = index_names_.find(table_name);
+    if (it != index_names_.end()) {
+      for (const auto &index_name : it->second) {
+        index_infos.push_back(indexes_.at(index_name.second).get());
+      }
+    }
+    return index_infos;
+  }
 
  private:
   [[maybe_unused]] BufferPoolManager *bpm_;
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// epoch_manager.h
+//
+// Identification: src/include/common/epoch_manager.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * Epoch-based memory reclamation for latch-free in-memory indexes.
+ *
+ * Readers traverse nodes without latches, so a node unlinked by a writer may
+ * still be read by threads that found it earlier. Every operation runs inside
+ * a Guard, which registers the thread in the current global epoch; unlinked
+ * nodes are handed to Retire() instead of being deleted, and are freed once
+ * the global epoch has advanced twice past their retirement, i.e. when no
+ * thread that could have seen them is still inside a Guard.
+ * Three epochs are tracked at a time: the current one, the previous one (may
+ * still have active threads), and the one before (its nodes are being freed).
+ */
+class EpochManager {
+  static const uint32_t EPOCH_COUNT = 3;
+  // try to advance the epoch whenever this many nodes are waiting in the current epoch
+  static const size_t ADVANCE_THRESHOLD = 64;
+
+ public:
+  using Deleter = void (*)(void *);
+
+  EpochManager() = default;
+  ~EpochManager() {
+    for (auto &limbo : limbo_) {
+      FreeAll(&limbo);
+    }
+  }
+
+  DISALLOW_COPY_AND_MOVE(EpochManager);
+
+  /**
+   * RAII registration of the calling thread in the current epoch.
+   */
+  class Guard {
+   public:
+    explicit Guard(EpochManager *manager) : manager_(manager), epoch_(manager->Enter()) {}
+    ~Guard() { manager_->Exit(epoch_); }
+    DISALLOW_COPY_AND_MOVE(Guard);
+
+   private:
+    EpochManager *manager_;
+    uint64_t epoch_;
+  };
+
+  /**
+   * Free ptr with deleter once no thread can still reach it. The caller must
+   * have unlinked ptr already and be inside a Guard.
+   */
+  void Retire(void *ptr, Deleter deleter) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto &limbo = limbo_[epoch_.load() % EPOCH_COUNT];
+    limbo.emplace_back(ptr, deleter);
+    if (limbo.size() >= ADVANCE_THRESHOLD) {
+      TryAdvance();
+    }
+  }
+
+  template <typename T>
+  void Retire(T *ptr) {
+    Retire(ptr, [](void *p) { delete static_cast<T *>(p); });
+  }
+
+  /** @return the current global epoch */
+  uint64_t GetEpoch() const { return epoch_.load(); }
+
+ private:
+  uint64_t Enter() {
+    while (true) {
+      uint64_t epoch = epoch_.load();
+      active_[epoch % EPOCH_COUNT].fetch_add(1);
+      // the epoch may have advanced before we were counted, then register again
+      if (epoch_.load() == epoch) {
+        return epoch;
+      }
+      active_[epoch % EPOCH_COUNT].fetch_sub(1);
+    }
+  }
+
+  void Exit(uint64_t epoch) { active_[epoch % EPOCH_COUNT].fetch_sub(1); }
+
+  /*
+   * Advance from e to e + 1 once nobody is left in e - 1: the nodes retired in
+   * e - 2 are then unreachable and their slot is reused for e + 1.
+   * The caller holds mutex_.
+   */
+  void TryAdvance() {
+    uint64_t epoch = epoch_.load();
+    if (active_[(epoch + EPOCH_COUNT - 1) % EPOCH_COUNT].load() != 0) {
+      return;
+    }
+    FreeAll(&limbo_[(epoch + 1) % EPOCH_COUNT]);
+    epoch_.store(epoch + 1);
+  }
+
+  static void FreeAll(std::vector<std::pair<void *, Deleter>> *limbo) {
+    for (auto &retired : *limbo) {
+      retired.second(retired.first);
+    }
+    limbo->clear();
+  }
+
+  std::atomic<uint64_t> epoch_{EPOCH_COUNT};
+  std::atomic<uint64_t> active_[EPOCH_COUNT]{};
+  std::mutex mutex_;
+  std::vector<std::pair<void *, Deleter>> limbo_[EPOCH_COUNT];
+};
+
+}  // namespace bustub
@@ -13,7 +13,9 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -27,8 +29,63 @@ using hash_t = std::size_t;
 class HashUtil {
  private:
   static const hash_t prime_factor = 10000019;
+  static const uint64_t mix_factor = 0xd6e8feb86659fd93ULL;
+  static const uint64_t word_prime_1 = 0x9e3779b185ebca87ULL;
+  static const uint64_t word_prime_2 = 0xc2b2ae3d27d4eb4fULL;
+
+  static inline uint64_t RotateLeft(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
 
  public:
+  /**
+   * Multiply-shift mixer for keys of up to eight bytes: two multiplications
+   * carry every input bit into the high and the low bits of the hash.
+   * @return the hash of key
+   */
+  static inline hash_t HashInteger(uint64_t key) {
+    key ^= key >> 32;
+    key *= mix_factor;
+    key ^= key >> 32;
+    key *= mix_factor;
+    key ^= key >> 32;
+    return key;
+  }
+
+  /**
+   * Hash for longer keys, eight bytes per round with one multiplication on the
+   * dependency chain; the last word is zero padded and the result mixed once.
+   * @return the hash of the length bytes at data
+   */
+  static inline hash_t HashWords(const void *data, size_t length) {
+    auto *bytes = static_cast<const char *>(data);
+    uint64_t hash = length * word_prime_1;
+    uint64_t word;
+    size_t i = 0;
+    for (; i + sizeof(word) <= length; i += sizeof(word)) {
+      memcpy(&word, bytes + i, sizeof(word));
+      hash = RotateLeft(hash + word * word_prime_2, 31) * word_prime_1;
+    }
+    if (i < length) {
+      word = 0;
+      memcpy(&word, bytes + i, length - i);
+      hash = RotateLeft(hash + word * word_prime_2, 31) * word_prime_1;
+    }
+    return HashInteger(hash);
+  }
+
+  /**
+   * Hash of a fixed-width key, chosen at compile time by its size.
+   */
+  template <typename T>
+  static inline hash_t HashFixed(const T &key) {
+    if constexpr (sizeof(T) <= sizeof(uint64_t)) {
+      uint64_t word = 0;
+      memcpy(&word, &key, sizeof(T));
+      return HashInteger(word);
+    } else {
+      return HashWords(&key, sizeof(T));
+    }
+  }
+
   static inline hash_t HashBytes(const char *bytes, size_t length) {
     // https://github.com/greenplum-db/gpos/blob/b53c1acd6285de94044ff91fbee91589543feba1/libgpos/src/utils.cpp#L126
     hash_t hash = length;
@@ -39,22 +96,19 @@ class HashUtil {
   }
 
   static inline hash_t CombineHashes(hash_t l, hash_t r) {
-    hash_t both[2];
-    both[0] = l;
-    both[1] = r;
-    return HashBytes(reinterpret_cast<char *>(both), sizeof(hash_t) * 2);
+    return HashInteger(l ^ (r + word_prime_1 + (l << 6) + (l >> 2)));
   }
 
   static inline hash_t SumHashes(hash_t l, hash_t r) { return (l % prime_factor + r % prime_factor) % prime_factor; }
 
   template <typename T>
   static inline hash_t Hash(const T *ptr) {
-    return HashBytes(reinterpret_cast<const char *>(ptr), sizeof(T));
+    return HashFixed(*ptr);
   }
 
   template <typename T>
   static inline hash_t HashPtr(const T *ptr) {
-    return HashBytes(reinterpret_cast<const char *>(&ptr), sizeof(void *));
+    return HashInteger(reinterpret_cast<uintptr_t>(ptr));
   }
 
   /** @return the hash of the value */
@@ -87,7 +141,7 @@ class HashUtil {
       case TypeId::VARCHAR: {
         auto raw = val->GetData();
         auto len = val->GetLength();
-        return HashBytes(raw, len);
+        return HashWords(raw, len);
       }
       case TypeId::TIMESTAMP: {
         auto raw = val->GetAs<uint64_t>();
@@ -0,0 +1,200 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cuckoo_hash_table.h
+//
+// Identification: src/include/container/hash/cuckoo_hash_table.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/page/hash_table_block_page.h"
+#include "storage/page/hash_table_header_page.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+#define CUCKOO_HASH_TABLE_TYPE CuckooHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of bucketized cuckoo hash table that is backed by a buffer
+ * pool manager. Non-unique keys are supported. Supports insert and delete.
+ * (1) block pages are cut into buckets of BUCKET_SIZE slots, and a key may
+ *     live in two candidate buckets, chosen by the low and the high half of
+ *     its hash; a lookup reads at most two block pages
+ * (2) an insert into two full buckets evicts a random pair to its other
+ *     bucket, for at most MAX_KICKS evictions; a failed walk is undone
+ * (3) a pair that still finds no room goes to a stash of up to STASH_SIZE
+ *     pairs, and once the stash is full the table doubles and is rebuilt
+ * (4) values of a key that fill both of its buckets go to an overflow chain of
+ *     block pages for its hash, as does a pair that finds no room after
+ *     growing; evicting or growing cannot make room for them
+ * Lookups latch their pages in shared mode under the table latch in shared
+ * mode, so they run concurrently. Inserts into a free slot and removes latch
+ * their pages exclusively under the shared table latch; evictions, the stash
+ * and growing take the table latch exclusively.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class CuckooHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+ public:
+  /**
+   * Creates a new CuckooHashTable
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param num_buckets initial number of buckets, rounded up to whole block pages
+   * @param hash_fn the hash function
+   */
+  explicit CuckooHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                           const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false if the pair exists
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /**
+   * @return the number of buckets of the hash table
+   */
+  size_t GetSize();
+
+  /**
+   * @return the number of pairs in the stash
+   */
+  size_t GetStashSize();
+
+  /**
+   * @return the number of block pages in overflow chains
+   */
+  size_t GetOverflowSize();
+
+ private:
+  using BlockPage = HashTableBlockPage<KeyType, ValueType, KeyComparator>;
+
+  // result of trying to insert into the two candidate buckets
+  // FULL_OF_KEY: both buckets are full of values of the key itself
+  enum class InsertResult { INSERTED, DUPLICATE, FULL, FULL_OF_KEY };
+
+  // one candidate bucket of a key, latched by VisitBuckets
+  struct Bucket {
+    BlockPage *block_;
+    slot_offset_t start_;
+  };
+
+  // slots per bucket, a bucket is matched with one MatchTag call
+  static const slot_offset_t BUCKET_SIZE = 8;
+  static const uint32_t BUCKET_MASK = (1U << BUCKET_SIZE) - 1;
+  static const size_t BUCKETS_PER_BLOCK = BLOCK_ARRAY_SIZE / BUCKET_SIZE;
+  // evictions before an insert gives up on the buckets
+  static const int MAX_KICKS = 64;
+  static const size_t STASH_SIZE = 8;
+
+  static size_t FirstBucket(uint64_t hash, size_t num_buckets) { return (hash & 0xffffffff) % num_buckets; }
+
+  static size_t SecondBucket(uint64_t hash, size_t num_buckets) {
+    size_t bucket = (hash >> 32) % num_buckets;
+    return bucket != FirstBucket(hash, num_buckets) ? bucket : (bucket + 1) % num_buckets;
+  }
+
+  HashTableHeaderPage *FetchHeaderPage();
+
+  // allocate a header page and the block pages for at least num_buckets buckets
+  page_id_t NewLayout(size_t num_buckets);
+
+  void DeleteLayout(page_id_t header_page_id);
+
+  // fetch a block page and latch it, for writing or for reading
+  Page *FetchBlockPage(page_id_t block_page_id, bool exclusive);
+
+  void ReleaseBlockPage(Page *page, bool exclusive, bool dirty);
+
+  /*
+   * Latch the pages of the two candidate buckets of hash, in page id order,
+   * and call visit(buckets, &dirty) with both.
+   */
+  template <typename Visitor>
+  void VisitBuckets(HashTableHeaderPage *header, uint64_t hash, bool exclusive, Visitor visit);
+
+  // insert into a free slot of the candidate buckets, checking both and the stash for the pair
+  InsertResult InsertIntoBuckets(HashTableHeaderPage *header, const KeyType &key, uint64_t hash,
+                                 const ValueType &value, bool check_duplicate);
+
+  // make room in the candidate buckets by evictions, under the exclusive table latch
+  bool CuckooInsert(HashTableHeaderPage *header, const KeyType &key, uint64_t hash, const ValueType &value);
+
+  // insert a pair not in the table by evictions, stash, growing or overflow, under the exclusive table latch
+  void InsertExclusive(const KeyType &key, uint64_t hash, const ValueType &value, bool may_grow);
+
+  // rebuild the table with twice the buckets, under the exclusive table latch; false if it cannot grow
+  bool Grow();
+
+  bool RemoveFromBuckets(HashTableHeaderPage *header, const KeyType &key, uint64_t hash, const ValueType &value);
+
+  /*
+   * Latch the pages of the overflow chain of hash one at a time and call
+   * visit(block, offset, &dirty) for every pair of key, until it returns true.
+   * Returns true if a visit did.
+   */
+  template <typename Visitor>
+  bool VisitOverflow(const KeyType &key, uint64_t hash, bool exclusive, Visitor visit);
+
+  // append a pair to the overflow chain of hash, under the exclusive table latch
+  void InsertIntoOverflow(const KeyType &key, uint64_t hash, const ValueType &value);
+
+  bool RemoveFromOverflow(const KeyType &key, uint64_t hash, const ValueType &value);
+
+  // member variable
+  page_id_t header_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+
+  // Readers includes lookups, inserts into free slots and removes, writers are evictions, the stash and growing
+  ReaderWriterLatch table_latch_;
+
+  // pairs that found no bucket, changed under the exclusive table latch only
+  std::vector<MappingType> stash_;
+  // block pages of the pairs that can live in no bucket, by hash, changed under the exclusive table latch only
+  std::unordered_map<uint64_t, std::vector<page_id_t>> overflow_;
+  // chooses the pairs to evict, under the exclusive table latch
+  std::mt19937 random_;
+
+  // Hash function
+  HashFunction<KeyType> hash_fn_;
+};
+
+}  // namespace bustub
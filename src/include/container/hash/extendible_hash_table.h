@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.h
+//
+// Identification: src/include/container/hash/extendible_hash_table.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/page/hash_table_block_page.h"
+#include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+#define EXTENDIBLE_HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of extendible hash table that is backed by a buffer pool
+ * manager. Non-unique keys are supported. Supports insert and delete.
+ * (1) a directory page maps the low bits of a key's hash to a bucket page,
+ *     a HashTableBlockPage filled from its first slot on
+ * (2) a full bucket splits in two by one more hash bit, doubling the directory
+ *     only if the bucket was already as deep as the directory; no other
+ *     bucket is touched
+ * (3) an empty bucket merges back into its split image, and the directory
+ *     halves once no bucket needs its full depth
+ * (4) a full bucket that no split up to DIRECTORY_MAX_DEPTH can divide, such
+ *     as one holding the values of a single key, gets overflow pages instead
+ * Lookups, inserts and removes latch their bucket page under the table latch
+ * in shared mode; only splits, merges and new overflow pages take the table
+ * latch exclusively. Inserts and removes keep the bucket page latched while
+ * they visit its overflow pages.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ExtendibleHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+ public:
+  /**
+   * Creates a new ExtendibleHashTable with a single bucket
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param hash_fn the hash function
+   */
+  explicit ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                               const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false if the pair exists
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /**
+   * @return the global depth of the directory
+   */
+  uint32_t GetGlobalDepth();
+
+ private:
+  using BucketPage = HashTableBlockPage<KeyType, ValueType, KeyComparator>;
+
+  // result of trying to insert into one bucket
+  enum class InsertResult { INSERTED, DUPLICATE, FULL };
+
+  uint32_t Hash(const KeyType &key) { return static_cast<uint32_t>(hash_fn_.GetHash(key)); }
+
+  HashTableDirectoryPage *FetchDirectoryPage();
+
+  // fetch a bucket page and latch it, for writing or for reading
+  Page *FetchBucketPage(page_id_t bucket_page_id, bool exclusive);
+
+  // the bucket page followed by its overflow pages
+  std::vector<page_id_t> BucketPages(page_id_t bucket_page_id);
+
+  // insert into the first free slot of a bucket and its overflow pages, with the bucket page latched exclusively
+  InsertResult InsertIntoBucket(page_id_t bucket_page_id, BucketPage *bucket, const KeyType &key,
+                                const ValueType &value);
+
+  // true if a split up to DIRECTORY_MAX_DEPTH separates some pair of the bucket from key
+  bool CanSplit(page_id_t bucket_page_id, uint32_t local_depth, const KeyType &key);
+
+  // allocate an overflow page for a bucket, under the exclusive table latch; the page is returned pinned
+  Page *NewOverflowPage(page_id_t bucket_page_id);
+
+  // write pairs into an emptied bucket from its first slot on, adding overflow pages as it fills up
+  void FillBucket(page_id_t bucket_page_id, BucketPage *bucket, const std::vector<MappingType> &pairs);
+
+  // split the bucket of key until the pair fits, or give it an overflow page, under the exclusive table latch
+  bool SplitInsert(const KeyType &key, const ValueType &value);
+
+  // merge the bucket of key into its split image while it is empty, under the exclusive table latch
+  void Merge(const KeyType &key);
+
+  page_id_t directory_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+
+  // Readers include inserts and removes into existing buckets, writers are splits, merges and new overflow pages
+  ReaderWriterLatch table_latch_;
+
+  // overflow pages by bucket page, changed under the exclusive table latch only
+  std::unordered_map<page_id_t, std::vector<page_id_t>> overflow_;
+
+  // Hash function
+  HashFunction<KeyType> hash_fn_;
+};
+
+}  // namespace bustub
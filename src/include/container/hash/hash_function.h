@@ -14,10 +14,17 @@
 
 #include <cstdint>
 
-#include "murmur3/MurmurHash3.h"
+#include "common/util/hash_util.h"
 
 namespace bustub {
 
+/**
+ * Hash function of the hash tables. The hash is chosen at compile time by the
+ * size of KeyType: keys of up to eight bytes (int, GenericKey<4>,
+ * GenericKey<8>) go through the multiply-shift mixer HashUtil::HashInteger,
+ * longer keys through HashUtil::HashWords. Both spread their bits over the
+ * whole 64-bit hash, whose low bits choose slots and high bits tags.
+ */
 template <typename KeyType>
 class HashFunction {
  public:
@@ -25,12 +32,7 @@ class HashFunction {
    * @param key the key to be hashed
    * @return the hashed value
    */
-  virtual uint64_t GetHash(KeyType key) {
-    uint64_t hash[2];
-    murmur3::MurmurHash3_x64_128(reinterpret_cast<const void *>(&key), static_cast<int>(sizeof(KeyType)), 0,
-                                 reinterpret_cast<void *>(&hash));
-    return hash[0];
-  }
+  virtual uint64_t GetHash(KeyType key) { return HashUtil::HashFixed(key); }
 };
 
 }  // namespace bustub
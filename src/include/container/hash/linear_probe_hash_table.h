@@ -12,11 +12,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>  // NOLINT
 #include <queue>
 #include <string>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
 #include "concurrency/transaction.h"
 #include "container/hash/hash_function.h"
 #include "container/hash/hash_table.h"
@@ -31,7 +34,21 @@ namespace bustub {
 /**
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
- * table dynamically grows once full.
+ * table dynamically grows once three quarters of its slots are occupied.
+ *
+ * Growing is incremental: a resize only allocates the block pages of the new
+ * layout, and every later Insert, Remove and GetValue moves the next
+ * MIGRATE_BATCH_SIZE slots of the old layout over. Until the old layout is
+ * drained, lookups and removes consult both layouts and inserts go to the new
+ * one, so no single operation pays for the whole rebuild.
+ *
+ * Operations take the table latch in shared mode and latch the block pages of
+ * a probe one at a time, in probe order; only starting a resize and dropping
+ * the drained old layout take the table latch exclusively. Migration steps
+ * run under the shared latch too, one at a time: an operation that finds
+ * another one migrating skips its batch instead of waiting. Inserts of the
+ * same key serialize on one of NUM_INSERT_LATCHES mutexes, so that the
+ * duplicate check and the write of the pair happen as one step.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
@@ -75,25 +92,127 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Performs a point query for every key of a batch. Keys whose probes start
+   * in the same block page share one fetch and latch of that page.
+   * @param transaction the current transaction
+   * @param keys the keys to look up
+   * @param[out] results results[i] gets the value(s) associated with keys[i]
+   */
+  void GetValues(Transaction *transaction, const std::vector<KeyType> &keys,
+                 std::vector<std::vector<ValueType>> *results);
+
+  /**
+   * Resizes the table to at least twice the initial size provided. Only the
+   * new block pages are allocated here, the pairs follow incrementally. A
+   * resize still in progress is finished first.
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
 
   /**
    * Gets the size of the hash table
-   * @return current size of the hash table
+   * @return current size of the hash table, the number of slots of the newest layout
    */
   size_t GetSize();
 
+  /**
+   * @return true while pairs of a previous layout remain to be migrated
+   */
+  bool IsResizing();
+
  private:
+  using BlockPage = HashTableBlockPage<KeyType, ValueType, KeyComparator>;
+
+  // result of trying to insert into one layout
+  enum class InsertResult { INSERTED, DUPLICATE, FULL };
+
+  // number of slots of the old layout moved by every operation during a resize
+  static const size_t MIGRATE_BATCH_SIZE = 32;
+  // number of mutexes that inserts are spread over by hash
+  static const size_t NUM_INSERT_LATCHES = 64;
+
+  HashTableHeaderPage *FetchHeaderPage(page_id_t header_page_id);
+
+  // allocate a header page and the block pages for at least num_buckets slots
+  page_id_t NewLayout(size_t num_buckets);
+
+  // take the table latch in shared mode, migrating a batch of slots first during a resize if no one else is
+  void LatchForOperation();
+
+  // fetch a block page and latch it, for writing or for reading
+  Page *FetchBlockPage(page_id_t block_page_id, bool exclusive);
+
+  void ReleaseBlockPage(Page *page, bool exclusive, bool dirty);
+
+  /*
+   * Walk the probe sequence of hash in the layout of header, from the home
+   * slot for at most one lap, latching one block page at a time.
+   * visit(block, offset, slot, &dirty) is called on the readable slots whose
+   * tag matches, on the tombstones if asked for, and on the first free slot,
+   * and returns true to stop the walk.
+   * @return true if visit stopped the walk, false after a full lap
+   */
+  template <typename Visitor>
+  bool Probe(HashTableHeaderPage *header, uint64_t hash, bool exclusive, bool tombstones, Visitor visit);
+
+  /*
+   * The part of a probe inside one latched block page: walk on from *slot
+   * until visit stops the walk, the page ends or *visited reaches size.
+   * @return true if visit stopped the walk
+   */
+  template <typename Visitor>
+  bool ProbeBlock(BlockPage *block, uint8_t tag, size_t size, size_t *slot, size_t *visited, bool tombstones,
+                  bool *dirty, Visitor visit);
+
+  // visitor step of a lookup, true at the end of the probe sequence
+  bool CollectSlot(BlockPage *block, slot_offset_t offset, const KeyType &key, std::vector<ValueType> *result);
+
+  void CollectValues(HashTableHeaderPage *header, const KeyType &key, uint64_t hash, std::vector<ValueType> *result);
+
+  // CollectValues for a batch of keys, each block page is latched once per round
+  void CollectBatch(HashTableHeaderPage *header, const std::vector<KeyType> &keys, const std::vector<uint64_t> &hashes,
+                    std::vector<std::vector<ValueType>> *results);
+
+  bool ContainsPair(HashTableHeaderPage *header, const KeyType &key, uint64_t hash, const ValueType &value);
+
+  InsertResult InsertInto(HashTableHeaderPage *header, const KeyType &key, uint64_t hash, const ValueType &value,
+                          bool check_duplicate);
+
+  bool RemoveFrom(HashTableHeaderPage *header, const KeyType &key, uint64_t hash, const ValueType &value);
+
+  // start a resize to at least 2 * initial_size slots, under the table latch; false if the table cannot grow
+  bool StartResize(size_t initial_size);
+
+  /*
+   * Move up to num_slots slots of the old layout to the current one, under the
+   * table latch in exclusive mode or in shared mode together with migrate_latch_.
+   * @return true if the old layout is drained
+   */
+  bool MigrateSlots(size_t num_slots);
+
+  // give the pages of a drained old layout back, under the table latch in exclusive mode
+  void FinishResize();
+
+  // drop the values of result[mid, end) that result[begin, mid) already holds, which were migrated mid lookup
+  void DropMigrated(std::vector<ValueType> *result, size_t begin, size_t mid);
+
   // member variable
   page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // header of the layout being drained by a resize, INVALID_PAGE_ID otherwise
+  page_id_t old_header_page_id_ = INVALID_PAGE_ID;
+  // next slot of the old layout to migrate
+  size_t migrate_slot_ = 0;
+  // held by the one operation migrating under the shared table latch
+  std::mutex migrate_latch_;
+  // slots of the current layout that were ever occupied, tombstones included
+  std::atomic<size_t> num_occupied_{0};
+
+  // Readers includes inserts, removes and migration steps, writer is only the start and end of a resize
   ReaderWriterLatch table_latch_;
+  std::mutex insert_latches_[NUM_INSERT_LATCHES];
 
   // Hash function
   HashFunction<KeyType> hash_fn_;
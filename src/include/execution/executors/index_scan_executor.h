@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "common/rid.h"
@@ -24,6 +25,14 @@ namespace bustub {
 
 /**
  * IndexScanExecutor executes an index scan over a table.
+ * The (key, RID) pairs are read from the index in batches with ScanRange, so
+ * every leaf is latched once per batch rather than once per tuple. A
+ * comparison of the leading key column with a constant bounds the scanned key
+ * range, and a predicate reading only key columns is evaluated on the keys
+ * while the leaf is latched, before any table tuple is fetched; over a B+
+ * tree, the keys of a large range are then filtered on one thread per core,
+ * in chunks of bounded size. When the index covers every column the plan reads (see Catalog::CreateIndex), the
+ * output is built from the index entries and the table heap is not touched.
  */
 
 class IndexScanExecutor : public AbstractExecutor {
@@ -41,8 +50,24 @@ class IndexScanExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /**
+   * Cursor produces the table tuples of the scan that pass the predicate, in key order. There is one
+   * implementation per index kind and key size, see index_scan_executor.cpp.
+   */
+  class Cursor {
+   public:
+    virtual ~Cursor() = default;
+
+    /** @return false when the scan is over, otherwise the next table tuple and its RID */
+    virtual bool Next(Tuple *tuple, RID *rid) = 0;
+  };
+
  private:
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
+  /** The scanned table. */
+  TableMetadata *table_info_{nullptr};
+  /** Cursor over the scanned index. */
+  std::unique_ptr<Cursor> cursor_;
 };
 }  // namespace bustub
@@ -29,6 +29,12 @@ namespace bustub {
 
 /**
  * IndexJoinExecutor executes index join operations.
+ * The predicate must compare every key column of the inner index for equality
+ * with a column of the outer tuples. Outer tuples are pulled from the child in
+ * batches, and the keys of a whole batch are probed with one Index::ScanKeys
+ * call, which a B+ tree answers with one descent per group of sorted keys
+ * instead of one per outer tuple. The full predicate is evaluated on every
+ * matching inner tuple. The output keeps the order of the outer tuples.
  */
 class NestIndexJoinExecutor : public AbstractExecutor {
  public:
@@ -48,7 +54,28 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   bool Next(Tuple *tuple, RID *rid) override;
 
  private:
+  /** Pull the next batch of outer tuples and probe the index with their keys; false if the child is done. */
+  bool NextBatch();
+
+  /** @return the inner table tuple at rid, with the columns of the inner table schema of the plan */
+  bool GetInnerTuple(RID rid, Tuple *tuple);
+
+  /** Number of outer tuples probed per ScanKeys call. */
+  static constexpr size_t PROBE_BATCH_SIZE = 128;
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
+  /** The child executor that produces the outer tuples. */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The inner table and its probed index. */
+  TableMetadata *inner_table_{nullptr};
+  IndexInfo *index_info_{nullptr};
+  /** For each key column of the index, the outer column it is compared with. */
+  std::vector<uint32_t> outer_key_columns_;
+  /** Current batch of outer tuples, the RIDs of their matches, and the position in them. */
+  std::vector<Tuple> outer_batch_;
+  std::vector<std::vector<RID>> inner_rids_;
+  size_t outer_index_{0};
+  size_t rid_index_{0};
 };
 }  // namespace bustub
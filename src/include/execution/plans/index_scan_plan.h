@@ -28,9 +28,11 @@ class IndexScanPlanNode : public AbstractPlanNode {
    * @param predicate the predicate to scan with, tuples are returned if predicate(tuple) == true or predicate ==
    * nullptr
    * @param table_oid the identifier of table to be scanned
+   * @param parallel whether the scanned key range should be split over several threads
    */
-  IndexScanPlanNode(const Schema *output, const AbstractExpression *predicate, index_oid_t index_oid)
-      : AbstractPlanNode(output, {}), predicate_{predicate}, index_oid_(index_oid) {}
+  IndexScanPlanNode(const Schema *output, const AbstractExpression *predicate, index_oid_t index_oid,
+                    bool parallel = false)
+      : AbstractPlanNode(output, {}), predicate_{predicate}, index_oid_(index_oid), parallel_(parallel) {}
 
   PlanType GetType() const override { return PlanType::IndexScan; }
 
@@ -40,11 +42,16 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** @return the identifier of the table that should be scanned */
   index_oid_t GetIndexOid() const { return index_oid_; }
 
+  /** @return true if the scan should read its key range on several threads */
+  bool IsParallel() const { return parallel_; }
+
  private:
   /** The predicate that all returned tuples must satisfy. */
   const AbstractExpression *predicate_;
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
+  /** Whether the key range is split over several threads. */
+  bool parallel_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree.h
+//
+// Identification: src/include/storage/index/adaptive_radix_tree.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "common/epoch_manager.h"
+#include "common/macros.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+/**
+ * In-memory Adaptive Radix Tree (Leis et al., ICDE 2013) over fixed size,
+ * binary-comparable keys (e.g. normalized GenericKey data), mapping each key
+ * to one or more RIDs.
+ *
+ * (1) every inner node consumes one key byte and adapts its layout to its
+ *     fan-out: Node4 / Node16 (sorted byte arrays, Node16 searched with SSE2),
+ *     Node48 (256 byte index into 48 children), Node256 (direct array);
+ *     nodes grow and shrink between these types as children come and go
+ * (2) path compression: a chain of single-child nodes is collapsed into the
+ *     prefix of the node below it; the first MAX_PREFIX_LEN prefix bytes are
+ *     stored in the node, the rest is read back from any leaf of the subtree
+ * (3) optimistic lock coupling (Leis et al., DaMoN 2016): every inner node
+ *     has a version word; readers never write shared memory, they re-check
+ *     the versions of the nodes they read and restart on a change, writers
+ *     lock only the one or two nodes they modify
+ * (4) leaves are immutable, a changed value list replaces the whole leaf;
+ *     replaced nodes are reclaimed through an EpochManager
+ * The root is a Node256 with an empty prefix that is never replaced.
+ */
+class AdaptiveRadixTree {
+ public:
+  explicit AdaptiveRadixTree(uint32_t key_size);
+  ~AdaptiveRadixTree();
+
+  DISALLOW_COPY_AND_MOVE(AdaptiveRadixTree);
+
+  uint32_t GetKeySize() const { return key_size_; }
+
+  // Add value to the values of key, false if the pair already exists.
+  bool Insert(const uint8_t *key, const RID &value);
+
+  // Remove the pair, false if it does not exist.
+  bool Remove(const uint8_t *key, const RID &value);
+
+  // Append the values of key to result, false if the key does not exist.
+  bool GetValue(const uint8_t *key, std::vector<RID> *result);
+
+  // Call func on the pairs with lo <= key <= hi (nullptr: unbounded) in key order until it returns false.
+  // Concurrent modifications may or may not be seen, but every pair is visited at most once.
+  void Scan(const uint8_t *lo, const uint8_t *hi, const std::function<bool(const uint8_t *, const RID &)> &func);
+
+ private:
+  static constexpr uint32_t MAX_PREFIX_LEN = 8;
+
+  enum class NodeType : uint8_t { LEAF, NODE4, NODE16, NODE48, NODE256 };
+
+  struct Node {
+    explicit Node(NodeType type) : type_(type) {}
+    const NodeType type_;
+  };
+
+  struct Leaf : public Node {
+    Leaf(const uint8_t *key, uint32_t key_size, std::vector<RID> values)
+        : Node(NodeType::LEAF), key_(key, key + key_size), values_(std::move(values)) {}
+    const std::vector<uint8_t> key_;
+    const std::vector<RID> values_;
+  };
+
+  /*
+   * Version word: bit 0 obsolete, bit 1 locked, the rest a counter bumped by
+   * every write unlock.
+   */
+  struct InnerNode : public Node {
+    explicit InnerNode(NodeType type) : Node(type) {}
+    std::atomic<uint64_t> version_{0b100};
+    uint16_t count_{0};
+    uint32_t prefix_len_{0};
+    uint8_t prefix_[MAX_PREFIX_LEN]{};
+  };
+
+  struct Node4 : public InnerNode {
+    Node4() : InnerNode(NodeType::NODE4) {}
+    uint8_t keys_[4]{};
+    Node *children_[4]{};
+  };
+
+  struct Node16 : public InnerNode {
+    Node16() : InnerNode(NodeType::NODE16) {}
+    uint8_t keys_[16]{};
+    Node *children_[16]{};
+  };
+
+  struct Node48 : public InnerNode {
+    static constexpr uint8_t EMPTY = 48;
+    Node48() : InnerNode(NodeType::NODE48) { std::fill(child_index_, child_index_ + 256, EMPTY); }
+    uint8_t child_index_[256];
+    Node *children_[48]{};
+  };
+
+  struct Node256 : public InnerNode {
+    Node256() : InnerNode(NodeType::NODE256) {}
+    Node *children_[256]{};
+  };
+
+  enum class ScanResult { DONE, STOPPED, RESTART };
+
+  /*
+   * optimistic lock coupling, every *OrRestart sets *restart on a conflict;
+   * a descent checks the parent again after reading the version of the child,
+   * since a prefix split or merge in between moves the child to another depth
+   */
+  static uint64_t ReadLockOrRestart(InnerNode *node, bool *restart);
+  static void CheckOrRestart(InnerNode *node, uint64_t version, bool *restart);
+  static void UpgradeToWriteLockOrRestart(InnerNode *node, uint64_t version, bool *restart);
+  static void WriteUnlock(InnerNode *node);
+  static void WriteUnlockObsolete(InnerNode *node);
+
+  /* node layout helpers, the caller holds the write lock of node (or reads it optimistically) */
+  static Node *FindChild(InnerNode *node, uint8_t byte);
+  static bool IsFull(InnerNode *node);
+  // true if removing one child should replace node by a smaller one
+  static bool IsUnderfull(InnerNode *node);
+  static void AddChild(InnerNode *node, uint8_t byte, Node *child);
+  static void ChangeChild(InnerNode *node, uint8_t byte, Node *child);
+  static void RemoveChild(InnerNode *node, uint8_t byte);
+  // children in byte order
+  static void GetChildren(InnerNode *node, std::vector<std::pair<uint8_t, Node *>> *children);
+  // copy of node (prefix and children) with the given layout
+  static InnerNode *Resize(InnerNode *node, NodeType type);
+  static void SetPrefix(InnerNode *node, const uint8_t *prefix, uint32_t prefix_len);
+  // some leaf below node, to read the prefix bytes that are not stored in the nodes; nullptr on a conflict
+  static Leaf *AnyLeaf(Node *node);
+  static void FreeNode(Node *node);
+  static void FreeSubtree(Node *node);
+
+  // one attempt of each operation, the public methods repeat them until *restart stays false
+  bool InsertAttempt(const uint8_t *key, const RID &value, bool *restart);
+  bool RemoveAttempt(const uint8_t *key, const RID &value, bool *restart);
+  bool GetValueAttempt(const uint8_t *key, std::vector<RID> *result, bool *restart);
+  // scan the subtree of node, which covers keys starting with the first depth bytes of lo if tight
+  ScanResult ScanNode(InnerNode *node, InnerNode *parent, uint64_t parent_version, uint32_t depth, bool tight,
+                      const uint8_t *lo, bool lo_inclusive, const uint8_t *hi,
+                      const std::function<bool(const uint8_t *, const RID &)> &func, std::vector<uint8_t> *last_key);
+
+  void Retire(Node *node);
+
+  uint32_t key_size_;
+  Node256 *root_;
+  EpochManager epoch_manager_;
+};
+
+}  // namespace bustub
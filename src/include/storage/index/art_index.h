@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index.h
+//
+// Identification: src/include/storage/index/art_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/index/adaptive_radix_tree.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+#define ART_INDEX_TYPE ARTIndex<KeyType, ValueType, KeyComparator>
+
+/**
+ * In-memory index on an AdaptiveRadixTree. The tree is keyed by the raw
+ * GenericKey bytes, so range scans follow the key order only for schemas
+ * whose keys are normalized (see GenericKey::IsNormalizable); point lookups
+ * work for every schema. Nothing is stored in the buffer pool, the index is
+ * rebuilt from the table like every catalog object.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ARTIndex : public Index {
+ public:
+  // the buffer pool manager is unused, it keeps the constructor interchangeable with BPlusTreeIndex
+  ARTIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager);
+
+  ~ARTIndex() override = default;
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  // call func on the entries with lo <= key <= hi (nullptr: unbounded) in key order, until it returns false
+  void ScanRange(const KeyType *lo, const KeyType *hi, const std::function<bool(const KeyType &, const RID &)> &func);
+
+ protected:
+  // container
+  AdaptiveRadixTree container_;
+};
+
+}  // namespace bustub
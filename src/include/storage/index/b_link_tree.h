@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/index/b_link_tree.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "concurrency/transaction.h"
+#include "storage/index/index_iterator.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+#define BLINKTREE_TYPE BLinkTree<KeyType, ValueType, KeyComparator>
+
+/**
+ * B-link tree (Lehman & Yao) built on the same pages as BPlusTree.
+ *
+ * Every page carries a right link (NextPageId) and a high key, the upper bound
+ * of the keys it may hold. A page that was split concurrently is detected by
+ * comparing the search key with the high key and simply following the right
+ * link, so a descent holds at most one page latch at a time:
+ * (1) readers and writers never couple latches on the way down
+ * (2) a split releases the child before latching the parent
+ * (3) remove only deletes from the leaf, pages are never merged or freed,
+ *     which is what keeps a stale page id safe to follow
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BLinkTree {
+  using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  explicit BLinkTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+
+  // Returns true if this tree has no pages yet.
+  bool IsEmpty() const;
+
+  // Insert a key-value pair into this tree.
+  bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // Remove a key and its value from this tree.
+  void Remove(const KeyType &key, Transaction *transaction = nullptr);
+
+  // return the value associated with a given key
+  bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
+
+  // index iterator, follows the right links of the leaves
+  INDEXITERATOR_TYPE begin();
+  INDEXITERATOR_TYPE Begin(const KeyType &key);
+
+ private:
+  Page *FetchPage(page_id_t page_id);
+
+  // descend to the leaf responsible for key, moving right past concurrent splits
+  Page *FindLeafPage(const KeyType &key, bool leftMost, bool exclusive, std::vector<page_id_t> *path);
+
+  void StartNewTree(const KeyType &key, const ValueType &value);
+
+  void InsertIntoParent(std::vector<page_id_t> *path, page_id_t left_id, const KeyType &key, page_id_t right_id,
+                        int level);
+
+  void UpdateRootPageId(int insert_record = 0);
+
+  // member variable
+  std::string index_name_;
+  std::atomic<page_id_t> root_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  int leaf_max_size_;
+  int internal_max_size_;
+  // only taken to create the first page or a new root
+  std::mutex root_latch_;
+};
+
+}  // namespace bustub
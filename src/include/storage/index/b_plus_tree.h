@@ -10,30 +10,58 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <functional>
 #include <queue>
 #include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
 #include <vector>
 
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_posting_page.h"
 
 namespace bustub {
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 // 并发控制有关acewzj:
-enum class Operation { READONLY = 0, INSERT, DELETE };
+// COMPACT: merging an underfull leaf found by the compactor, crabbing like an inline DELETE
+enum class Operation { READONLY = 0, INSERT, DELETE, COMPACT };
+
+/**
+ * Shape of a BPlusTree, see BPlusTree::GetStats().
+ */
+struct BPlusTreeStats {
+  // number of levels, 0 for an empty tree
+  int height_{0};
+  // pages per level, leaves first and the root last
+  std::vector<size_t> level_pages_;
+  // keys in the leaves (a duplicate key with a posting list counts once)
+  size_t leaf_entries_{0};
+  // average page size over max size
+  double leaf_fill_factor_{0};
+  double internal_fill_factor_{0};
+};
 
 /**
  * Main class providing the API for the Interactive B+ Tree.
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique by default; a non-unique tree stores the values of a
+ *     duplicate key once per key, in an inline list of its leaf or, past
+ *     BPlusTreeLeafPage::INLINE_LIST_SIZE values, in a posting list (see
+ *     BPlusTreePostingPage)
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ * (5) With deferred merge, remove only deletes from the leaf and marks it if it
+ *     is underfull; the marked leaves are merged or rebalanced later by
+ *     Compact(), e.g. from the background compactor thread
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -42,7 +70,10 @@ class BPlusTree {
 
  public:
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     bool unique = true);
+
+  ~BPlusTree();
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
@@ -50,15 +81,60 @@ class BPlusTree {
   // Insert a key-value pair into this B+ tree.
   bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
-  // Remove a key and its value from this B+ tree.
+  // Remove a key and its value(s) from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
-  // return the value associated with a given key
+  // Remove a single key-value pair, other values of a duplicate key are kept.
+  void Remove(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // Defer merging underfull leaves to Compact(), set before the tree is used concurrently.
+  void SetDeferredMerge(bool deferred_merge) { deferred_merge_ = deferred_merge; }
+
+  // Merge or rebalance up to max_leaves marked underfull leaves, one at a time; returns the number handled.
+  int Compact(int max_leaves);
+
+  // Number of leaves waiting for Compact().
+  size_t GetUnderfullLeafCount();
+
+  // Run Compact(leaves_per_round) every interval on a background thread, until StopCompactor().
+  void StartCompactor(std::chrono::milliseconds interval, int leaves_per_round);
+  void StopCompactor();
+
+  // Build an empty tree bottom-up from pairs sorted by key, filling pages to fill_factor.
+  bool BulkLoad(typename std::vector<MappingType>::const_iterator first,
+                typename std::vector<MappingType>::const_iterator last, double fill_factor = 1.0,
+                Transaction *transaction = nullptr);
+
+  // return the value(s) associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
 
+  // batched point queries, results[i] gets the value(s) of keys[i]; returns the number of keys found
+  int GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                Transaction *transaction = nullptr);
+
+  // copy up to max_batch pairs of a key range into out_batch, one read latch per leaf; true if more may follow
+  bool ScanRange(const KeyType *lo, bool lo_inclusive, const KeyType *hi, bool hi_inclusive,
+                 const std::function<bool(const KeyType &)> &filter, std::vector<MappingType> *out_batch,
+                 size_t max_batch);
+
+  // split [lo, hi] into at most partitions key ranges of similar size, returns the keys starting ranges 2..n
+  std::vector<KeyType> GetPartitionKeys(const KeyType *lo, const KeyType *hi, int partitions);
+
+  // scan [lo, hi] with one worker thread per partition, func(partition, pair) is called from the workers
+  int ParallelScan(const KeyType *lo, const KeyType *hi, int partitions,
+                   const std::function<void(int, const MappingType &)> &func);
+
+  // height, pages per level and fill factors, kept up to date by split and merge
+  BPlusTreeStats GetStats() const;
+
+  // estimate buckets equi-depth bucket bounds from sample_leaves randomly chosen leaves
+  std::vector<KeyType> SampleHistogram(int buckets, int sample_leaves);
+
   // index iterator
   INDEXITERATOR_TYPE begin();
   INDEXITERATOR_TYPE Begin(const KeyType &key);
+  // reverse iterator from the last key <= key, towards smaller keys
+  INDEXITERATOR_TYPE RBegin(const KeyType &key);
   INDEXITERATOR_TYPE end();
 
   void Print(BufferPoolManager *bpm) {
@@ -82,28 +158,49 @@ class BPlusTree {
   B_PLUS_TREE_LEAF_PAGE_TYPE *FindLeafPage(const KeyType &key, bool leftMost = false, Operation op = Operation::READONLY, Transaction *transaction = nullptr);
 
  private:
+  // read-latch descent that write-latches only the leaf; nullptr means retry pessimistically
+  B_PLUS_TREE_LEAF_PAGE_TYPE *FindLeafPageOptimistic(const KeyType &key, Operation op, Transaction *transaction);
+
+  // fetch and read-latch the current root, retrying if it changes meanwhile; nullptr for an empty tree
+  Page *FetchRootForRead(const char *caller);
+
   void StartNewTree(const KeyType &key, const ValueType &value);
 
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
+  // append a key past the current maximum to the hinted right-most leaf, false means insert normally
+  bool InsertIntoRightmostLeaf(const KeyType &key, const ValueType &value);
+
+  // add value to key already in leaf, turning its value into a list if needed
+  bool InsertIntoPostingList(LeafPage *leaf, const KeyType &key, const ValueType &value);
+
+  // value == nullptr removes the key with all its values
+  void RemoveEntry(const KeyType &key, const ValueType *value, Transaction *transaction);
+
+  // level is the level of old_node, 0 for a leaf
   void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
-                        Transaction *transaction = nullptr);
+                        Transaction *transaction = nullptr, int level = 0);
 
   template <typename N>
-  N *Split(N *node);
+  N *Split(N *node, bool append = false);
 
   template <typename N>
-  bool CoalesceOrRedistribute(N *node, Transaction *transaction = nullptr);
+  bool CoalesceOrRedistribute(N *node, Transaction *transaction = nullptr, int level = 0);
 
   template <typename N>
   bool Coalesce(N *neighbor_node, N *node, BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *parent,
-                int index, Transaction *transaction = nullptr);
+                int index, Transaction *transaction = nullptr, int level = 0);
 
   template <typename N>
   void Redistribute(N *neighbor_node, N *node, int index);
 
   bool AdjustRoot(BPlusTreePage *node);
 
+  void SetLeafPrevPageId(page_id_t page_id, page_id_t prev_page_id);
+
+  // remember an underfull leaf for Compact(), key is any key routing to it
+  void MarkUnderfullLeaf(page_id_t page_id, const KeyType &key);
+
   void UpdateRootPageId(int insert_record = 0);
 
   /* Debug Routines for FREE!! */
@@ -125,6 +222,20 @@ class BPlusTree {
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  bool unique_;
+  // the right-most leaf, or INVALID_PAGE_ID; only changed under that leaf's write latch
+  std::atomic<page_id_t> rightmost_leaf_hint_{INVALID_PAGE_ID};
+  bool deferred_merge_{false};
+  // underfull leaves waiting for Compact(), with a key routing to each
+  std::unordered_map<page_id_t, KeyType> underfull_leaves_;
+  std::mutex underfull_leaves_mutex_;
+  std::atomic<bool> enable_compactor_{false};
+  std::thread *compactor_thread_{nullptr};
+  // statistics for GetStats(), changed next to the structure changes they count
+  static const int MAX_HEIGHT = 64;
+  std::atomic<int> height_{0};
+  std::atomic<size_t> level_pages_[MAX_HEIGHT]{};
+  std::atomic<size_t> leaf_entries_{0};
   //acewzj:
   static thread_local bool root_is_locked;
   std::mutex mutex_; 
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
@@ -33,6 +34,24 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  // walks the tree once per group of sorted keys, see BPlusTree::GetValues
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *result,
+                Transaction *transaction) override;
+
+  // batched range scan over the container, see BPlusTree::ScanRange
+  bool ScanRange(const KeyType *lo, bool lo_inclusive, const KeyType *hi, bool hi_inclusive,
+                 const std::function<bool(const KeyType &)> &filter, std::vector<MappingType> *out_batch,
+                 size_t max_batch);
+
+  // keys splitting a range of the container into partitions of similar size, see BPlusTree::GetPartitionKeys
+  std::vector<KeyType> GetPartitionKeys(const KeyType *lo, const KeyType *hi, int partitions);
+
+  // height, pages per level and fill factors of the container, see BPlusTree::GetStats
+  BPlusTreeStats GetStats() const;
+
+  // sampled equi-depth histogram of the keys, see BPlusTree::SampleHistogram
+  std::vector<KeyType> SampleHistogram(int buckets, int sample_leaves);
+
   INDEXITERATOR_TYPE GetBeginIterator();
 
   INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
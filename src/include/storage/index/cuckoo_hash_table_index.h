@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cuckoo_hash_table_index.h
+//
+// Identification: src/include/storage/index/cuckoo_hash_table_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "container/hash/cuckoo_hash_table.h"
+#include "container/hash/hash_function.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+#define CUCKOO_HASH_TABLE_INDEX_TYPE CuckooHashTableIndex<KeyType, ValueType, KeyComparator>
+
+/**
+ * Point lookup index on a CuckooHashTable. A lookup reads at most two block
+ * pages whatever the load; num_buckets is only the initial size, the table
+ * doubles when its buckets and stash run out of room.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class CuckooHashTableIndex : public Index {
+ public:
+  CuckooHashTableIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager, size_t num_buckets,
+                       const HashFunction<KeyType> &hash_fn);
+
+  ~CuckooHashTableIndex() override = default;
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+ protected:
+  // comparator for key
+  KeyComparator comparator_;
+  // container
+  CuckooHashTable<KeyType, ValueType, KeyComparator> container_;
+};
+
+}  // namespace bustub
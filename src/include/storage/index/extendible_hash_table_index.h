@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_index.h
+//
+// Identification: src/include/storage/index/extendible_hash_table_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "container/hash/extendible_hash_table.h"
+#include "container/hash/hash_function.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+#define EXTENDIBLE_HASH_TABLE_INDEX_TYPE ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>
+
+/**
+ * Point lookup index on an ExtendibleHashTable. Unlike
+ * LinearProbeHashTableIndex it needs no bucket count up front: the table
+ * grows one bucket split at a time.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ExtendibleHashTableIndex : public Index {
+ public:
+  ExtendibleHashTableIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager,
+                           const HashFunction<KeyType> &hash_fn);
+
+  ~ExtendibleHashTableIndex() override = default;
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+ protected:
+  // comparator for key
+  KeyComparator comparator_;
+  // container
+  ExtendibleHashTable<KeyType, ValueType, KeyComparator> container_;
+};
+
+}  // namespace bustub
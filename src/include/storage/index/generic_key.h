@@ -12,8 +12,16 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "catalog/schema.h"
+#include "common/exception.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -25,20 +33,71 @@ namespace bustub {
  * This key type uses an fixed length array to hold data for indexing
  * purposes, the actual size of which is specified and instantiated
  * with a template argument.
+ *
+ * When every key column is fixed size (see IsNormalizable()), each column is
+ * stored in an order-preserving normalized form instead of its tuple form:
+ * integers big-endian with the sign bit flipped, timestamps big-endian,
+ * decimals with the usual IEEE-754 bit flip. The NULL sentinels of these
+ * types are their smallest (largest for timestamps) values, so NULLs order
+ * consistently too. Two such keys compare with a single memcmp, and
+ * GenericComparator uses that instead of deserializing Values.
  */
 template <size_t KeySize>
 class GenericKey {
  public:
-  inline void SetFromKey(const Tuple &tuple) {
+  // Returns true if keys of this schema are stored normalized
+  static bool IsNormalizable(const Schema *key_schema) {
+    return key_schema->IsInlined() && key_schema->GetLength() <= KeySize;
+  }
+
+  inline void SetFromKey(const Tuple &tuple, const Schema *key_schema) {
     // intialize to 0
     memset(data_, 0, KeySize);
-    memcpy(data_, tuple.GetData(), tuple.GetLength());
+    if (!IsNormalizable(key_schema)) {
+      memcpy(data_, tuple.GetData(), tuple.GetLength());
+      return;
+    }
+    for (const auto &col : key_schema->GetColumns()) {
+      EncodeColumn(tuple.GetData() + col.GetOffset(), col.GetType(), data_ + col.GetOffset());
+    }
+  }
+
+  // Covering indexes keep the included columns of one tuple of the key at the
+  // end of the key bytes, after the RID of that tuple; GenericComparator never
+  // reads them. The RID tells whether the columns belong to a given entry.
+  static uint32_t PayloadSize(const Schema *include_schema) {
+    return sizeof(int64_t) + include_schema->GetLength();
+  }
+
+  inline void SetPayload(RID owner, const char *included, const Schema *include_schema) {
+    char *payload = data_ + KeySize - PayloadSize(include_schema);
+    int64_t owner_bits = owner.Get();
+    memcpy(payload, &owner_bits, sizeof(owner_bits));
+    memcpy(payload + sizeof(owner_bits), included, include_schema->GetLength());
+  }
+
+  inline bool PayloadOwnedBy(RID rid, const Schema *include_schema) const {
+    int64_t owner_bits;
+    memcpy(&owner_bits, data_ + KeySize - PayloadSize(include_schema), sizeof(owner_bits));
+    return owner_bits == rid.Get();
+  }
+
+  inline Value PayloadValue(const Schema *include_schema, uint32_t column_idx) const {
+    const auto &col = include_schema->GetColumn(column_idx);
+    return Value::DeserializeFrom(data_ + KeySize - include_schema->GetLength() + col.GetOffset(), col.GetType());
   }
 
   // NOTE: for test purpose only
+  // the key schema is assumed to be a single bigint column, or a single
+  // integer column for keys shorter than 8 bytes
   inline void SetFromInteger(int64_t key) {
     memset(data_, 0, KeySize);
-    memcpy(data_, &key, sizeof(int64_t));
+    if (KeySize >= sizeof(int64_t)) {
+      EncodeColumn(reinterpret_cast<const char *>(&key), TypeId::BIGINT, data_);
+    } else {
+      auto small_key = static_cast<int32_t>(key);
+      EncodeColumn(reinterpret_cast<const char *>(&small_key), TypeId::INTEGER, data_);
+    }
   }
 
   inline Value ToValue(Schema *schema, uint32_t column_idx) const {
@@ -52,12 +111,27 @@ class GenericKey {
       int32_t offset = *reinterpret_cast<int32_t *>(const_cast<char *>(data_ + col.GetOffset()));
       data_ptr = (data_ + offset);
     }
+    if (IsNormalizable(schema)) {
+      char buf[sizeof(uint64_t)];
+      DecodeColumn(data_ptr, column_type, buf);
+      return Value::DeserializeFrom(buf, column_type);
+    }
     return Value::DeserializeFrom(data_ptr, column_type);
   }
 
   // NOTE: for test purpose only
   // interpret the first 8 bytes as int64_t from data vector
-  inline int64_t ToString() const { return *reinterpret_cast<int64_t *>(const_cast<char *>(data_)); }
+  inline int64_t ToString() const {
+    int64_t key = 0;
+    if (KeySize >= sizeof(int64_t)) {
+      DecodeColumn(data_, TypeId::BIGINT, reinterpret_cast<char *>(&key));
+    } else {
+      int32_t small_key = 0;
+      DecodeColumn(data_, TypeId::INTEGER, reinterpret_cast<char *>(&small_key));
+      key = small_key;
+    }
+    return key;
+  }
 
   // NOTE: for test purpose only
   // interpret the first 8 bytes as int64_t from data vector
@@ -68,6 +142,59 @@ class GenericKey {
 
   // actual location of data, extends past the end.
   char data_[KeySize];
+
+ private:
+  static constexpr uint64_t SIGN_BIT = 1ULL << 63;
+
+  // map a fixed size column value to an unsigned integer with the same order,
+  // left aligned in 64 bits
+  static uint64_t OrderedBits(const char *src, TypeId type) {
+    switch (type) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return (static_cast<uint64_t>(*reinterpret_cast<const uint8_t *>(src)) << 56) ^ SIGN_BIT;
+      case TypeId::SMALLINT:
+        return (static_cast<uint64_t>(*reinterpret_cast<const uint16_t *>(src)) << 48) ^ SIGN_BIT;
+      case TypeId::INTEGER:
+        return (static_cast<uint64_t>(*reinterpret_cast<const uint32_t *>(src)) << 32) ^ SIGN_BIT;
+      case TypeId::BIGINT:
+        return *reinterpret_cast<const uint64_t *>(src) ^ SIGN_BIT;
+      case TypeId::TIMESTAMP:
+        return *reinterpret_cast<const uint64_t *>(src);
+      case TypeId::DECIMAL: {
+        double value = *reinterpret_cast<const double *>(src);
+        // -0.0 == 0.0
+        value = value == 0 ? 0 : value;
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return (bits & SIGN_BIT) != 0 ? ~bits : bits | SIGN_BIT;
+      }
+      default:
+        throw Exception(ExceptionType::UNKNOWN_TYPE, "GenericKey: column type cannot be normalized");
+    }
+  }
+
+  static void EncodeColumn(const char *src, TypeId type, char *dst) {
+    uint64_t bits = OrderedBits(src, type);
+    for (uint32_t i = 0; i < Type::GetTypeSize(type); i++) {
+      dst[i] = static_cast<char>(bits >> (56 - 8 * i));
+    }
+  }
+
+  static void DecodeColumn(const char *src, TypeId type, char *dst) {
+    uint32_t size = Type::GetTypeSize(type);
+    uint64_t bits = 0;
+    for (uint32_t i = 0; i < size; i++) {
+      bits |= static_cast<uint64_t>(static_cast<uint8_t>(src[i])) << (56 - 8 * i);
+    }
+    if (type == TypeId::DECIMAL) {
+      bits = (bits & SIGN_BIT) != 0 ? bits ^ SIGN_BIT : ~bits;
+    } else if (type != TypeId::TIMESTAMP) {
+      bits ^= SIGN_BIT;
+    }
+    bits >>= 64 - 8 * size;
+    memcpy(dst, &bits, size);
+  }
 };
 
 /**
@@ -77,6 +204,10 @@ template <size_t KeySize>
 class GenericComparator {
  public:
   inline int operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const {
+    if (normalized_) {
+      int cmp = memcmp(lhs.data_, rhs.data_, key_length_);
+      return (cmp > 0) - (cmp < 0);
+    }
     uint32_t column_count = key_schema_->GetColumnCount();
 
     for (uint32_t i = 0; i < column_count; i++) {
@@ -94,13 +225,75 @@ class GenericComparator {
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  // keys left after a binary search narrowed the range, that CountLess() compares in one go
+  static const int SCAN_WINDOW = 8;
+
+  /*
+   * Normalized keys of at most 8 bytes compare like the unsigned integer of
+   * their key bytes read big-endian, see ToInteger(). B+ tree pages search
+   * such keys with integer compares and CountLess() instead of memcmp.
+   */
+  inline bool IsIntegerComparable() const { return normalized_ && KeySize <= sizeof(uint64_t); }
+
+  inline uint64_t ToInteger(const GenericKey<KeySize> &key) const {
+    uint64_t bits = 0;
+    memcpy(&bits, key.data_, std::min(KeySize, sizeof(bits)));
+    // the bytes after the key columns end up lowest and are shifted out
+    return __builtin_bswap64(bits) >> (64 - 8 * key_length_);
+  }
+
+  /*
+   * Counts the keys among the count ones laid out stride bytes apart from
+   * first that are less than (or_equal: not greater than) the key whose
+   * ToInteger() is target. With AVX2, four keys are gathered, byte swapped
+   * and compared at a time; 8 bytes are loaded per key, so stride must be at
+   * least 8. Only for IsIntegerComparable() keys.
+   */
+  inline int CountLess(const GenericKey<KeySize> *first, size_t stride, int count, uint64_t target,
+                       bool or_equal) const {
+    const auto *bytes = reinterpret_cast<const char *>(first);
+    int less = 0;
+    int i = 0;
+#if defined(__AVX2__)
+    const __m256i swap = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1,
+                                          0, 15, 14, 13, 12, 11, 10, 9, 8);
+    const __m128i shift = _mm_cvtsi32_si128(64 - 8 * static_cast<int>(key_length_));
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    // signed compares on the flipped sign bit order like unsigned ones
+    const __m256i bound = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(target)), sign);
+    const auto step = static_cast<int64_t>(stride);
+    const __m256i offsets = _mm256_setr_epi64x(0, step, 2 * step, 3 * step);
+    for (; i + 4 <= count; i += 4) {
+      __m256i keys = _mm256_i64gather_epi64(reinterpret_cast<const long long *>(bytes + i * stride),  // NOLINT
+                                            offsets, 1);
+      keys = _mm256_xor_si256(_mm256_srl_epi64(_mm256_shuffle_epi8(keys, swap), shift), sign);
+      __m256i cmp = or_equal ? _mm256_cmpgt_epi64(keys, bound) : _mm256_cmpgt_epi64(bound, keys);
+      int mask = _mm256_movemask_pd(_mm256_castsi256_pd(cmp));
+      less += or_equal ? 4 - __builtin_popcount(mask) : __builtin_popcount(mask);
+    }
+#endif
+    for (; i < count; i++) {
+      uint64_t key = ToInteger(*reinterpret_cast<const GenericKey<KeySize> *>(bytes + i * stride));
+      less += (or_equal ? key <= target : key < target) ? 1 : 0;
+    }
+    return less;
+  }
+
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_}, normalized_{other.normalized_}, key_length_{other.key_length_} {}
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  explicit GenericComparator(Schema *key_schema)
+      : key_schema_(key_schema),
+        normalized_(GenericKey<KeySize>::IsNormalizable(key_schema)),
+        key_length_(key_schema->GetLength()) {}
 
  private:
   Schema *key_schema_;
+  // keys of this schema are normalized, compare them bytewise
+  bool normalized_;
+  // bytes of the key columns, anything after them (e.g. a covering payload) is not compared
+  uint32_t key_length_;
 };
 
 }  // namespace bustub
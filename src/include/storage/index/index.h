@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -36,13 +37,29 @@ class IndexMetadata {
  public:
   IndexMetadata() = delete;
 
+  /**
+   * A covering index also stores the include_attrs columns in its entries.
+   * They are not part of the search key: the key schema (and the comparator
+   * built from it) only has the key_attrs columns, while the entry schema has
+   * the key columns followed by the included ones.
+   */
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
-      : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
+                std::vector<uint32_t> key_attrs, std::vector<uint32_t> include_attrs = {})
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        include_attrs_(std::move(include_attrs)),
+        entry_attrs_(ConcatAttrs(key_attrs_, include_attrs_)) {
     key_schema_ = Schema::CopySchema(tuple_schema, key_attrs_);
+    include_schema_ = Schema::CopySchema(tuple_schema, include_attrs_);
+    entry_schema_ = Schema::CopySchema(tuple_schema, entry_attrs_);
   }
 
-  ~IndexMetadata() { delete key_schema_; }
+  ~IndexMetadata() {
+    delete key_schema_;
+    delete include_schema_;
+    delete entry_schema_;
+  }
 
   inline const std::string &GetName() const { return name_; }
 
@@ -51,15 +68,37 @@ class IndexMetadata {
   // Returns a schema object pointer that represents the indexed key
   inline Schema *GetKeySchema() const { return key_schema_; }
 
+  // Returns the schema of the included columns, empty unless the index is covering
+  inline Schema *GetIncludeSchema() const { return include_schema_; }
+
+  // Returns the schema of the tuples passed to Index::InsertEntry(): the key columns, then the included ones
+  inline Schema *GetEntrySchema() const { return entry_schema_; }
+
   // Return the number of columns inside index key (not in tuple key)
   // Note that this must be defined inside the cpp source file
   // because it uses the member of catalog::Schema which is not known here
   uint32_t GetIndexColumnCount() const { return static_cast<uint32_t>(key_attrs_.size()); }
 
+  // Return the number of included (non-key) columns stored in the entries
+  uint32_t GetIncludeColumnCount() const { return static_cast<uint32_t>(include_attrs_.size()); }
+
+  // Returns true if every base table column in column_attrs is stored in the index entries
+  bool Covers(const std::vector<uint32_t> &column_attrs) const {
+    return std::all_of(column_attrs.begin(), column_attrs.end(), [this](uint32_t attr) {
+      return std::find(entry_attrs_.begin(), entry_attrs_.end(), attr) != entry_attrs_.end();
+    });
+  }
+
   //  Returns the mapping relation between indexed columns  and base table
   //  columns
   inline const std::vector<uint32_t> &GetKeyAttrs() const { return key_attrs_; }
 
+  // Returns the base table columns of the included columns
+  inline const std::vector<uint32_t> &GetIncludeAttrs() const { return include_attrs_; }
+
+  // Returns the base table columns of the entry schema
+  inline const std::vector<uint32_t> &GetEntryAttrs() const { return entry_attrs_; }
+
   // Get a string representation for debugging
   std::string ToString() const {
     std::stringstream os;
@@ -74,12 +113,26 @@ class IndexMetadata {
   }
 
  private:
+  static std::vector<uint32_t> ConcatAttrs(std::vector<uint32_t> key_attrs,
+                                           const std::vector<uint32_t> &include_attrs) {
+    key_attrs.insert(key_attrs.end(), include_attrs.begin(), include_attrs.end());
+    return key_attrs;
+  }
+
   std::string name_;
   std::string table_name_;
   // The mapping relation between key schema and tuple schema
   const std::vector<uint32_t> key_attrs_;
+  // table columns stored in the entries but not searched on
+  const std::vector<uint32_t> include_attrs_;
+  // key_attrs_ followed by include_attrs_
+  const std::vector<uint32_t> entry_attrs_;
   // schema of the indexed key
   Schema *key_schema_;
+  // schema of the included columns
+  Schema *include_schema_;
+  // schema of the key and included columns
+  Schema *entry_schema_;
 };
 
 /////////////////////////////////////////////////////////////////////
@@ -117,6 +170,12 @@ class Index {
 
   const std::vector<uint32_t> &GetKeyAttrs() const { return metadata_->GetKeyAttrs(); }
 
+  Schema *GetEntrySchema() const { return metadata_->GetEntrySchema(); }
+
+  const std::vector<uint32_t> &GetEntryAttrs() const { return metadata_->GetEntryAttrs(); }
+
+  bool Covers(const std::vector<uint32_t> &column_attrs) const { return metadata_->Covers(column_attrs); }
+
   // Get a string representation for debugging
   std::string ToString() const {
     std::stringstream os;
@@ -130,6 +189,7 @@ class Index {
   // Point Modification
   ///////////////////////////////////////////////////////////////////
   // designed for secondary indexes.
+  // key is a tuple of the entry schema, which is the key schema unless the index has included columns
   virtual void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) = 0;
 
   // delete the index entry linked to given tuple
@@ -137,6 +197,15 @@ class Index {
 
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  // batched ScanKey for many probes (e.g. index nested loop join), result[i] gets the RIDs of keys[i]
+  virtual void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *result,
+                        Transaction *transaction) {
+    result->assign(keys.size(), std::vector<RID>());
+    for (size_t i = 0; i < keys.size(); i++) {
+      ScanKey(keys[i], &(*result)[i], transaction);
+    }
+  }
+
  private:
   //===--------------------------------------------------------------------===//
   //  Data members
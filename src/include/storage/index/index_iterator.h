@@ -13,7 +13,11 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <functional>
+#include <vector>
+
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_posting_page.h"
 
 namespace bustub {
 
@@ -22,9 +26,15 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
  public:
+  // returns the read latched leaf holding the pairs just before key, and the index of the last of them
+  using FindBeforeFunc = std::function<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *(const KeyType &, int *)>;
+
   // you may define your own constructor based on your member variables
   IndexIterator(BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *,
                 int, BufferPoolManager *);
+  // reverse iterator from the last pair <= key, moves towards smaller keys
+  IndexIterator(BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *leaf, int index,
+                BufferPoolManager *buff_pool_manager, FindBeforeFunc find_before, const KeyType &key);
   ~IndexIterator();
 
   bool isEnd();
@@ -38,10 +48,22 @@ class IndexIterator {
   bool operator!=(const IndexIterator &itr) const { throw std::runtime_error("unimplemented"); }
 
  private:
+  void SkipExhaustedLeaves();
+  void SkipExhaustedLeavesReverse();
+  void LoadItem();
+  void ReleaseLeaf();
+
   // add your own private member variables here
   BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *leaf_;
   int index_;
   BufferPoolManager *buff_pool_manager_;  
+  // copy of the current item, with one value of a posting list
+  MappingType item_;
+  std::vector<ValueType> postings_;
+  size_t posting_index_{0};
+  // set for reverse iterators
+  bool reverse_{false};
+  FindBeforeFunc find_before_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// skip_list.h
+//
+// Identification: src/include/storage/index/skip_list.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/epoch_manager.h"
+#include "common/macros.h"
+#include "storage/index/generic_key.h"
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define SKIPLIST_TYPE SkipList<KeyType, ValueType, KeyComparator>
+#define SKIPLIST_ITERATOR_TYPE SkipListIterator<KeyType, ValueType, KeyComparator>
+
+INDEX_TEMPLATE_ARGUMENTS
+class SkipList;
+
+/*
+ * A skip list node: one pair and a tower of height_ next pointers. The lowest
+ * bit of a next pointer marks the node as removed at that level.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+struct SkipListNode {
+  MappingType item_;
+  uint32_t height_;
+  // height_ entries, allocated past the end of the struct
+  std::atomic<uintptr_t> next_[1];
+};
+
+/**
+ * Forward iterator over a SkipList in key order, with the interface of
+ * IndexIterator. It stays in an epoch of the list while it is alive, so the
+ * node it is on is never freed under it; pairs removed after the iterator
+ * passed them, or inserted before its position, may be missed.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class SkipListIterator {
+  using Node = SkipListNode<KeyType, ValueType, KeyComparator>;
+
+ public:
+  SkipListIterator(Node *node, std::unique_ptr<EpochManager::Guard> guard);
+
+  bool isEnd() { return node_ == nullptr; }  // NOLINT
+
+  const MappingType &operator*() { return node_->item_; }
+
+  SkipListIterator &operator++();
+
+ private:
+  Node *node_;
+  std::unique_ptr<EpochManager::Guard> guard_;
+};
+
+/**
+ * Lock-free skip list (Herlihy & Shavit, "The Art of Multiprocessor
+ * Programming", ch. 14) of (key, value) pairs ordered by key, then value, so
+ * that a key may have several values:
+ * (1) insert links the new node bottom-up with CAS, one level at a time
+ * (2) remove first marks the next pointers of the node top-down (logical
+ *     delete, the bottom mark decides which remover wins), then searches for
+ *     it, which unlinks marked nodes on the way (physical delete)
+ * (3) lookups and iteration never write, they step over marked nodes
+ * (4) unlinked nodes are freed through an EpochManager
+ * There are no latches and no structure modification like a B+ tree split:
+ * writers only contend on the few pointers next to their own pair.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class SkipList {
+  using Node = SkipListNode<KeyType, ValueType, KeyComparator>;
+  static const uint32_t MAX_HEIGHT = 16;
+
+ public:
+  explicit SkipList(const KeyComparator &comparator);
+  ~SkipList();
+
+  DISALLOW_COPY_AND_MOVE(SkipList);
+
+  // Insert the pair, false if it already exists.
+  bool Insert(const KeyType &key, const ValueType &value);
+
+  // Remove the pair, false if it does not exist.
+  bool Remove(const KeyType &key, const ValueType &value);
+
+  // Append the values of key to result, false if there are none.
+  bool GetValue(const KeyType &key, std::vector<ValueType> *result);
+
+  SKIPLIST_ITERATOR_TYPE Begin();
+  // iterator from the first pair whose key is >= key
+  SKIPLIST_ITERATOR_TYPE Begin(const KeyType &key);
+  SKIPLIST_ITERATOR_TYPE End();
+
+ private:
+  static Node *Ptr(uintptr_t next) { return reinterpret_cast<Node *>(next & ~static_cast<uintptr_t>(1)); }
+  static bool IsMarked(uintptr_t next) { return (next & 1) != 0; }
+  static Node *NewNode(const MappingType &item, uint32_t height);
+  static void FreeNode(void *node);
+
+  static uint32_t RandomHeight();
+  int Compare(const MappingType &lhs, const MappingType &rhs) const;
+  // fill preds and succs with the neighbours of item at each level, unlinking marked nodes on the way;
+  // true if succs[0] holds item
+  bool Find(const MappingType &item, Node **preds, Node **succs);
+  // first node whose key is >= key, marked or not
+  Node *LowerBound(const KeyType &key) const;
+
+  KeyComparator comparator_;
+  Node *head_;
+  EpochManager epoch_manager_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// skip_list_index.h
+//
+// Identification: src/include/storage/index/skip_list_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/index/index.h"
+#include "storage/index/skip_list.h"
+
+namespace bustub {
+
+#define SKIPLIST_INDEX_TYPE SkipListIndex<KeyType, ValueType, KeyComparator>
+
+/**
+ * In-memory ordered index on a lock-free SkipList, for write-heavy secondary
+ * indexes: concurrent writers never latch, and nothing is stored in the
+ * buffer pool.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class SkipListIndex : public Index {
+ public:
+  // the buffer pool manager is unused, it keeps the constructor interchangeable with BPlusTreeIndex
+  SkipListIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager);
+
+  ~SkipListIndex() override = default;
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  SKIPLIST_ITERATOR_TYPE GetBeginIterator();
+
+  SKIPLIST_ITERATOR_TYPE GetBeginIterator(const KeyType &key);
+
+  SKIPLIST_ITERATOR_TYPE GetEndIterator();
+
+ protected:
+  // comparator for key
+  KeyComparator comparator_;
+  // container
+  SkipList<KeyType, ValueType, KeyComparator> container_;
+};
+
+}  // namespace bustub
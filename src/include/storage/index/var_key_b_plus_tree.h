@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/index/var_key_b_plus_tree.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <functional>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+#include "concurrency/transaction.h"
+#include "storage/page/b_plus_tree_slotted_page.h"
+
+namespace bustub {
+
+/**
+ * B+ tree over variable length keys (byte strings, compared bytewise), built
+ * on slotted pages (see BPlusTreeSlottedPage) instead of the fixed size
+ * GenericKey arrays of BPlusTree:
+ * (1) keys are unique, at most SLOTTED_PAGE_MAX_KEY_SIZE bytes
+ * (2) pages split by free space, so short keys give a much higher fan-out
+ * (3) head-prefix compression within every page, and leaf splits post the
+ *     shortest separator between the two halves (suffix truncation)
+ * (4) like BLinkTree, remove only deletes from the leaf, pages are never
+ *     merged
+ * Pages are latched by crabbing, as in BPlusTree. Lookups, scans, removes and
+ * inserts that fit in their leaf read latch the internal pages on the way down
+ * and latch only the leaf for writing. An insert that splits its leaf starts
+ * over and write latches the path, releasing the ancestors of every page that
+ * has room for one more entry of the largest key size; the root latch is held
+ * as long as the root may split.
+ */
+class VarKeyBPlusTree {
+  using LeafPage = BPlusTreeSlottedPage<RID>;
+  using InternalPage = BPlusTreeSlottedPage<page_id_t>;
+
+ public:
+  explicit VarKeyBPlusTree(std::string name, BufferPoolManager *buffer_pool_manager);
+
+  // Returns true if this tree has no pages yet.
+  bool IsEmpty() const;
+
+  // Insert a key-value pair, false if the key exists or is too long.
+  bool Insert(const std::string &key, const RID &value, Transaction *transaction = nullptr);
+
+  // Remove a key and its value from this tree.
+  void Remove(const std::string &key, Transaction *transaction = nullptr);
+
+  // return the value associated with a given key
+  bool GetValue(const std::string &key, std::vector<RID> *result, Transaction *transaction = nullptr);
+
+  // call func on the pairs with key >= lo in key order, until it returns false
+  void Scan(const std::string &lo, const std::function<bool(const std::string &, const RID &)> &func,
+            Transaction *transaction = nullptr);
+
+ private:
+  Page *FetchPage(page_id_t page_id);
+
+  // fetch and read latch the root page, nullptr if the tree is empty
+  Page *FetchRootForRead();
+
+  // crab down to the leaf responsible for key and return it read latched (write latched if exclusive), nullptr if
+  // the tree is empty
+  Page *FindLeafPage(const std::string &key, bool exclusive);
+
+  // insert with the path write latched, for an insert that may split pages
+  bool InsertPessimistic(const std::string &key, const RID &value);
+
+  // write unlatch and unpin the pages
+  void ReleasePages(std::vector<Page *> *pages, bool is_dirty);
+
+  void StartNewTree(const std::string &key, const RID &value);
+
+  void InsertIntoParent(BPlusTreePage *old_node, const std::string &key, BPlusTreePage *new_node);
+
+  void UpdateRootPageId(int insert_record = 0);
+
+  // member variable
+  std::string index_name_;
+  page_id_t root_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  // held by an insert while the root may split, which changes root_page_id_
+  std::mutex root_latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// var_key_b_plus_tree_index.h
+//
+// Identification: src/include/storage/index/var_key_b_plus_tree_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/index/index.h"
+#include "storage/index/var_key_b_plus_tree.h"
+
+namespace bustub {
+
+/**
+ * Index on a VarKeyBPlusTree, for keys made of VARCHAR columns. The key
+ * columns are encoded into one byte string that compares bytewise in key
+ * order: per column a 0x00 byte for NULL, or 0x01, the characters with 0x00
+ * escaped as 0x00 0xff, and a 0x00 0x00 terminator. The RID is appended to
+ * the encoded key, which makes the tree keys unique while several tuples
+ * share a key; the entries of a key are the tree keys starting with it.
+ */
+class VarKeyBPlusTreeIndex : public Index {
+ public:
+  VarKeyBPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager);
+
+  ~VarKeyBPlusTreeIndex() override = default;
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  // call func on the entries whose encoded key (RID included) is >= lo in key order, until it returns false
+  void Scan(const std::string &lo, const std::function<bool(const std::string &, const RID &)> &func,
+            Transaction *transaction);
+
+  // whether every column of key_schema can be encoded, i.e. is a VARCHAR
+  static bool SupportsKeySchema(const Schema *key_schema);
+
+ protected:
+  // the encoded key of a key schema tuple
+  std::string EncodeKey(const Tuple &key) const;
+
+  // the tree key of an entry: the encoded key followed by the RID
+  std::string EncodeEntry(const Tuple &key, RID rid) const;
+
+  // container
+  VarKeyBPlusTree container_;
+};
+
+}  // namespace bustub
@@ -17,7 +17,7 @@
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 24
+#define INTERNAL_PAGE_HEADER_SIZE (28 + sizeof(KeyType))
 #define INTERNAL_PAGE_SIZE ((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
@@ -31,6 +31,10 @@ namespace bustub {
  *  --------------------------------------------------------------------------
  * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
  *  --------------------------------------------------------------------------
+ *
+ * HEADER is the common b+ tree page header followed by NextPageId (4) and
+ * HighKey (KeyType), the B-link right link and upper bound of this page. Both
+ * are only maintained by BLinkTree; BPlusTree leaves NextPageId invalid.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
@@ -41,12 +45,21 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   KeyType KeyAt(int index) const;
   void SetKeyAt(int index, const KeyType &key);
   int ValueIndex(const ValueType &value) const;
+  int ValueIndex(const ValueType &value, const KeyType &key, const KeyComparator &comparator) const;
+  int ChildIndex(const KeyType &key, const KeyComparator &comparator) const;
   ValueType ValueAt(int index) const;
   void SetValueAt(int index, const ValueType &value);
+
+  // B-link right link and high key
+  page_id_t GetNextPageId() const;
+  void SetNextPageId(page_id_t next_page_id);
+  KeyType GetHighKey() const;
+  void SetHighKey(const KeyType &key);
   
   ValueType Lookup(const KeyType &key, const KeyComparator &comparator) const;
   void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
   int InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+  int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
   void Remove(int index);
   ValueType RemoveAndReturnOnlyChild();
 
@@ -60,6 +73,8 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   void CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager);
   void CopyLastFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
   void CopyFirstFrom(const MappingType &pair, int parent_index, BufferPoolManager *buffer_pool_manager);
+  page_id_t next_page_id_;
+  KeyType high_key_;
   MappingType array[0];
 };
 }  // namespace bustub
@@ -18,26 +18,34 @@
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 28
+#define LEAF_PAGE_HEADER_SIZE (36 + sizeof(KeyType))
 #define LEAF_PAGE_SIZE ((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
- * page. Only support unique key.
+ * page. Keys are unique within the page. The value of a duplicate key in a
+ * non-unique tree refers to an inline list of up to INLINE_LIST_SIZE RIDs,
+ * kept at the end of the page, or to a posting list once it outgrows that or
+ * the page runs out of room (see b_plus_tree_posting_page.h).
  *
- * Leaf page format (keys are stored in order):
- *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
- *  ----------------------------------------------------------------------
+ * Leaf page format (keys are stored in order, inline lists grow downwards):
+ *  ---------------------------------------------------------------------------------------------
+ * | HEADER | KEY(1) + RID(1) | ... | KEY(n) + RID(n) | FREE | LIST(m - 1) | ... | LIST(0) |
+ *  ---------------------------------------------------------------------------------------------
  *
- *  Header format (size in byte, 28 bytes in total):
+ *  Header format (size in byte, 36 + sizeof(KeyType) bytes in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
- *  -----------------------------------------------
- * | ParentPageId (4) | PageId (4) | NextPageId (4)
- *  -----------------------------------------------
+ *  ------------------------------------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | PrevPageId (4) | NumLists (4) | HighKey (KeyType)
+ *  ------------------------------------------------------------------------------------------------
+ *
+ * PrevPageId links the leaves backwards for reverse scans; only BPlusTree
+ * maintains it.
+ * HighKey is the B-link upper bound of the keys this page may hold. It is only
+ * meaningful when NextPageId is valid, and only BLinkTree maintains it.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
@@ -48,9 +56,40 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   // helper methods
   page_id_t GetNextPageId() const;
   void SetNextPageId(page_id_t next_page_id);
+  page_id_t GetPrevPageId() const;
+  void SetPrevPageId(page_id_t prev_page_id);
+  KeyType GetHighKey() const;
+  void SetHighKey(const KeyType &key);
   KeyType KeyAt(int index) const;
+  // replace the key at index with one comparing equal to it, see BPlusTree::InsertIntoPostingList
+  void SetKeyAt(int index, const KeyType &key);
   int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
   const MappingType &GetItem(int index);
+  void SetValueAt(int index, const ValueType &value);
+
+  /*
+   * Values of a duplicate key (non-unique BPlusTree only), see the page format
+   * above. The split and merge methods move inline lists along with their
+   * entries, spilling them to posting lists where the recipient has no room.
+   */
+  static constexpr int INLINE_LIST_SIZE = 8;
+  // slot number marking a value as the index of an inline list
+  static constexpr uint32_t INLINE_LIST_SLOT = UINT32_MAX - 1;
+  static bool IsInlineList(const ValueType &value) { return value.GetSlotNum() == INLINE_LIST_SLOT; }
+  // true if value stands for a list of values rather than for itself
+  static bool IsList(const ValueType &value);
+  // append the values value stands for to values
+  void GetValues(const ValueType &value, std::vector<ValueType> *values, BufferPoolManager *buffer_pool_manager) const;
+  // add value to the values of the entry at index; false if it is already there
+  bool InsertValue(int index, const ValueType &value, BufferPoolManager *buffer_pool_manager);
+  // remove value from the list of the entry at index, which keeps at least one value; false if it is not there
+  bool RemoveValue(int index, const ValueType &value, BufferPoolManager *buffer_pool_manager);
+  // drop the posting list of the entry at index before the entry is removed
+  void DeleteValues(int index, BufferPoolManager *buffer_pool_manager);
+  // true if one more entry fits next to the inline lists, otherwise the page is full
+  bool HasRoomForEntry() const { return Fits(GetSize() + 1, num_lists_); }
+  // spill inline lists to posting lists until count more entries fit
+  void MakeRoomForEntries(int count, BufferPoolManager *buffer_pool_manager);
 
   // insert and delete methods
   int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
@@ -67,7 +106,29 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   void CopyNFrom(MappingType *items, int size);
   void CopyLastFrom(const MappingType &item);
   void CopyFirstFrom(const MappingType &item, int parent_index, BufferPoolManager *buffer_pool_manager);
+
+  struct InlineList {
+    int size_;
+    ValueType values_[INLINE_LIST_SIZE];
+  };
+  InlineList *ListAt(int list_index);
+  const InlineList *ListAt(int list_index) const;
+  // true if the page holds size entries and num_lists inline lists
+  bool Fits(int size, int num_lists) const;
+  // store sorted values in a new inline list, or in a posting list if the page has no room
+  ValueType NewList(const std::vector<ValueType> &values, BufferPoolManager *buffer_pool_manager);
+  void DeleteInlineList(int list_index);
+  // move the inline list of the entry at index to a posting list
+  void SpillInlineList(int index, BufferPoolManager *buffer_pool_manager);
+  // copy the inline lists of the entries [begin, begin + count), just copied from donor, into this page
+  void AdoptLists(const BPlusTreeLeafPage *donor, int begin, int count, BufferPoolManager *buffer_pool_manager);
+  // drop the inline lists no entry refers to any more, after entries moved to another page
+  void CompactLists();
+
   page_id_t next_page_id_;
+  page_id_t prev_page_id_;
+  int num_lists_;
+  KeyType high_key_;
   MappingType array[0];
 };
 }  // namespace bustub
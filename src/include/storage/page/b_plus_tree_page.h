@@ -70,7 +70,6 @@ class BPlusTreePage {
   int max_size_;
   page_id_t parent_page_id_;
   page_id_t page_id_;
-  std::mutex mutex_;
 };
 
 }  // namespace bustub
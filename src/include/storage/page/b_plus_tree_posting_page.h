@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_plus_tree_posting_page.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+#define POSTING_PAGE_HEADER_SIZE 24
+#define POSTING_PAGE_DATA_SIZE (PAGE_SIZE - POSTING_PAGE_HEADER_SIZE)
+
+/**
+ * Overflow page holding the RIDs of a duplicate key in a non-unique b+ tree.
+ *
+ * A key with more RIDs than its leaf keeps inline (see BPlusTreeLeafPage)
+ * keeps a single leaf entry whose value is PostingListRid(head page id). The RIDs themselves live in a chain of
+ * posting pages, sorted; every page holds a disjoint run of the list, and the
+ * runs increase along the chain. Within a page the RIDs (as 64 bit page id |
+ * slot) are delta encoded as varints, so dense RIDs take 1-2 bytes each.
+ *
+ * Posting pages are only accessed while holding the latch of the leaf that
+ * points to them, so they are not latched themselves.
+ *
+ * Posting page format:
+ *  --------------------------------------------------------------------------
+ * | HEADER | VARINT(RID(1)) | VARINT(RID(2) - RID(1)) | ... | VARINT(RID(n) - RID(n-1))
+ *  --------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 24 bytes in total):
+ *  --------------------------------------------------------------------------
+ * | NextPageId (4) | Size (4) | ListSize (4) | BytesUsed (4) | LastRid (8) |
+ *  --------------------------------------------------------------------------
+ *  ListSize is the size of the whole list and is only kept on the head page.
+ */
+class BPlusTreePostingPage {
+ public:
+  // slot number marking a leaf value as the head of a posting list
+  static constexpr uint32_t POSTING_LIST_SLOT = UINT32_MAX;
+
+  static RID PostingListRid(page_id_t head_page_id) { return RID(head_page_id, POSTING_LIST_SLOT); }
+  static bool IsPostingList(const RID &rid) { return rid.GetSlotNum() == POSTING_LIST_SLOT; }
+  // the order of the RIDs in a list: by page id, then slot
+  static bool RidLess(const RID &lhs, const RID &rhs);
+
+  void Init();
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+  int GetSize() const { return size_; }
+
+  // append the RIDs of this page to rids
+  void GetRids(std::vector<RID> *rids) const;
+  // replace the content of this page with the first count of rids, returns how many fit
+  int SetRids(const RID *rids, int count);
+
+  /*
+   * Posting list (page chain) operations, head_page_id is the first page
+   */
+  static page_id_t CreateList(BufferPoolManager *buffer_pool_manager, const RID &first, const RID &second);
+  // create a list of at least two distinct rids
+  static page_id_t CreateList(BufferPoolManager *buffer_pool_manager, const std::vector<RID> &rids);
+  // return false if rid is already in the list
+  static bool InsertIntoList(BufferPoolManager *buffer_pool_manager, page_id_t head_page_id, const RID &rid);
+  // return false if rid is not in the list
+  static bool RemoveFromList(BufferPoolManager *buffer_pool_manager, page_id_t head_page_id, const RID &rid);
+  static void GetListRids(BufferPoolManager *buffer_pool_manager, page_id_t head_page_id, std::vector<RID> *rids);
+  static int GetListSize(BufferPoolManager *buffer_pool_manager, page_id_t head_page_id);
+  static void DeleteList(BufferPoolManager *buffer_pool_manager, page_id_t head_page_id);
+
+ private:
+  static BPlusTreePostingPage *FetchPostingPage(BufferPoolManager *buffer_pool_manager, page_id_t page_id);
+  static BPlusTreePostingPage *NewPostingPage(BufferPoolManager *buffer_pool_manager, page_id_t *page_id);
+  // find the page whose run covers rid (or the last page), prev_page_id is its predecessor
+  static page_id_t FindPage(BufferPoolManager *buffer_pool_manager, page_id_t head_page_id, const RID &rid,
+                            page_id_t *prev_page_id);
+
+  page_id_t next_page_id_;
+  int size_;
+  int list_size_;
+  int bytes_used_;
+  uint64_t last_rid_;
+  uint8_t data_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_plus_tree_slotted_page.h
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define SLOTTED_PAGE_HEADER_SIZE 32
+#define SLOTTED_PAGE_DATA_SIZE (PAGE_SIZE - SLOTTED_PAGE_HEADER_SIZE)
+// the largest key a slotted page accepts, small enough that a split always leaves room in both halves
+#define SLOTTED_PAGE_MAX_KEY_SIZE (SLOTTED_PAGE_DATA_SIZE / 4 - 16)
+
+/**
+ * Leaf (ValueType = RID) or internal (ValueType = page_id_t) page of a
+ * VarKeyBPlusTree, holding variable length byte string keys in key order.
+ *
+ * Head-prefix compression: the longest prefix shared by all keys of the page
+ * is stored once, and every entry only keeps the rest of its key (its suffix).
+ * The prefix is recomputed whenever the page is rebuilt (split, compaction);
+ * a key that does not start with the current prefix forces a rebuild.
+ * As in BPlusTreeInternalPage, the key of the first internal entry is unused
+ * (empty) and does not take part in the prefix.
+ *
+ * Slotted page format: the slot array grows forward after the prefix, the
+ * entries (value followed by key suffix) grow backward from the end of the
+ * page (the slot array is 2 byte aligned, after a padding byte if the prefix
+ * size is odd). Removed entries leave holes reclaimed by the next rebuild.
+ *  ---------------------------------------------------------------------------------
+ * | HEADER | PREFIX | SLOT(1) | ... | SLOT(n) | free | ENTRY(n) | ... | ENTRY(1) |
+ *  ---------------------------------------------------------------------------------
+ *  SLOT: | EntryOffset (2) | SuffixSize (2) |   ENTRY: | VALUE | SUFFIX |
+ *
+ *  Header format (size in byte, 32 bytes in total):
+ *  ---------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ *  ---------------------------------------------------------------------
+ *  -------------------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | PrefixSize (2) | DataStart (2) |
+ *  -------------------------------------------------------------------------------
+ */
+template <typename ValueType>
+class BPlusTreeSlottedPage : public BPlusTreePage {
+ public:
+  using Entry = std::pair<std::string, ValueType>;
+
+  // must call initialize method after "create" a new node
+  void Init(page_id_t page_id, page_id_t parent_id, IndexPageType page_type);
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+  std::string_view GetPrefix() const { return std::string_view(data_, prefix_size_); }
+  // bytes left between the slot array and the entries
+  int FreeSpace() const;
+
+  // whether any entry with a key of at most key_size bytes can be inserted, even one that drops the prefix
+  bool HasRoomFor(size_t key_size) const;
+
+  std::string KeyAt(int index) const;
+  ValueType ValueAt(int index) const;
+  void SetValueAt(int index, const ValueType &value);
+
+  // first index i (of the keyed entries) so that KeyAt(i) >= key
+  int KeyIndex(std::string_view key) const;
+  // internal page: index of the child whose subtree contains key
+  int ChildIndex(std::string_view key) const;
+  // internal page: index of the entry pointing to value
+  int ValueIndex(const ValueType &value) const;
+
+  // insert key & value as entry index, return false if the page cannot hold it
+  bool Insert(int index, const std::string &key, const ValueType &value);
+  void Remove(int index);
+
+  // copy out all entries with their full keys
+  void GetEntries(std::vector<Entry> *entries) const;
+  // replace the content of the page, recomputing the prefix; return false if the entries do not fit
+  bool SetEntries(typename std::vector<Entry>::const_iterator first,
+                  typename std::vector<Entry>::const_iterator last);
+  // index at which to split entries over two leaf (or internal) pages so both fit with the closest byte sizes,
+  // -1 if no split fits
+  static int SplitIndex(const std::vector<Entry> &entries, bool leaf);
+
+ private:
+  struct Slot {
+    uint16_t offset_;
+    uint16_t suffix_size_;
+  };
+
+  // index of the first entry with a key: 0 for leaves, 1 for internal pages
+  int FirstKeyIndex() const { return IsLeafPage() ? 0 : 1; }
+  // the slot array starts at the first 2 byte boundary after the prefix
+  static size_t SlotArrayOffset(size_t prefix_size) { return (prefix_size + 1) & ~static_cast<size_t>(1); }
+  Slot *Slots() { return reinterpret_cast<Slot *>(data_ + SlotArrayOffset(prefix_size_)); }
+  const Slot *Slots() const { return reinterpret_cast<const Slot *>(data_ + SlotArrayOffset(prefix_size_)); }
+  std::string_view SuffixAt(int index) const;
+  // first keyed index whose key is >= key (or > key if upper)
+  int Bound(std::string_view key, bool upper) const;
+
+  page_id_t next_page_id_;
+  uint16_t prefix_size_;
+  uint16_t data_start_;
+  char data_[0];
+};
+
+}  // namespace bustub
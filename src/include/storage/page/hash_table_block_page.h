@@ -27,18 +27,32 @@ namespace bustub {
  *
  * Block page format (keys are stored in order):
  *  ----------------------------------------------------------------
+ * | OCCUPIED | READABLE | TAG(1) ... TAG(n) | padding
+ *  ----------------------------------------------------------------
  * | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
  *  ----------------------------------------------------------------
  *
  *  Here '+' means concatenation.
  *
+ * Every slot keeps a one byte tag of its key's hash next to the bitmaps, so a
+ * probe compares TAG_GROUP_SIZE tags at once with SIMD and only looks at the
+ * keys whose tag matches.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBlockPage {
  public:
+  // number of slots MatchTag, OccupiedMask and ReadableMask cover at once
+  static const slot_offset_t TAG_GROUP_SIZE = 32;
+
   // Delete all constructor / destructor to ensure memory safety
   HashTableBlockPage() = delete;
 
+  /**
+   * @return the tag stored for a key with the given hash; taken from the high
+   * bits, which choose the slot the least
+   */
+  static uint8_t HashTag(uint64_t hash) { return static_cast<uint8_t>(hash >> 56); }
+
   /**
    * Gets the key at an index in the block.
    *
@@ -57,18 +71,17 @@ class HashTableBlockPage {
 
   /**
    * Attempts to insert a key and value into an index in the block.
-   * The insert is thread safe. It uses compare and swap to claim the index,
-   * and then writes the key and value into the index, and then marks the
-   * index as readable.
+   * A tombstone is reused like a brand new index. Callers hold the write latch
+   * of the block's page, so the index cannot be claimed concurrently.
    *
    * @param bucket_ind index to write the key and value to
    * @param key key to insert
    * @param value value to insert
+   * @param tag HashTag of the key's hash, for MatchTag
    * @return If the value is inserted successfully, it returns true. If the
-   * index is marked as occupied before the key and value can be inserted,
-   * Insert returns false.
+   * index already holds a readable key and value pair, Insert returns false.
    */
-  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value);
+  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value, uint8_t tag = 0);
 
   /**
    * Removes a key and value at index.
@@ -93,11 +106,44 @@ class HashTableBlockPage {
    */
   bool IsReadable(slot_offset_t bucket_ind) const;
 
+  /**
+   * Compares the tags of the TAG_GROUP_SIZE indexes from bucket_ind on with
+   * tag. Bits past the end of the block are garbage, callers mask them off.
+   *
+   * @param bucket_ind first index to look at
+   * @param tag tag to look for
+   * @return bit i set if index bucket_ind + i holds tag, readable or not
+   */
+  uint32_t MatchTag(slot_offset_t bucket_ind, uint8_t tag) const;
+
+  /**
+   * @param bucket_ind first index to look at
+   * @return bit i set if index bucket_ind + i is occupied, for TAG_GROUP_SIZE indexes
+   */
+  uint32_t OccupiedMask(slot_offset_t bucket_ind) const;
+
+  /**
+   * @param bucket_ind first index to look at
+   * @return bit i set if index bucket_ind + i is readable, for TAG_GROUP_SIZE indexes
+   */
+  uint32_t ReadableMask(slot_offset_t bucket_ind) const;
+
+  /**
+   * Starts loading the tags of the group at bucket_ind and the pair at
+   * bucket_ind into the cache, without waiting for them.
+   *
+   * @param bucket_ind first index a probe will look at
+   */
+  void Prefetch(slot_offset_t bucket_ind) const;
+
  private:
   std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
 
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
   std::atomic_char readable_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+
+  // padded so that a group load from the last index stays inside the array
+  uint8_t tags_[BLOCK_ARRAY_SIZE + TAG_GROUP_SIZE - 1];
   MappingType array_[0];
 };
 
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.h
+//
+// Identification: src/include/storage/page/hash_table_directory_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#include "common/config.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/**
+ * Directory Page for extendible hash table.
+ *
+ * Directory format (size in byte):
+ * --------------------------------------------------------------------------------------------
+ * | PageId (4) | LSN (4) | GlobalDepth (4) | LocalDepths (512) | BucketPageIds (2048) | Free (1524)
+ * --------------------------------------------------------------------------------------------
+ *
+ * Slot i of the directory points to the bucket of the keys whose hash ends in
+ * the GlobalDepth low bits of i. A bucket of local depth d is shared by the
+ * 2^(GlobalDepth - d) slots that agree on the d low bits.
+ */
+class HashTableDirectoryPage {
+ public:
+  page_id_t GetPageId() const { return page_id_; }
+
+  void SetPageId(page_id_t page_id) { page_id_ = page_id; }
+
+  lsn_t GetLSN() const { return lsn_; }
+
+  void SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+  /**
+   * @return the number of slots in use, 2^GlobalDepth
+   */
+  uint32_t Size() const { return 1U << global_depth_; }
+
+  uint32_t GetGlobalDepth() const { return global_depth_; }
+
+  /**
+   * @return the mask of the GlobalDepth low bits, applied to a hash to get its slot
+   */
+  uint32_t GetGlobalDepthMask() const { return Size() - 1; }
+
+  /**
+   * Doubles the directory: the slots of the new upper half are copies of the
+   * lower half, so every key still finds its bucket.
+   */
+  void IncrGlobalDepth();
+
+  /**
+   * Halves the directory, only valid if CanShrink().
+   */
+  void DecrGlobalDepth() { global_depth_--; }
+
+  /**
+   * @return true if no bucket has a local depth equal to the global depth
+   */
+  bool CanShrink() const;
+
+  page_id_t GetBucketPageId(uint32_t bucket_idx) const { return bucket_page_ids_[bucket_idx]; }
+
+  void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) { bucket_page_ids_[bucket_idx] = bucket_page_id; }
+
+  uint32_t GetLocalDepth(uint32_t bucket_idx) const { return local_depths_[bucket_idx]; }
+
+  void SetLocalDepth(uint32_t bucket_idx, uint8_t local_depth) { local_depths_[bucket_idx] = local_depth; }
+
+  /**
+   * @return the slot that differs from bucket_idx only in the highest bit of
+   * its bucket's local depth: where the bucket splits to, or merges from
+   */
+  uint32_t GetSplitImageIndex(uint32_t bucket_idx) const {
+    assert(local_depths_[bucket_idx] > 0);
+    return bucket_idx ^ (1U << (local_depths_[bucket_idx] - 1));
+  }
+
+ private:
+  page_id_t page_id_;
+  lsn_t lsn_;
+  uint32_t global_depth_{0};
+  uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+};
+
+}  // namespace bustub
@@ -14,11 +14,21 @@
 
 #define MappingType std::pair<KeyType, ValueType>
 
-/** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in   * a block page. It is an approximate
+/** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in a block page. It is an approximate
  * calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType). For each key/value
- * pair, we need two additional bits for occupied_ and readable_. 4 * PAGE_SIZE / (4 * sizeof (MappingType) + 1) =
- * PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required to maintain the occupied
- * and readable flags for a key value pair.*/
-#define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+ * pair, we need a one byte hash tag and two additional bits for occupied_ and readable_, so a pair takes
+ * sizeof (MappingType) + 1.25 bytes. BLOCK_TAG_PADDING bytes of the page are kept back for the padding of the tag
+ * array, which SIMD loads may read past its last slot, and for the alignment of the pairs after it.*/
+#define BLOCK_TAG_PADDING 64
+#define BLOCK_ARRAY_SIZE (4 * (PAGE_SIZE - BLOCK_TAG_PADDING) / (4 * sizeof(MappingType) + 5))
+
+/** DIRECTORY_ARRAY_SIZE is the number of bucket slots of an extendible hash table directory, so that the local depths
+ * (1 byte each) and bucket page ids (4 bytes each) fit one page. It caps the global depth at 9.*/
+#define DIRECTORY_ARRAY_SIZE 512
+#define DIRECTORY_MAX_DEPTH 9
+
+/** HEADER_ARRAY_SIZE is the number of block page ids a linear probing hash table header page holds after its 32 bytes
+ * of lsn, size, page id and next block index. It bounds the number of slots to HEADER_ARRAY_SIZE * BLOCK_ARRAY_SIZE.*/
+#define HEADER_ARRAY_SIZE ((PAGE_SIZE - 32) / sizeof(page_id_t))
 
 #define HASH_TABLE_BLOCK_TYPE HashTableBlockPage<KeyType, ValueType, KeyComparator>
@@ -0,0 +1,859 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree.cpp
+//
+// Identification: src/storage/index/adaptive_radix_tree.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/adaptive_radix_tree.h"
+
+#include <cstring>
+#include <thread>  // NOLINT
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace bustub {
+
+namespace {
+
+/*
+ * Node16 search: compare the byte with all 16 keys at once.
+ * @return : the index of byte among the first count keys, -1 if absent
+ */
+int FindByte16(const uint8_t *keys, int count, uint8_t byte) {
+#ifdef __SSE2__
+  __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                               _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys)));
+  unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(cmp)) & ((1U << count) - 1);
+  return mask != 0 ? __builtin_ctz(mask) : -1;
+#else
+  for (int i = 0; i < count; i++) {
+    if (keys[i] == byte) {
+      return i;
+    }
+  }
+  return -1;
+#endif
+}
+
+/*
+ * Node16 insert position: the number of keys smaller than byte. SSE2 only has
+ * a signed byte comparison, so both sides get their sign bit flipped first.
+ */
+int LowerBound16(const uint8_t *keys, int count, uint8_t byte) {
+#ifdef __SSE2__
+  __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+  __m128i cmp = _mm_cmplt_epi8(_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys)), bias),
+                               _mm_xor_si128(_mm_set1_epi8(static_cast<char>(byte)), bias));
+  unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(cmp)) & ((1U << count) - 1);
+  return __builtin_popcount(mask);
+#else
+  int pos = 0;
+  while (pos < count && keys[pos] < byte) {
+    pos++;
+  }
+  return pos;
+#endif
+}
+
+}  // namespace
+
+AdaptiveRadixTree::AdaptiveRadixTree(uint32_t key_size) : key_size_(key_size), root_(new Node256()) {}
+
+AdaptiveRadixTree::~AdaptiveRadixTree() { FreeSubtree(root_); }
+
+/*****************************************************************************
+ * OPTIMISTIC LOCK COUPLING
+ *****************************************************************************/
+uint64_t AdaptiveRadixTree::ReadLockOrRestart(InnerNode *node, bool *restart) {
+  uint64_t version = node->version_.load();
+  if ((version & 0b11) != 0) {
+    // locked or obsolete
+    *restart = true;
+  }
+  return version;
+}
+
+void AdaptiveRadixTree::CheckOrRestart(InnerNode *node, uint64_t version, bool *restart) {
+  if (node->version_.load() != version) {
+    *restart = true;
+  }
+}
+
+void AdaptiveRadixTree::UpgradeToWriteLockOrRestart(InnerNode *node, uint64_t version, bool *restart) {
+  if (!node->version_.compare_exchange_strong(version, version + 0b10)) {
+    *restart = true;
+  }
+}
+
+void AdaptiveRadixTree::WriteUnlock(InnerNode *node) { node->version_.fetch_add(0b10); }
+
+void AdaptiveRadixTree::WriteUnlockObsolete(InnerNode *node) { node->version_.fetch_add(0b11); }
+
+/*****************************************************************************
+ * NODE LAYOUTS
+ *****************************************************************************/
+AdaptiveRadixTree::Node *AdaptiveRadixTree::FindChild(InnerNode *node, uint8_t byte) {
+  switch (node->type_) {
+    case NodeType::NODE4: {
+      auto *n = static_cast<Node4 *>(node);
+      for (int i = 0; i < n->count_ && i < 4; i++) {
+        if (n->keys_[i] == byte) {
+          return n->children_[i];
+        }
+      }
+      return nullptr;
+    }
+    case NodeType::NODE16: {
+      auto *n = static_cast<Node16 *>(node);
+      int pos = FindByte16(n->keys_, std::min<int>(n->count_, 16), byte);
+      return pos < 0 ? nullptr : n->children_[pos];
+    }
+    case NodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node);
+      uint8_t index = n->child_index_[byte];
+      return index == Node48::EMPTY ? nullptr : n->children_[index];
+    }
+    case NodeType::NODE256:
+      return static_cast<Node256 *>(node)->children_[byte];
+    default:
+      return nullptr;
+  }
+}
+
+bool AdaptiveRadixTree::IsFull(InnerNode *node) {
+  switch (node->type_) {
+    case NodeType::NODE4:
+      return node->count_ == 4;
+    case NodeType::NODE16:
+      return node->count_ == 16;
+    case NodeType::NODE48:
+      return node->count_ == 48;
+    default:
+      return false;
+  }
+}
+
+bool AdaptiveRadixTree::IsUnderfull(InnerNode *node) {
+  switch (node->type_) {
+    case NodeType::NODE4:
+      return node->count_ <= 2;
+    case NodeType::NODE16:
+      return node->count_ <= 4;
+    case NodeType::NODE48:
+      return node->count_ <= 13;
+    default:
+      return node->count_ <= 38;
+  }
+}
+
+/*
+ * Children are written before the keys (or index) that make them visible, so
+ * that an optimistic reader never follows a stale slot; every move is done
+ * slot by slot.
+ */
+void AdaptiveRadixTree::AddChild(InnerNode *node, uint8_t byte, Node *child) {
+  switch (node->type_) {
+    case NodeType::NODE4: {
+      auto *n = static_cast<Node4 *>(node);
+      int pos = 0;
+      while (pos < n->count_ && n->keys_[pos] < byte) {
+        pos++;
+      }
+      std::copy_backward(n->keys_ + pos, n->keys_ + n->count_, n->keys_ + n->count_ + 1);
+      std::copy_backward(n->children_ + pos, n->children_ + n->count_, n->children_ + n->count_ + 1);
+      n->keys_[pos] = byte;
+      n->children_[pos] = child;
+      break;
+    }
+    case NodeType::NODE16: {
+      auto *n = static_cast<Node16 *>(node);
+      int pos = LowerBound16(n->keys_, n->count_, byte);
+      std::copy_backward(n->keys_ + pos, n->keys_ + n->count_, n->keys_ + n->count_ + 1);
+      std::copy_backward(n->children_ + pos, n->children_ + n->count_, n->children_ + n->count_ + 1);
+      n->keys_[pos] = byte;
+      n->children_[pos] = child;
+      break;
+    }
+    case NodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node);
+      // slots freed by removals leave holes
+      uint8_t slot = 0;
+      while (n->children_[slot] != nullptr) {
+        slot++;
+      }
+      n->children_[slot] = child;
+      n->child_index_[byte] = slot;
+      break;
+    }
+    default:
+      static_cast<Node256 *>(node)->children_[byte] = child;
+      break;
+  }
+  node->count_++;
+}
+
+void AdaptiveRadixTree::ChangeChild(InnerNode *node, uint8_t byte, Node *child) {
+  switch (node->type_) {
+    case NodeType::NODE4: {
+      auto *n = static_cast<Node4 *>(node);
+      for (int i = 0; i < n->count_; i++) {
+        if (n->keys_[i] == byte) {
+          n->children_[i] = child;
+          return;
+        }
+      }
+      break;
+    }
+    case NodeType::NODE16: {
+      auto *n = static_cast<Node16 *>(node);
+      n->children_[FindByte16(n->keys_, n->count_, byte)] = child;
+      break;
+    }
+    case NodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node);
+      n->children_[n->child_index_[byte]] = child;
+      break;
+    }
+    default:
+      static_cast<Node256 *>(node)->children_[byte] = child;
+      break;
+  }
+}
+
+void AdaptiveRadixTree::RemoveChild(InnerNode *node, uint8_t byte) {
+  switch (node->type_) {
+    case NodeType::NODE4: {
+      auto *n = static_cast<Node4 *>(node);
+      int pos = 0;
+      while (n->keys_[pos] != byte) {
+        pos++;
+      }
+      std::copy(n->keys_ + pos + 1, n->keys_ + n->count_, n->keys_ + pos);
+      std::copy(n->children_ + pos + 1, n->children_ + n->count_, n->children_ + pos);
+      break;
+    }
+    case NodeType::NODE16: {
+      auto *n = static_cast<Node16 *>(node);
+      int pos = FindByte16(n->keys_, n->count_, byte);
+      std::copy(n->keys_ + pos + 1, n->keys_ + n->count_, n->keys_ + pos);
+      std::copy(n->children_ + pos + 1, n->children_ + n->count_, n->children_ + pos);
+      break;
+    }
+    case NodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node);
+      uint8_t slot = n->child_index_[byte];
+      n->child_index_[byte] = Node48::EMPTY;
+      n->children_[slot] = nullptr;
+      break;
+    }
+    default:
+      static_cast<Node256 *>(node)->children_[byte] = nullptr;
+      break;
+  }
+  node->count_--;
+}
+
+void AdaptiveRadixTree::GetChildren(InnerNode *node, std::vector<std::pair<uint8_t, Node *>> *children) {
+  children->clear();
+  switch (node->type_) {
+    case NodeType::NODE4: {
+      auto *n = static_cast<Node4 *>(node);
+      for (int i = 0; i < n->count_ && i < 4; i++) {
+        children->emplace_back(n->keys_[i], n->children_[i]);
+      }
+      break;
+    }
+    case NodeType::NODE16: {
+      auto *n = static_cast<Node16 *>(node);
+      for (int i = 0; i < n->count_ && i < 16; i++) {
+        children->emplace_back(n->keys_[i], n->children_[i]);
+      }
+      break;
+    }
+    case NodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node);
+      for (int byte = 0; byte < 256; byte++) {
+        uint8_t slot = n->child_index_[byte];
+        if (slot != Node48::EMPTY && n->children_[slot] != nullptr) {
+          children->emplace_back(static_cast<uint8_t>(byte), n->children_[slot]);
+        }
+      }
+      break;
+    }
+    default: {
+      auto *n = static_cast<Node256 *>(node);
+      for (int byte = 0; byte < 256; byte++) {
+        if (n->children_[byte] != nullptr) {
+          children->emplace_back(static_cast<uint8_t>(byte), n->children_[byte]);
+        }
+      }
+      break;
+    }
+  }
+}
+
+AdaptiveRadixTree::InnerNode *AdaptiveRadixTree::Resize(InnerNode *node, NodeType type) {
+  InnerNode *new_node;
+  switch (type) {
+    case NodeType::NODE4:
+      new_node = new Node4();
+      break;
+    case NodeType::NODE16:
+      new_node = new Node16();
+      break;
+    case NodeType::NODE48:
+      new_node = new Node48();
+      break;
+    default:
+      new_node = new Node256();
+      break;
+  }
+  new_node->prefix_len_ = node->prefix_len_;
+  memcpy(new_node->prefix_, node->prefix_, MAX_PREFIX_LEN);
+  std::vector<std::pair<uint8_t, Node *>> children;
+  GetChildren(node, &children);
+  for (const auto &child : children) {
+    AddChild(new_node, child.first, child.second);
+  }
+  return new_node;
+}
+
+void AdaptiveRadixTree::SetPrefix(InnerNode *node, const uint8_t *prefix, uint32_t prefix_len) {
+  node->prefix_len_ = prefix_len;
+  memmove(node->prefix_, prefix, std::min(prefix_len, MAX_PREFIX_LEN));
+}
+
+AdaptiveRadixTree::Leaf *AdaptiveRadixTree::AnyLeaf(Node *node) {
+  while (node != nullptr && node->type_ != NodeType::LEAF) {
+    auto *inner = static_cast<InnerNode *>(node);
+    node = nullptr;
+    switch (inner->type_) {
+      case NodeType::NODE4:
+        node = inner->count_ > 0 ? static_cast<Node4 *>(inner)->children_[0] : nullptr;
+        break;
+      case NodeType::NODE16:
+        node = inner->count_ > 0 ? static_cast<Node16 *>(inner)->children_[0] : nullptr;
+        break;
+      case NodeType::NODE48:
+        for (Node *child : static_cast<Node48 *>(inner)->children_) {
+          if (child != nullptr) {
+            node = child;
+            break;
+          }
+        }
+        break;
+      default:
+        for (Node *child : static_cast<Node256 *>(inner)->children_) {
+          if (child != nullptr) {
+            node = child;
+            break;
+          }
+        }
+        break;
+    }
+  }
+  return static_cast<Leaf *>(node);
+}
+
+void AdaptiveRadixTree::FreeNode(Node *node) {
+  switch (node->type_) {
+    case NodeType::LEAF:
+      delete static_cast<Leaf *>(node);
+      break;
+    case NodeType::NODE4:
+      delete static_cast<Node4 *>(node);
+      break;
+    case NodeType::NODE16:
+      delete static_cast<Node16 *>(node);
+      break;
+    case NodeType::NODE48:
+      delete static_cast<Node48 *>(node);
+      break;
+    case NodeType::NODE256:
+      delete static_cast<Node256 *>(node);
+      break;
+  }
+}
+
+void AdaptiveRadixTree::FreeSubtree(Node *node) {
+  if (node->type_ != NodeType::LEAF) {
+    std::vector<std::pair<uint8_t, Node *>> children;
+    GetChildren(static_cast<InnerNode *>(node), &children);
+    for (const auto &child : children) {
+      FreeSubtree(child.second);
+    }
+  }
+  FreeNode(node);
+}
+
+void AdaptiveRadixTree::Retire(Node *node) {
+  epoch_manager_.Retire(node, [](void *ptr) { FreeNode(static_cast<Node *>(ptr)); });
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+bool AdaptiveRadixTree::GetValue(const uint8_t *key, std::vector<RID> *result) {
+  while (true) {
+    EpochManager::Guard guard(&epoch_manager_);
+    bool restart = false;
+    bool found = GetValueAttempt(key, result, &restart);
+    if (!restart) {
+      return found;
+    }
+    std::this_thread::yield();
+  }
+}
+
+/*
+ * Only the stored prefix bytes are compared on the way down, the full key is
+ * compared at the leaf.
+ */
+bool AdaptiveRadixTree::GetValueAttempt(const uint8_t *key, std::vector<RID> *result, bool *restart) {
+  InnerNode *node = root_;
+  uint64_t version = ReadLockOrRestart(node, restart);
+  uint32_t depth = 0;
+  while (!*restart) {
+    uint32_t prefix_len = node->prefix_len_;
+    if (depth + prefix_len >= key_size_) {
+      // inconsistent read
+      *restart = true;
+      return false;
+    }
+    if (memcmp(node->prefix_, key + depth, std::min(prefix_len, MAX_PREFIX_LEN)) != 0) {
+      CheckOrRestart(node, version, restart);
+      return false;
+    }
+    depth += prefix_len;
+    Node *child = FindChild(node, key[depth]);
+    CheckOrRestart(node, version, restart);
+    if (*restart || child == nullptr) {
+      return false;
+    }
+    if (child->type_ == NodeType::LEAF) {
+      auto *leaf = static_cast<Leaf *>(child);
+      if (memcmp(leaf->key_.data(), key, key_size_) != 0) {
+        return false;
+      }
+      result->insert(result->end(), leaf->values_.begin(), leaf->values_.end());
+      return true;
+    }
+    auto *inner = static_cast<InnerNode *>(child);
+    uint64_t child_version = ReadLockOrRestart(inner, restart);
+    CheckOrRestart(node, version, restart);
+    node = inner;
+    version = child_version;
+    depth++;
+  }
+  return false;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+bool AdaptiveRadixTree::Insert(const uint8_t *key, const RID &value) {
+  while (true) {
+    EpochManager::Guard guard(&epoch_manager_);
+    bool restart = false;
+    bool inserted = InsertAttempt(key, value, &restart);
+    if (!restart) {
+      return inserted;
+    }
+    std::this_thread::yield();
+  }
+}
+
+/*
+ * Descend with lock coupling; only the node that changes (and its parent when
+ * the node itself is replaced) is write locked, by upgrading the versions read
+ * on the way down.
+ */
+bool AdaptiveRadixTree::InsertAttempt(const uint8_t *key, const RID &value, bool *restart) {
+  InnerNode *parent = nullptr;
+  uint64_t parent_version = 0;
+  uint8_t parent_byte = 0;
+  InnerNode *node = root_;
+  uint64_t version = ReadLockOrRestart(node, restart);
+  uint32_t depth = 0;
+  while (!*restart) {
+    uint32_t prefix_len = node->prefix_len_;
+    if (depth + prefix_len >= key_size_) {
+      *restart = true;
+      return false;
+    }
+    if (prefix_len > 0) {
+      // the whole prefix is needed to find where the key leaves it
+      const uint8_t *prefix = node->prefix_;
+      if (prefix_len > MAX_PREFIX_LEN) {
+        Leaf *leaf = AnyLeaf(node);
+        CheckOrRestart(node, version, restart);
+        if (*restart || leaf == nullptr) {
+          *restart = true;
+          return false;
+        }
+        prefix = leaf->key_.data() + depth;
+      }
+      uint32_t mismatch = 0;
+      while (mismatch < prefix_len && prefix[mismatch] == key[depth + mismatch]) {
+        mismatch++;
+      }
+      if (mismatch < prefix_len) {
+        // split the prefix: a new Node4 takes its common part, node keeps the rest
+        UpgradeToWriteLockOrRestart(parent, parent_version, restart);
+        if (*restart) {
+          return false;
+        }
+        UpgradeToWriteLockOrRestart(node, version, restart);
+        if (*restart) {
+          WriteUnlock(parent);
+          return false;
+        }
+        auto *new_node = new Node4();
+        SetPrefix(new_node, key + depth, mismatch);
+        AddChild(new_node, prefix[mismatch], node);
+        AddChild(new_node, key[depth + mismatch], new Leaf(key, key_size_, {value}));
+        SetPrefix(node, prefix + mismatch + 1, prefix_len - mismatch - 1);
+        ChangeChild(parent, parent_byte, new_node);
+        WriteUnlock(node);
+        WriteUnlock(parent);
+        return true;
+      }
+      depth += prefix_len;
+    }
+
+    uint8_t byte = key[depth];
+    Node *child = FindChild(node, byte);
+    CheckOrRestart(node, version, restart);
+    if (*restart) {
+      return false;
+    }
+    if (child == nullptr) {
+      if (!IsFull(node)) {
+        UpgradeToWriteLockOrRestart(node, version, restart);
+        if (*restart) {
+          return false;
+        }
+        AddChild(node, byte, new Leaf(key, key_size_, {value}));
+        WriteUnlock(node);
+        return true;
+      }
+      // replace node by the next larger layout
+      UpgradeToWriteLockOrRestart(parent, parent_version, restart);
+      if (*restart) {
+        return false;
+      }
+      UpgradeToWriteLockOrRestart(node, version, restart);
+      if (*restart) {
+        WriteUnlock(parent);
+        return false;
+      }
+      NodeType type = node->type_ == NodeType::NODE4 ? NodeType::NODE16
+                                                     : node->type_ == NodeType::NODE16 ? NodeType::NODE48
+                                                                                       : NodeType::NODE256;
+      InnerNode *new_node = Resize(node, type);
+      AddChild(new_node, byte, new Leaf(key, key_size_, {value}));
+      ChangeChild(parent, parent_byte, new_node);
+      WriteUnlockObsolete(node);
+      WriteUnlock(parent);
+      Retire(node);
+      return true;
+    }
+
+    if (child->type_ == NodeType::LEAF) {
+      // leaves are immutable and the version check above validated the pointer
+      auto *leaf = static_cast<Leaf *>(child);
+      uint32_t mismatch = depth + 1;
+      while (mismatch < key_size_ && leaf->key_[mismatch] == key[mismatch]) {
+        mismatch++;
+      }
+      if (mismatch == key_size_) {
+        // same key: replace the leaf by one with the value appended
+        if (std::find(leaf->values_.begin(), leaf->values_.end(), value) != leaf->values_.end()) {
+          return false;
+        }
+        UpgradeToWriteLockOrRestart(node, version, restart);
+        if (*restart) {
+          return false;
+        }
+        std::vector<RID> values(leaf->values_);
+        values.push_back(value);
+        ChangeChild(node, byte, new Leaf(key, key_size_, std::move(values)));
+        WriteUnlock(node);
+        Retire(leaf);
+        return true;
+      }
+      // the keys share the bytes up to mismatch: both leaves go below a new Node4
+      UpgradeToWriteLockOrRestart(node, version, restart);
+      if (*restart) {
+        return false;
+      }
+      auto *new_node = new Node4();
+      SetPrefix(new_node, key + depth + 1, mismatch - depth - 1);
+      AddChild(new_node, leaf->key_[mismatch], leaf);
+      AddChild(new_node, key[mismatch], new Leaf(key, key_size_, {value}));
+      ChangeChild(node, byte, new_node);
+      WriteUnlock(node);
+      return true;
+    }
+
+    parent = node;
+    parent_version = version;
+    parent_byte = byte;
+    node = static_cast<InnerNode *>(child);
+    version = ReadLockOrRestart(node, restart);
+    CheckOrRestart(parent, parent_version, restart);
+    depth++;
+  }
+  return false;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+bool AdaptiveRadixTree::Remove(const uint8_t *key, const RID &value) {
+  while (true) {
+    EpochManager::Guard guard(&epoch_manager_);
+    bool restart = false;
+    bool removed = RemoveAttempt(key, value, &restart);
+    if (!restart) {
+      return removed;
+    }
+    std::this_thread::yield();
+  }
+}
+
+/*
+ * A node left with too few children is replaced by a smaller layout; a Node4
+ * left with one child is replaced by that child, whose prefix then absorbs
+ * the prefix of the node and the byte leading to it.
+ */
+bool AdaptiveRadixTree::RemoveAttempt(const uint8_t *key, const RID &value, bool *restart) {
+  InnerNode *parent = nullptr;
+  uint64_t parent_version = 0;
+  uint8_t parent_byte = 0;
+  InnerNode *node = root_;
+  uint64_t version = ReadLockOrRestart(node, restart);
+  uint32_t depth = 0;
+  while (!*restart) {
+    uint32_t prefix_len = node->prefix_len_;
+    if (depth + prefix_len >= key_size_) {
+      *restart = true;
+      return false;
+    }
+    if (memcmp(node->prefix_, key + depth, std::min(prefix_len, MAX_PREFIX_LEN)) != 0) {
+      CheckOrRestart(node, version, restart);
+      return false;
+    }
+    depth += prefix_len;
+    uint8_t byte = key[depth];
+    Node *child = FindChild(node, byte);
+    CheckOrRestart(node, version, restart);
+    if (*restart || child == nullptr) {
+      return false;
+    }
+    if (child->type_ != NodeType::LEAF) {
+      parent = node;
+      parent_version = version;
+      parent_byte = byte;
+      node = static_cast<InnerNode *>(child);
+      version = ReadLockOrRestart(node, restart);
+      CheckOrRestart(parent, parent_version, restart);
+      depth++;
+      continue;
+    }
+
+    auto *leaf = static_cast<Leaf *>(child);
+    auto it = std::find(leaf->values_.begin(), leaf->values_.end(), value);
+    if (memcmp(leaf->key_.data(), key, key_size_) != 0 || it == leaf->values_.end()) {
+      return false;
+    }
+    if (leaf->values_.size() > 1) {
+      UpgradeToWriteLockOrRestart(node, version, restart);
+      if (*restart) {
+        return false;
+      }
+      std::vector<RID> values(leaf->values_.begin(), it);
+      values.insert(values.end(), it + 1, leaf->values_.end());
+      ChangeChild(node, byte, new Leaf(key, key_size_, std::move(values)));
+      WriteUnlock(node);
+      Retire(leaf);
+      return true;
+    }
+    if (node == root_ || !IsUnderfull(node)) {
+      UpgradeToWriteLockOrRestart(node, version, restart);
+      if (*restart) {
+        return false;
+      }
+      RemoveChild(node, byte);
+      WriteUnlock(node);
+      Retire(leaf);
+      return true;
+    }
+
+    UpgradeToWriteLockOrRestart(parent, parent_version, restart);
+    if (*restart) {
+      return false;
+    }
+    UpgradeToWriteLockOrRestart(node, version, restart);
+    if (*restart) {
+      WriteUnlock(parent);
+      return false;
+    }
+    InnerNode *new_node = nullptr;
+    Node *replacement;
+    if (node->type_ == NodeType::NODE4) {
+      auto *n = static_cast<Node4 *>(node);
+      int other = n->keys_[0] == byte ? 1 : 0;
+      replacement = n->children_[other];
+      if (replacement->type_ != NodeType::LEAF) {
+        auto *sibling = static_cast<InnerNode *>(replacement);
+        uint64_t sibling_version = ReadLockOrRestart(sibling, restart);
+        if (!*restart) {
+          UpgradeToWriteLockOrRestart(sibling, sibling_version, restart);
+        }
+        if (*restart) {
+          WriteUnlock(node);
+          WriteUnlock(parent);
+          return false;
+        }
+        // merged prefix: node prefix, the byte of sibling in node, sibling prefix
+        uint8_t merged[MAX_PREFIX_LEN];
+        uint32_t stored = std::min(node->prefix_len_, MAX_PREFIX_LEN);
+        memcpy(merged, node->prefix_, stored);
+        if (stored < MAX_PREFIX_LEN) {
+          merged[stored++] = n->keys_[other];
+        }
+        memcpy(merged + stored, sibling->prefix_, std::min(MAX_PREFIX_LEN - stored, sibling->prefix_len_));
+        sibling->prefix_len_ += node->prefix_len_ + 1;
+        memcpy(sibling->prefix_, merged, MAX_PREFIX_LEN);
+        WriteUnlock(sibling);
+      }
+    } else {
+      RemoveChild(node, byte);
+      new_node = Resize(node, node->type_ == NodeType::NODE16
+                                  ? NodeType::NODE4
+                                  : node->type_ == NodeType::NODE48 ? NodeType::NODE16 : NodeType::NODE48);
+      replacement = new_node;
+    }
+    ChangeChild(parent, parent_byte, replacement);
+    WriteUnlockObsolete(node);
+    WriteUnlock(parent);
+    Retire(node);
+    Retire(leaf);
+    return true;
+  }
+  return false;
+}
+
+/*****************************************************************************
+ * SCAN
+ *****************************************************************************/
+/*
+ * Each attempt walks the tree in key order from lo; on a conflict the scan
+ * restarts from the root, continuing after the last key it reported.
+ */
+void AdaptiveRadixTree::Scan(const uint8_t *lo, const uint8_t *hi,
+                             const std::function<bool(const uint8_t *, const RID &)> &func) {
+  std::vector<uint8_t> start(key_size_, 0);
+  if (lo != nullptr) {
+    start.assign(lo, lo + key_size_);
+  }
+  bool tight = lo != nullptr;
+  bool lo_inclusive = true;
+  std::vector<uint8_t> last_key;
+  while (true) {
+    EpochManager::Guard guard(&epoch_manager_);
+    if (ScanNode(root_, nullptr, 0, 0, tight, start.data(), lo_inclusive, hi, func, &last_key) !=
+        ScanResult::RESTART) {
+      return;
+    }
+    if (!last_key.empty()) {
+      start = last_key;
+      tight = true;
+      lo_inclusive = false;
+    }
+    std::this_thread::yield();
+  }
+}
+
+AdaptiveRadixTree::ScanResult AdaptiveRadixTree::ScanNode(
+    InnerNode *node, InnerNode *parent, uint64_t parent_version, uint32_t depth, bool tight, const uint8_t *lo,
+    bool lo_inclusive, const uint8_t *hi, const std::function<bool(const uint8_t *, const RID &)> &func,
+    std::vector<uint8_t> *last_key) {
+  bool restart = false;
+  uint64_t version = ReadLockOrRestart(node, &restart);
+  if (parent != nullptr) {
+    CheckOrRestart(parent, parent_version, &restart);
+  }
+  uint32_t prefix_len = node->prefix_len_;
+  if (restart || depth + prefix_len >= key_size_) {
+    return ScanResult::RESTART;
+  }
+  if (tight && prefix_len > 0) {
+    const uint8_t *prefix = node->prefix_;
+    if (prefix_len > MAX_PREFIX_LEN) {
+      Leaf *leaf = AnyLeaf(node);
+      if (leaf == nullptr) {
+        return ScanResult::RESTART;
+      }
+      prefix = leaf->key_.data() + depth;
+    }
+    int cmp = memcmp(prefix, lo + depth, prefix_len);
+    CheckOrRestart(node, version, &restart);
+    if (restart) {
+      return ScanResult::RESTART;
+    }
+    if (cmp < 0) {
+      // every key below node is smaller than lo
+      return ScanResult::DONE;
+    }
+    tight = cmp == 0;
+  }
+  depth += prefix_len;
+
+  std::vector<std::pair<uint8_t, Node *>> children;
+  GetChildren(node, &children);
+  CheckOrRestart(node, version, &restart);
+  if (restart) {
+    return ScanResult::RESTART;
+  }
+  for (const auto &[byte, child] : children) {
+    if (tight && byte < lo[depth]) {
+      continue;
+    }
+    bool child_tight = tight && byte == lo[depth];
+    if (child->type_ != NodeType::LEAF) {
+      ScanResult result = ScanNode(static_cast<InnerNode *>(child), node, version, depth + 1, child_tight, lo,
+                                   lo_inclusive, hi, func, last_key);
+      if (result != ScanResult::DONE) {
+        return result;
+      }
+      continue;
+    }
+    const uint8_t *key = static_cast<Leaf *>(child)->key_.data();
+    if (child_tight) {
+      int cmp = memcmp(key, lo, key_size_);
+      if (cmp < 0 || (cmp == 0 && !lo_inclusive)) {
+        continue;
+      }
+    }
+    if (hi != nullptr && memcmp(key, hi, key_size_) > 0) {
+      return ScanResult::STOPPED;
+    }
+    for (const RID &value : static_cast<Leaf *>(child)->values_) {
+      if (!func(key, value)) {
+        return ScanResult::STOPPED;
+      }
+    }
+    last_key->assign(key, key + key_size_);
+  }
+  return ScanResult::DONE;
+}
+
+}  // namespace bustub
@@ -0,0 +1,58 @@
+#include <vector>
+
+#include "storage/index/art_index.h"
+
+namespace bustub {
+/*
+ * Constructor
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+ART_INDEX_TYPE::ARTIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager)
+    : Index(metadata), container_(sizeof(KeyType)) {}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void ART_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct insert index key
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+
+  container_.Insert(reinterpret_cast<const uint8_t *>(index_key.data_), rid);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void ART_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct delete index key
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+
+  container_.Remove(reinterpret_cast<const uint8_t *>(index_key.data_), rid);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void ART_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  // construct scan index key
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+
+  container_.GetValue(reinterpret_cast<const uint8_t *>(index_key.data_), result);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void ART_INDEX_TYPE::ScanRange(const KeyType *lo, const KeyType *hi,
+                               const std::function<bool(const KeyType &, const RID &)> &func) {
+  KeyType key;
+  container_.Scan(lo == nullptr ? nullptr : reinterpret_cast<const uint8_t *>(lo->data_),
+                  hi == nullptr ? nullptr : reinterpret_cast<const uint8_t *>(hi->data_),
+                  [&](const uint8_t *data, const RID &rid) {
+                    memcpy(key.data_, data, sizeof(KeyType));
+                    return func(key, rid);
+                  });
+}
+
+template class ARTIndex<GenericKey<4>, RID, GenericComparator<4>>;
+template class ARTIndex<GenericKey<8>, RID, GenericComparator<8>>;
+template class ARTIndex<GenericKey<16>, RID, GenericComparator<16>>;
+template class ARTIndex<GenericKey<32>, RID, GenericComparator<32>>;
+template class ARTIndex<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,415 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/index/b_link_tree.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <thread>  // NOLINT
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "storage/index/b_link_tree.h"
+#include "storage/page/header_page.h"
+
+namespace bustub {
+INDEX_TEMPLATE_ARGUMENTS
+BLINKTREE_TYPE::BLinkTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                          int leaf_max_size, int internal_max_size)
+    : index_name_(std::move(name)),
+      root_page_id_(INVALID_PAGE_ID),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      leaf_max_size_(leaf_max_size),
+      internal_max_size_(internal_max_size) {
+  // a split has to leave at least one key on each side
+  assert(leaf_max_size_ >= 2 && internal_max_size_ >= 2);
+}
+
+/*
+ * Helper function to decide whether current tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BLINKTREE_TYPE::IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID; }
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+/*
+ * Return the only value that associated with input key
+ * This method is used for point query
+ * @return : true means key exists
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BLINKTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
+  auto *page = FindLeafPage(key, false, false, nullptr);
+  if (page == nullptr) {
+    return false;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  ValueType value;
+  bool ret = leaf->Lookup(key, value, comparator_);
+  if (ret) {
+    result->push_back(value);
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return ret;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * Insert constant key & value pair into the tree
+ * The leaf is the only page latched while inserting. If it is full it is split
+ * first, linked to its new right sibling, released, and only then is the
+ * separator posted to the parent.
+ * @return: since we only support unique key, if user try to insert duplicate
+ * keys return false, otherwise return true.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BLINKTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  if (IsEmpty()) {
+    std::lock_guard<std::mutex> lock(root_latch_);
+    if (IsEmpty()) {
+      StartNewTree(key, value);
+      return true;
+    }
+  }
+
+  std::vector<page_id_t> path;
+  auto *leaf_page = FindLeafPage(key, false, true, &path);
+  auto *leaf = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+
+  ValueType v;
+  if (leaf->Lookup(key, v, comparator_)) {
+    leaf_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+    return false;
+  }
+  if (leaf->GetSize() < leaf->GetMaxSize()) {
+    leaf->Insert(key, value, comparator_);
+    leaf_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), true);
+    return true;
+  }
+
+  // split: the new page becomes reachable through the right link only after it is filled
+  page_id_t new_page_id;
+  auto *page = buffer_pool_manager_->NewPage(&new_page_id);
+  if (page == nullptr) {
+    leaf_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while BLinkTree splitting.");
+  }
+  auto *new_leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  new_leaf->Init(new_page_id, INVALID_PAGE_ID, leaf_max_size_);
+  leaf->MoveHalfTo(new_leaf, buffer_pool_manager_);
+  if (comparator_(key, new_leaf->KeyAt(0)) < 0) {
+    leaf->Insert(key, value, comparator_);
+  } else {
+    new_leaf->Insert(key, value, comparator_);
+  }
+  KeyType separator = new_leaf->KeyAt(0);
+  new_leaf->SetNextPageId(leaf->GetNextPageId());
+  new_leaf->SetHighKey(leaf->GetHighKey());
+  leaf->SetNextPageId(new_page_id);
+  leaf->SetHighKey(separator);
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+
+  page_id_t leaf_page_id = leaf->GetPageId();
+  leaf_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(leaf_page_id, true);
+
+  InsertIntoParent(&path, leaf_page_id, separator, new_page_id, 0);
+  return true;
+}
+
+/*
+ * Insert constant key & value pair into an empty tree
+ * Caller holds root_latch_.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
+  page_id_t page_id;
+  auto *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all pages pinned while StartNewTree");
+  }
+  auto *root = reinterpret_cast<LeafPage *>(page->GetData());
+  root->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+  root->Insert(key, value, comparator_);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  // publish the page only once it is initialized
+  root_page_id_ = page_id;
+  UpdateRootPageId(true);
+}
+
+/*
+ * Post the separator key of a split to the parent of left_id
+ * @param   path      page ids of the internal pages visited by the descent,
+ *                    root first; the parent of a page at level is its back()
+ * @param   level     level of left_id / right_id, leaves are level 0
+ * The parent recorded on the way down may have been split since, so move right
+ * until its high key covers the separator. If there is no recorded parent,
+ * either left_id is still the root and a new root is created, or the tree has
+ * grown since the descent and the path is recomputed from the current root.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::InsertIntoParent(std::vector<page_id_t> *path, page_id_t left_id, const KeyType &key,
+                                      page_id_t right_id, int level) {
+  while (path->empty()) {
+    std::unique_lock<std::mutex> lock(root_latch_);
+    if (root_page_id_ == left_id) {
+      page_id_t root_id;
+      auto *page = buffer_pool_manager_->NewPage(&root_id);
+      if (page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while BLinkTree InsertIntoParent");
+      }
+      auto *root = reinterpret_cast<InternalPage *>(page->GetData());
+      root->Init(root_id, INVALID_PAGE_ID, internal_max_size_);
+      root->PopulateNewRoot(left_id, key, right_id);
+      buffer_pool_manager_->UnpinPage(root_id, true);
+      root_page_id_ = root_id;
+      UpdateRootPageId(false);
+      return;
+    }
+    auto *leaf_page = FindLeafPage(key, false, false, path);
+    leaf_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+    if (static_cast<int>(path->size()) > level) {
+      path->resize(path->size() - level);
+      break;
+    }
+    // the page that split the old root has not installed the new one yet
+    path->clear();
+    lock.unlock();
+    std::this_thread::yield();
+  }
+
+  page_id_t parent_id = path->back();
+  path->pop_back();
+  auto *page = FetchPage(parent_id);
+  page->WLatch();
+  auto *parent = reinterpret_cast<InternalPage *>(page->GetData());
+  while (parent->GetNextPageId() != INVALID_PAGE_ID && comparator_(key, parent->GetHighKey()) >= 0) {
+    page_id_t next_page_id = parent->GetNextPageId();
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(parent_id, false);
+    parent_id = next_page_id;
+    page = FetchPage(parent_id);
+    page->WLatch();
+    parent = reinterpret_cast<InternalPage *>(page->GetData());
+  }
+
+  if (parent->GetSize() < parent->GetMaxSize()) {
+    parent->Insert(key, right_id, comparator_);
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(parent_id, true);
+    return;
+  }
+
+  // split the parent: merge the new entry in order, keep ceil((n + 1) / 2) entries on the left
+  std::vector<std::pair<KeyType, page_id_t>> entries;
+  entries.reserve(parent->GetSize() + 1);
+  entries.emplace_back(parent->KeyAt(0), parent->ValueAt(0));
+  bool inserted = false;
+  for (int i = 1; i < parent->GetSize(); ++i) {
+    if (!inserted && comparator_(key, parent->KeyAt(i)) < 0) {
+      entries.emplace_back(key, right_id);
+      inserted = true;
+    }
+    entries.emplace_back(parent->KeyAt(i), parent->ValueAt(i));
+  }
+  if (!inserted) {
+    entries.emplace_back(key, right_id);
+  }
+
+  page_id_t new_page_id;
+  auto *new_page = buffer_pool_manager_->NewPage(&new_page_id);
+  if (new_page == nullptr) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(parent_id, false);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while BLinkTree InsertIntoParent");
+  }
+  auto *new_parent = reinterpret_cast<InternalPage *>(new_page->GetData());
+  new_parent->Init(new_page_id, INVALID_PAGE_ID, internal_max_size_);
+
+  int left_size = (static_cast<int>(entries.size()) + 1) / 2;
+  parent->SetSize(left_size);
+  for (int i = 0; i < left_size; ++i) {
+    parent->SetKeyAt(i, entries[i].first);
+    parent->SetValueAt(i, entries[i].second);
+  }
+  // the first (invalid) key of the right page keeps the separator
+  new_parent->SetSize(static_cast<int>(entries.size()) - left_size);
+  for (int i = left_size, j = 0; i < static_cast<int>(entries.size()); ++i, ++j) {
+    new_parent->SetKeyAt(j, entries[i].first);
+    new_parent->SetValueAt(j, entries[i].second);
+  }
+  KeyType separator = entries[left_size].first;
+  new_parent->SetNextPageId(parent->GetNextPageId());
+  new_parent->SetHighKey(parent->GetHighKey());
+  parent->SetNextPageId(new_page_id);
+  parent->SetHighKey(separator);
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(parent_id, true);
+
+  InsertIntoParent(path, parent_id, separator, new_page_id, level + 1);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * Delete key & value pair associated with input key
+ * Following Lehman & Yao, only the leaf is changed: pages are never merged,
+ * so an underfull (even empty) leaf simply stays in the chain.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  auto *page = FindLeafPage(key, false, true, nullptr);
+  if (page == nullptr) {
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int old_size = leaf->GetSize();
+  bool dirty = leaf->RemoveAndDeleteRecord(key, comparator_) != old_size;
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), dirty);
+}
+
+/*****************************************************************************
+ * INDEX ITERATOR
+ *****************************************************************************/
+/*
+ * Input parameter is void, find the leftmost leaf page first, then construct
+ * index iterator
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BLINKTREE_TYPE::begin() {
+  KeyType key{};
+  auto *page = FindLeafPage(key, true, false, nullptr);
+  auto *leaf = page == nullptr ? nullptr : reinterpret_cast<LeafPage *>(page->GetData());
+  return INDEXITERATOR_TYPE(leaf, 0, buffer_pool_manager_);
+}
+
+/*
+ * Input parameter is low key, find the leaf page that contains the input key
+ * first, then construct index iterator
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BLINKTREE_TYPE::Begin(const KeyType &key) {
+  auto *page = FindLeafPage(key, false, false, nullptr);
+  LeafPage *leaf = nullptr;
+  int index = 0;
+  if (page != nullptr) {
+    leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    index = leaf->KeyIndex(key, comparator_);
+  }
+  return INDEXITERATOR_TYPE(leaf, index, buffer_pool_manager_);
+}
+
+/*****************************************************************************
+ * UTILITIES AND DEBUG
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+Page *BLINKTREE_TYPE::FetchPage(page_id_t page_id) {
+  auto *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while BLinkTree FetchPage");
+  }
+  return page;
+}
+
+/*
+ * Find leaf page containing particular key, if leftMost flag == true, find
+ * the left most leaf page
+ * Only one page is latched at a time. An internal page is released before its
+ * child is latched; if the child was split in between, the key is at or above
+ * its high key and the right link is followed instead.
+ * @param   exclusive   write latch the leaf instead of read latch
+ * @param   path        if not null, receives the internal pages descended
+ *                      through, root first
+ * @return : the page of the leaf, pinned and latched, or nullptr if the tree
+ *            is empty; callers release it through this page instead of
+ *            fetching it again
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BLINKTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost, bool exclusive, std::vector<page_id_t> *path) {
+  page_id_t page_id = root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  while (true) {
+    auto *page = FetchPage(page_id);
+    page->RLatch();
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    page_id_t next_page_id;
+    if (node->IsLeafPage()) {
+      // a page never changes its type, so the latch can be upgraded by re-acquiring it
+      if (exclusive) {
+        page->RUnlatch();
+        page->WLatch();
+      }
+      auto *leaf = reinterpret_cast<LeafPage *>(node);
+      if (leftMost || leaf->GetNextPageId() == INVALID_PAGE_ID || comparator_(key, leaf->GetHighKey()) < 0) {
+        return page;
+      }
+      next_page_id = leaf->GetNextPageId();
+      if (exclusive) {
+        page->WUnlatch();
+      } else {
+        page->RUnlatch();
+      }
+    } else {
+      auto *internal = reinterpret_cast<InternalPage *>(node);
+      if (!leftMost && internal->GetNextPageId() != INVALID_PAGE_ID &&
+          comparator_(key, internal->GetHighKey()) >= 0) {
+        next_page_id = internal->GetNextPageId();
+      } else {
+        next_page_id = internal->ValueAt(leftMost ? 0 : internal->ChildIndex(key, comparator_));
+        if (path != nullptr) {
+          path->push_back(page_id);
+        }
+      }
+      page->RUnlatch();
+    }
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+/*
+ * Update/Insert root page id in header page(where page_id = 0, header_page is
+ * defined under include/page/header_page.h)
+ * Caller holds root_latch_.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::UpdateRootPageId(int insert_record) {
+  auto *header_page = static_cast<HeaderPage *>(FetchPage(HEADER_PAGE_ID));
+  if (insert_record != 0) {
+    header_page->InsertRecord(index_name_, root_page_id_);
+  } else {
+    header_page->UpdateRecord(index_name_, root_page_id_);
+  }
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+}
+
+template class BLinkTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class BLinkTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class BLinkTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class BLinkTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class BLinkTree<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -9,6 +9,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <iterator>
+#include <random>
 #include <string>
 
 #include "common/exception.h"
@@ -17,15 +20,31 @@
 #include "storage/page/header_page.h"
 
 namespace bustub {
+
+namespace {
+// number of sorted probe keys GetValues() walks down the tree together
+constexpr size_t GET_VALUES_BATCH_SIZE = 64;
+
+// pull the header and the middle of a node's array (where its binary search starts) into the cache
+inline void PrefetchNode(const char *data) {
+  __builtin_prefetch(data);
+  __builtin_prefetch(data + PAGE_SIZE / 2);
+}
+}  // namespace
+
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, bool unique)
     : index_name_(std::move(name)),
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      internal_max_size_(internal_max_size),
+      unique_(unique) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() { StopCompactor(); }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 thread_local bool BPlusTree<KeyType, ValueType, KeyComparator>::root_is_locked = false;
@@ -40,7 +59,7 @@ bool BPLUSTREE_TYPE::IsEmpty() const {
  * SEARCH
  *****************************************************************************/
 /*
- * Return the only value that associated with input key
+ * Return the value(s) associated with input key
  * This method is used for point query
  * @return : true means key exists
  */
@@ -52,21 +71,312 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   if (leaf != nullptr) {
     ValueType value;
     if (leaf->Lookup(key, value, comparator_)) {
-      result->push_back(value);
+      leaf->GetValues(value, result, buffer_pool_manager_);
       ret = true;
     }
     // 释放锁
     UnlockUnpinPages(Operation::READONLY, transaction);
 
     if (transaction == nullptr) {
+      // the fetch only finds the page to unlatch, both its pin and the one of FindLeafPage are dropped
       auto page_id = leaf->GetPageId();
       buffer_pool_manager_->FetchPage(page_id)->RUnlatch();
       buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->UnpinPage(page_id, false);
     }
   }
   return ret;
 }
 
+/*
+ * Batched range scan: replace the content of out_batch with the pairs whose
+ * key lies between lo and hi (a null bound is open, the inclusive flags decide
+ * whether the bound itself matches) and passes filter (if any). Each leaf is
+ * read latched once and every match in it is copied under that latch, instead
+ * of one latch round trip per item as with the index iterator.
+ * All values of a duplicate key are copied together, so the batch may exceed
+ * max_batch by the values of its last key.
+ * @return : true if the batch filled up before the end of the range; continue
+ * with lo = out_batch->back().first and lo_inclusive = false
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::ScanRange(const KeyType *lo, bool lo_inclusive, const KeyType *hi, bool hi_inclusive,
+                               const std::function<bool(const KeyType &)> &filter,
+                               std::vector<MappingType> *out_batch, size_t max_batch) {
+  out_batch->clear();
+  KeyType left_most{};
+  auto *leaf = FindLeafPage(lo == nullptr ? left_most : *lo, lo == nullptr);
+  if (leaf == nullptr) {
+    return false;
+  }
+  int index = 0;
+  if (lo != nullptr) {
+    index = leaf->KeyIndex(*lo, comparator_);
+    if (!lo_inclusive && index < leaf->GetSize() && comparator_(leaf->KeyAt(index), *lo) == 0) {
+      index++;
+    }
+  }
+  // the leaf is already pinned and read latched by FindLeafPage, the fetch only finds its page and its pin is dropped
+  auto *page = buffer_pool_manager_->FetchPage(leaf->GetPageId());
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  std::vector<ValueType> postings;
+  bool more = false;
+  while (true) {
+    int size = leaf->GetSize();
+    for (; index < size; index++) {
+      const MappingType &item = leaf->GetItem(index);
+      if (hi != nullptr) {
+        int cmp = comparator_(item.first, *hi);
+        if (cmp > 0 || (cmp == 0 && !hi_inclusive)) {
+          break;
+        }
+      }
+      if (out_batch->size() >= max_batch) {
+        more = true;
+        break;
+      }
+      if (filter && !filter(item.first)) {
+        continue;
+      }
+      if (LeafPage::IsList(item.second)) {
+        postings.clear();
+        leaf->GetValues(item.second, &postings, buffer_pool_manager_);
+        for (const auto &value : postings) {
+          out_batch->emplace_back(item.first, value);
+        }
+      } else {
+        out_batch->push_back(item);
+      }
+    }
+    page_id_t next_page_id = leaf->GetNextPageId();
+    if (index < size || next_page_id == INVALID_PAGE_ID) {
+      break;
+    }
+    // latch the next leaf before releasing this one
+    auto *next_page = buffer_pool_manager_->FetchPage(next_page_id);
+    if (next_page == nullptr) {
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while ScanRange");
+    }
+    next_page->RLatch();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = next_page;
+    leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    index = 0;
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return more;
+}
+
+/*
+ * Choose keys that split [lo, hi] (a null bound is open) into at most
+ * partitions ranges holding about the same number of pairs. The separator keys
+ * of one internal level are used as candidates: starting at the root, the
+ * descent goes one level deeper (into the children overlapping the range)
+ * until that level has enough separators inside the range or its children are
+ * leaves. Nodes are read latched one at a time, so under concurrent updates
+ * the keys are only an estimate; the ranges they define always cover [lo, hi].
+ * @return : increasing keys in (lo, hi], key i starts range i + 1
+ */
+INDEX_TEMPLATE_ARGUMENTS
+std::vector<KeyType> BPLUSTREE_TYPE::GetPartitionKeys(const KeyType *lo, const KeyType *hi, int partitions) {
+  std::vector<KeyType> separators;
+  std::vector<page_id_t> level;
+  if (partitions > 1 && !IsEmpty()) {
+    level.push_back(root_page_id_);
+  }
+  while (!level.empty()) {
+    std::vector<KeyType> level_separators;
+    std::vector<page_id_t> children;
+    bool leaf_level = false;
+    for (auto page_id : level) {
+      auto *page = buffer_pool_manager_->FetchPage(page_id);
+      if (page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while GetPartitionKeys");
+      }
+      page->RLatch();
+      auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+      leaf_level = node->IsLeafPage();
+      if (!leaf_level) {
+        auto *internal = reinterpret_cast<InternalPage *>(node);
+        int size = internal->GetSize();
+        for (int i = 0; i < size; i++) {
+          // child i holds the keys in [KeyAt(i), KeyAt(i + 1))
+          bool after_lo = i == 0 || lo == nullptr || comparator_(internal->KeyAt(i), *lo) > 0;
+          bool before_hi = i == 0 || hi == nullptr || comparator_(internal->KeyAt(i), *hi) <= 0;
+          if (i > 0 && after_lo && before_hi) {
+            level_separators.push_back(internal->KeyAt(i));
+          }
+          bool reaches_lo = i + 1 == size || lo == nullptr || comparator_(internal->KeyAt(i + 1), *lo) > 0;
+          if (reaches_lo && before_hi) {
+            children.push_back(internal->ValueAt(i));
+          }
+        }
+      }
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      if (leaf_level) {
+        break;
+      }
+    }
+    if (leaf_level) {
+      break;
+    }
+    separators = std::move(level_separators);
+    if (static_cast<int>(separators.size()) >= partitions - 1) {
+      break;
+    }
+    level = std::move(children);
+  }
+
+  // pick partitions - 1 evenly spaced candidates
+  int count = static_cast<int>(separators.size());
+  if (count <= partitions - 1) {
+    return separators;
+  }
+  std::vector<KeyType> keys;
+  keys.reserve(partitions - 1);
+  for (int i = 1; i < partitions; i++) {
+    keys.push_back(separators[static_cast<int64_t>(i) * (count + 1) / partitions - 1]);
+  }
+  return keys;
+}
+
+/*
+ * Parallel range scan: split [lo, hi] (a null bound is open) with
+ * GetPartitionKeys() and scan every range with its own iterator on its own
+ * thread. func is called concurrently from the workers, with the partition
+ * number and a pair of that partition; pairs of one partition come in key
+ * order and partition i only holds keys smaller than those of partition i + 1.
+ * @return : number of partitions used, at most partitions
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::ParallelScan(const KeyType *lo, const KeyType *hi, int partitions,
+                                 const std::function<void(int, const MappingType &)> &func) {
+  std::vector<KeyType> keys = GetPartitionKeys(lo, hi, partitions);
+  int used = static_cast<int>(keys.size()) + 1;
+  auto worker = [&](int partition) {
+    const KeyType *start = partition == 0 ? lo : &keys[partition - 1];
+    const KeyType *stop = partition + 1 == used ? hi : &keys[partition];
+    // the last partition includes hi, the others stop before the next partition key
+    int stop_cmp = partition + 1 == used ? 0 : -1;
+    for (auto iterator = start == nullptr ? begin() : Begin(*start); !iterator.isEnd(); ++iterator) {
+      const MappingType &item = *iterator;
+      if (stop != nullptr && comparator_(item.first, *stop) > stop_cmp) {
+        break;
+      }
+      func(partition, item);
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(used - 1);
+  for (int partition = 1; partition < used; partition++) {
+    threads.emplace_back(worker, partition);
+  }
+  // the calling thread scans the first partition
+  worker(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return used;
+}
+
+/*
+ * Batched point queries, e.g. the probes of an index nested loop join.
+ * The keys are sorted and walked down the tree in groups: every level is
+ * visited once per group, a node is read latched and searched once for all
+ * the keys routed through it (keys sharing a path share its prefix), and the
+ * next node of the level is prefetched while the current one is searched.
+ * Latches are crabbed level by level, top down and left to right.
+ * @return : number of keys found; results[i] holds the value(s) of keys[i]
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                              Transaction *transaction) {
+  results->assign(keys.size(), std::vector<ValueType>());
+  std::vector<size_t> order(keys.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(),
+            [this, &keys](size_t lhs, size_t rhs) { return comparator_(keys[lhs], keys[rhs]) < 0; });
+
+  // a node of the current level and the run of sorted probes [begin, end) routed to it
+  struct Run {
+    Page *page;
+    size_t begin;
+    size_t end;
+  };
+  auto release = [this](const std::vector<Run> &runs) {
+    for (const auto &run : runs) {
+      run.page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(run.page->GetPageId(), false);
+    }
+  };
+
+  int found = 0;
+  for (size_t first = 0; first < order.size() && !IsEmpty(); first += GET_VALUES_BATCH_SIZE) {
+    size_t last = std::min(order.size(), first + GET_VALUES_BATCH_SIZE);
+    auto *root = FetchRootForRead("GetValues");
+    if (root == nullptr) {
+      break;
+    }
+    std::vector<Run> level = {{root, first, last}};
+    while (!reinterpret_cast<BPlusTreePage *>(level[0].page->GetData())->IsLeafPage()) {
+      std::vector<Run> children;
+      for (size_t r = 0; r < level.size(); r++) {
+        if (r + 1 < level.size()) {
+          PrefetchNode(level[r + 1].page->GetData());
+        }
+        auto *internal = reinterpret_cast<InternalPage *>(level[r].page->GetData());
+        for (size_t i = level[r].begin; i < level[r].end;) {
+          int child_index = internal->ChildIndex(keys[order[i]], comparator_);
+          // every following probe below the next separator goes to the same child
+          size_t j = i + 1;
+          if (child_index + 1 == internal->GetSize()) {
+            j = level[r].end;
+          } else {
+            while (j < level[r].end && comparator_(keys[order[j]], internal->KeyAt(child_index + 1)) < 0) {
+              j++;
+            }
+          }
+          auto *child = buffer_pool_manager_->FetchPage(internal->ValueAt(child_index));
+          if (child == nullptr) {
+            release(level);
+            release(children);
+            throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while GetValues");
+          }
+          child->RLatch();
+          children.push_back({child, i, j});
+          i = j;
+        }
+      }
+      release(level);
+      level = std::move(children);
+    }
+
+    for (size_t r = 0; r < level.size(); r++) {
+      if (r + 1 < level.size()) {
+        PrefetchNode(level[r + 1].page->GetData());
+      }
+      auto *leaf = reinterpret_cast<LeafPage *>(level[r].page->GetData());
+      for (size_t i = level[r].begin; i < level[r].end; i++) {
+        ValueType value;
+        if (!leaf->Lookup(keys[order[i]], value, comparator_)) {
+          continue;
+        }
+        leaf->GetValues(value, &(*results)[order[i]], buffer_pool_manager_);
+        found++;
+      }
+    }
+    release(level);
+  }
+  return found;
+}
+
 /*****************************************************************************
  * UTILITIES AND DEBUG
  *****************************************************************************/
@@ -111,10 +421,13 @@ void BPlusTree<KeyType, ValueType, KeyComparator>::
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::isSafe(BPlusTreePage* node, Operation op) {
   if (op == Operation::INSERT) {
-    return node->GetSize() < node->GetMaxSize();
+    // a leaf also splits once its inline lists leave no room for another entry
+    return node->GetSize() < node->GetMaxSize() &&
+           (!node->IsLeafPage() || reinterpret_cast<LeafPage *>(node)->HasRoomForEntry());
   }
-  else if (op == Operation::DELETE) {
-    return node->GetSize() > node->GetMinSize() + 1;
+  else if (op == Operation::DELETE || op == Operation::COMPACT) {
+    // deferred deletes never merge, so they never change a parent
+    return (op == Operation::DELETE && deferred_merge_) || node->GetSize() > node->GetMinSize() + 1;
   }
   return true;
 }
@@ -131,9 +444,12 @@ bool BPLUSTREE_TYPE::isSafe(BPlusTreePage* node, Operation op) {
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {  
   if (IsEmpty()) {
-    std::lock_guard<std::mutex> lock(mutex_);      
-    StartNewTree(key, value);
-    return true;
+    std::lock_guard<std::mutex> lock(mutex_);
+    // another thread may have started the tree while we were waiting
+    if (IsEmpty()) {
+      StartNewTree(key, value);
+      return true;
+    }
   }
   return InsertIntoLeaf(key, value, transaction);
 }
@@ -157,6 +473,10 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
   // int size = (PAGE_SIZE - sizeof(BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>)) / (sizeof(KeyType) + sizeof(ValueType));  
   root->Init(root_page_id_, INVALID_PAGE_ID, leaf_max_size_);
   root->Insert(key, value, comparator_);
+  rightmost_leaf_hint_ = root_page_id_;
+  level_pages_[0] = 1;
+  height_ = 1;
+  leaf_entries_++;
   //根页已经被修改了，写入了东西。
   buffer_pool_manager_->UnpinPage(root->GetPageId(), true);  
 }
@@ -171,32 +491,58 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  auto* leaf = FindLeafPage(key, false, Operation::INSERT, transaction);
- 
+  // 递增的 key 直接追加到最右边的叶子，不用从根往下找
+  if (InsertIntoRightmostLeaf(key, value)) {
+    return true;
+  }
+  // 先乐观地只锁叶子，叶子可能分裂时再退回到悲观的 crabbing
+  auto* leaf = FindLeafPageOptimistic(key, Operation::INSERT, transaction);
+  if (leaf == nullptr) {
+    leaf = FindLeafPage(key, false, Operation::INSERT, transaction);
+  }
+
   if (leaf == nullptr)
     return false;  
   ValueType v;
-  // 如果树中已经存在值了，有key了，就返回false
+  // 如果树中已经存在值了，有key了：唯一索引返回false，否则加入这个key的posting list
   if (leaf->Lookup(key, v, comparator_)) {
+    bool ret = !unique_ && InsertIntoPostingList(leaf, key, value);
     UnlockUnpinPages(Operation::INSERT, transaction);
-    return false;
+    return ret;
   }
+  leaf_entries_++;
   // 不需要分裂就直接插入
-  if (leaf->GetSize() < leaf->GetMaxSize()) {
+  if (leaf->GetSize() < leaf->GetMaxSize() && leaf->HasRoomForEntry()) {
     leaf->Insert(key, value, comparator_);
+    if (leaf->GetNextPageId() == INVALID_PAGE_ID) {
+      rightmost_leaf_hint_ = leaf->GetPageId();
+    }
   } 
   else {
+    // 追加到最右边的叶子时，旧叶子保持满的，新叶子只放这个 key
+    bool append = leaf->GetNextPageId() == INVALID_PAGE_ID &&
+                  comparator_(key, leaf->KeyAt(leaf->GetSize() - 1)) > 0;
     // 分裂出一个新的叶子节点页面
-    auto* leaf2 = Split<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>(leaf);
-    if (comparator_(key, leaf2->KeyAt(0)) < 0) {
+    auto* leaf2 = Split<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>>(leaf, append);
+    level_pages_[0]++;
+    if (append) {
+      leaf2->Insert(key, value, comparator_);
+    }
+    else if (comparator_(key, leaf2->KeyAt(0)) < 0) {
+      leaf->MakeRoomForEntries(1, buffer_pool_manager_);
       leaf->Insert(key, value, comparator_);
     } 
     else {
+      leaf2->MakeRoomForEntries(1, buffer_pool_manager_);
       leaf2->Insert(key, value, comparator_);
     }
     // 更新前后关系
     if (comparator_(leaf->KeyAt(0), leaf2->KeyAt(0)) < 0) {
       leaf2->SetNextPageId(leaf->GetNextPageId());
+      leaf2->SetPrevPageId(leaf->GetPageId());
+      if (leaf->GetNextPageId() != INVALID_PAGE_ID) {
+        SetLeafPrevPageId(leaf->GetNextPageId(), leaf2->GetPageId());
+      }
       leaf->SetNextPageId(leaf2->GetPageId());
     } 
     else {
@@ -204,21 +550,78 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
     }
     // 将分裂的节点插入到父节点
     InsertIntoParent(leaf, leaf2->KeyAt(0), leaf2, transaction);    
+    // leaf2 is only reachable through the parent, which is still latched
+    if (leaf2->GetNextPageId() == INVALID_PAGE_ID) {
+      rightmost_leaf_hint_ = leaf2->GetPageId();
+    }
   }
   UnlockUnpinPages(Operation::INSERT, transaction);
   return true;
 }
 
+/*
+ * Fast path for keys past the current maximum (auto-increment ids, timestamps)
+ * Latch only the leaf cached in rightmost_leaf_hint_ and append there without
+ * a descent. The hint only changes under the write latch of the leaf it names,
+ * so once that leaf is latched, the hint still naming it proves it is the live
+ * right-most leaf.
+ * @return: false if the hint cannot take the key (no hint, stale hint, key not
+ * past the maximum, leaf full), the caller then inserts the normal way
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::InsertIntoRightmostLeaf(const KeyType &key, const ValueType &value) {
+  page_id_t page_id = rightmost_leaf_hint_;
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  auto *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    return false;
+  }
+  page->WLatch();
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  bool ret = rightmost_leaf_hint_ == page_id && leaf->GetNextPageId() == INVALID_PAGE_ID && leaf->GetSize() > 0 &&
+             leaf->GetSize() < leaf->GetMaxSize() && leaf->HasRoomForEntry() &&
+             comparator_(key, leaf->KeyAt(leaf->GetSize() - 1)) > 0;
+  if (ret) {
+    leaf->Insert(key, value, comparator_);
+    leaf_entries_++;
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, ret);
+  return ret;
+}
+
+/*
+ * Add value to a key that is already in leaf (non-unique tree only)
+ * The second value of a key moves both into an inline list in the leaf, which
+ * spills to a posting list once it outgrows LeafPage::INLINE_LIST_SIZE.
+ * @return: false if the key & value pair already exists
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::InsertIntoPostingList(LeafPage *leaf, const KeyType &key, const ValueType &value) {
+  int index = leaf->KeyIndex(key, comparator_);
+  if (!leaf->InsertValue(index, value, buffer_pool_manager_)) {
+    return false;
+  }
+  // equal keys can still differ past the compared bytes (a covering index stores the included columns of the newest
+  // tuple there), so keep the latest one
+  leaf->SetKeyAt(index, key);
+  return true;
+}
+
 /*
  * Split input page and return newly created page.
  * Using template N to represent either internal page or leaf page.
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
  * an "out of memory" exception if returned value is nullptr), then move half
  * of key & value pairs from input page to newly created page
+ * With append the input page stays full and the new page starts empty, so
+ * appending to the right-most leaf does not leave half-empty pages behind.
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
-N *BPLUSTREE_TYPE::Split(N *node) {
+N *BPLUSTREE_TYPE::Split(N *node, bool append) {
   page_id_t page_id;
   auto* page = buffer_pool_manager_->NewPage(&page_id);
   if (page == nullptr) {
@@ -227,7 +630,9 @@ N *BPLUSTREE_TYPE::Split(N *node) {
   auto new_node = reinterpret_cast<N *>(page->GetData());
   new_node->Init(page_id, node->GetPageId(), node->GetMaxSize());
 
-  node->MoveHalfTo(new_node, buffer_pool_manager_);
+  if (!append) {
+    node->MoveHalfTo(new_node, buffer_pool_manager_);
+  }
   return new_node;
 }
 
@@ -242,7 +647,7 @@ N *BPLUSTREE_TYPE::Split(N *node) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
-                                      Transaction *transaction) {
+                                      Transaction *transaction, int level) {
   // 如果 old_node 是根节点，则需要重新生成一个根页面，页面 id 即为 root_page_id_
   if (old_node->IsRootPage()) {
     auto* page = buffer_pool_manager_->NewPage(&root_page_id_);
@@ -256,6 +661,8 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
 
     old_node->SetParentPageId(root_page_id_);
     new_node->SetParentPageId(root_page_id_);    
+    level_pages_[level + 1] = 1;
+    height_ = level + 2;
 
     // 这时需要更新根节点页面id
     UpdateRootPageId(false);   
@@ -300,6 +707,7 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
 
       assert(copy->GetSize() == copy->GetMaxSize());
       auto internal2 = Split<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>> (copy);
+      level_pages_[level + 1]++;
 
       internal->SetSize(copy->GetSize() + 1);
       for (int i = 0; i < copy->GetSize(); ++i) {
@@ -321,13 +729,126 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
       buffer_pool_manager_->UnpinPage(copy->GetPageId(), false);
       buffer_pool_manager_->DeletePage(copy->GetPageId());
 
-      InsertIntoParent(internal, internal2->KeyAt(0), internal2);      
+      InsertIntoParent(internal, internal2->KeyAt(0), internal2, nullptr, level + 1);
     }
     buffer_pool_manager_->UnpinPage(internal->GetPageId(), true);    
   }                         
 
 }
 
+/*****************************************************************************
+ * BULK LOADING
+ *****************************************************************************/
+namespace {
+/*
+ * Number of pages to spread count entries of one level over: as close to
+ * fill_factor full as possible, but never more than max_size entries a page
+ * and (unless everything fits one page) never fewer than min_size, so that
+ * the pages built here satisfy the same invariants as split/merge.
+ */
+int BulkLoadPageCount(int count, int max_size, int min_size, double fill_factor) {
+  int per_page = std::max(1, std::min(max_size, static_cast<int>(max_size * fill_factor)));
+  int pages = (count + per_page - 1) / per_page;
+  pages = std::min(pages, std::max(1, count / min_size));
+  return std::max(pages, (count + max_size - 1) / max_size);
+}
+}  // namespace
+
+/*
+ * Build the tree bottom-up from key & value pairs sorted by key
+ * Leaves are filled left to right at fill_factor and chained together, then
+ * every internal level is built from the (first key, page id) pairs of the
+ * level below until a single root remains. Each page is written once, with no
+ * descents and no splits, and only the page being filled (plus its left
+ * neighbour, to set the next page id) is pinned.
+ * @return: false if the tree is not empty, otherwise true
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoad(typename std::vector<MappingType>::const_iterator first,
+                              typename std::vector<MappingType>::const_iterator last, double fill_factor,
+                              Transaction *transaction) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!IsEmpty()) {
+    return false;
+  }
+  if (first == last) {
+    return true;
+  }
+
+  // (first key, page id) of every page of the level built last
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  int count = static_cast<int>(last - first);
+  int pages = BulkLoadPageCount(count, leaf_max_size_, std::max(1, leaf_max_size_ / 2), fill_factor);
+  level.reserve(pages);
+  LeafPage *prev = nullptr;
+  auto item = first;
+  for (int i = 0; i < pages; ++i) {
+    page_id_t page_id;
+    auto *page = buffer_pool_manager_->NewPage(&page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while BulkLoad");
+    }
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+    int size = count / pages + (i < count % pages ? 1 : 0);
+    for (int j = 0; j < size; ++j, ++item) {
+      // input must be sorted and unique
+      assert(item == first || comparator_(std::prev(item)->first, item->first) < 0);
+      leaf->Insert(item->first, item->second, comparator_);
+    }
+    if (prev != nullptr) {
+      prev->SetNextPageId(page_id);
+      leaf->SetPrevPageId(prev->GetPageId());
+      buffer_pool_manager_->UnpinPage(prev->GetPageId(), true);
+    }
+    level.emplace_back(leaf->KeyAt(0), page_id);
+    prev = leaf;
+  }
+  page_id_t rightmost_leaf_page_id = prev->GetPageId();
+  buffer_pool_manager_->UnpinPage(prev->GetPageId(), true);
+  level_pages_[0] = pages;
+  int height = 1;
+
+  while (level.size() > 1) {
+    count = static_cast<int>(level.size());
+    pages = BulkLoadPageCount(count, internal_max_size_, std::max(2, internal_max_size_ / 2), fill_factor);
+    std::vector<std::pair<KeyType, page_id_t>> parents;
+    parents.reserve(pages);
+    int index = 0;
+    for (int i = 0; i < pages; ++i) {
+      page_id_t page_id;
+      auto *page = buffer_pool_manager_->NewPage(&page_id);
+      if (page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while BulkLoad");
+      }
+      auto *internal = reinterpret_cast<InternalPage *>(page->GetData());
+      internal->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+      internal->SetSize(count / pages + (i < count % pages ? 1 : 0));
+      parents.emplace_back(level[index].first, page_id);
+      for (int j = 0; j < internal->GetSize(); ++j, ++index) {
+        internal->SetKeyAt(j, level[index].first);
+        internal->SetValueAt(j, level[index].second);
+        auto *child_page = buffer_pool_manager_->FetchPage(level[index].second);
+        if (child_page == nullptr) {
+          throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while BulkLoad");
+        }
+        reinterpret_cast<BPlusTreePage *>(child_page->GetData())->SetParentPageId(page_id);
+        buffer_pool_manager_->UnpinPage(level[index].second, true);
+      }
+      buffer_pool_manager_->UnpinPage(page_id, true);
+    }
+    level.swap(parents);
+    level_pages_[height++] = pages;
+  }
+
+  rightmost_leaf_hint_ = rightmost_leaf_page_id;
+  height_ = height;
+  leaf_entries_ = static_cast<size_t>(last - first);
+  root_page_id_ = level[0].second;
+  UpdateRootPageId(true);
+  return true;
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -340,12 +861,54 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  RemoveEntry(key, nullptr, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  RemoveEntry(key, &value, transaction);
+}
+
+/*
+ * Remove value from key, or the whole key if value is nullptr
+ * Removing one value of a list leaves the leaf entry in place (and turns the
+ * list back into a plain value when one is left); only removing the entry
+ * itself can underflow the leaf.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveEntry(const KeyType &key, const ValueType *value, Transaction *transaction) {
   if (IsEmpty()) return;
-  auto *leaf = FindLeafPage(key, false, Operation::DELETE, transaction);
+  auto *leaf = FindLeafPageOptimistic(key, Operation::DELETE, transaction);
+  if (leaf == nullptr) {
+    leaf = FindLeafPage(key, false, Operation::DELETE, transaction);
+  }
   if (leaf != nullptr) {
+    ValueType current;
+    if (!leaf->Lookup(key, current, comparator_)) {
+      UnlockUnpinPages(Operation::DELETE, transaction);
+      return;
+    }
+    if (LeafPage::IsList(current)) {
+      int index = leaf->KeyIndex(key, comparator_);
+      if (value != nullptr) {
+        leaf->RemoveValue(index, *value, buffer_pool_manager_);
+        UnlockUnpinPages(Operation::DELETE, transaction);
+        return;
+      }
+      leaf->DeleteValues(index, buffer_pool_manager_);
+    } else if (value != nullptr && !(current == *value)) {
+      UnlockUnpinPages(Operation::DELETE, transaction);
+      return;
+    }
+
     int size_before_deletion = leaf->GetSize();
     if (leaf->RemoveAndDeleteRecord(key, comparator_) != size_before_deletion) {
-      if (CoalesceOrRedistribute(leaf, transaction)) {
+      leaf_entries_--;
+      if (deferred_merge_ && !leaf->IsRootPage()) {
+        if (leaf->GetSize() < leaf->GetMinSize()) {
+          MarkUnderfullLeaf(leaf->GetPageId(), key);
+        }
+      } else if (CoalesceOrRedistribute(leaf, transaction)) {
         transaction->AddIntoDeletedPageSet(leaf->GetPageId());
       }
     }
@@ -353,6 +916,88 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
   }
 }
 
+/*****************************************************************************
+ * DEFERRED MERGE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::MarkUnderfullLeaf(page_id_t page_id, const KeyType &key) {
+  std::lock_guard<std::mutex> lock(underfull_leaves_mutex_);
+  underfull_leaves_[page_id] = key;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+size_t BPLUSTREE_TYPE::GetUnderfullLeafCount() {
+  std::lock_guard<std::mutex> lock(underfull_leaves_mutex_);
+  return underfull_leaves_.size();
+}
+
+/*
+ * Merge or rebalance marked leaves, one descent per leaf: the leaf is found
+ * again by its key with the same crabbing as an inline delete, so latches are
+ * held only for one leaf's merge (and the parents it changes) at a time. A
+ * mark is dropped if the key now leads to another leaf (the marked one was
+ * split or merged away) or the leaf is no longer underfull; a leaf still
+ * underfull after borrowing a single pair is marked again.
+ * @return : the number of marks handled
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::Compact(int max_leaves) {
+  Transaction transaction(INVALID_TXN_ID);
+  int handled = 0;
+  for (; handled < max_leaves; handled++) {
+    page_id_t page_id;
+    KeyType key;
+    {
+      std::lock_guard<std::mutex> lock(underfull_leaves_mutex_);
+      if (underfull_leaves_.empty()) {
+        break;
+      }
+      auto it = underfull_leaves_.begin();
+      page_id = it->first;
+      key = it->second;
+      underfull_leaves_.erase(it);
+    }
+    auto *leaf = FindLeafPage(key, false, Operation::COMPACT, &transaction);
+    if (leaf == nullptr) {
+      continue;
+    }
+    if (leaf->GetPageId() == page_id && !leaf->IsRootPage() && leaf->GetSize() < leaf->GetMinSize()) {
+      if (CoalesceOrRedistribute(leaf, &transaction)) {
+        transaction.AddIntoDeletedPageSet(page_id);
+      } else if (leaf->GetSize() < leaf->GetMinSize()) {
+        MarkUnderfullLeaf(page_id, key);
+      }
+    }
+    UnlockUnpinPages(Operation::COMPACT, &transaction);
+  }
+  return handled;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartCompactor(std::chrono::milliseconds interval, int leaves_per_round) {
+  if (compactor_thread_ != nullptr) {
+    return;
+  }
+  enable_compactor_ = true;
+  compactor_thread_ = new std::thread([this, interval, leaves_per_round] {
+    while (enable_compactor_) {
+      std::this_thread::sleep_for(interval);
+      Compact(leaves_per_round);
+    }
+  });
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StopCompactor() {
+  if (compactor_thread_ == nullptr) {
+    return;
+  }
+  enable_compactor_ = false;
+  compactor_thread_->join();
+  delete compactor_thread_;
+  compactor_thread_ = nullptr;
+}
+
 /*
  * User needs to first find the sibling of input page. If sibling's size + input
  * page's size > page's max size, then redistribute. Otherwise, merge.
@@ -362,7 +1007,7 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
-bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
+bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction, int level) {
   if (node->IsRootPage()) {
     return AdjustRoot(node);
   }
@@ -382,7 +1027,11 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
                     "all page are pinned while CoalesceOrRedistribute");
   }
   auto parent = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(page->GetData());
-  int value_index = parent->ValueIndex(node->GetPageId());
+  // any key of node routes to it, so the parent slot can be binary searched
+  int hint_index = node->IsLeafPage() ? 0 : 1;
+  int value_index = hint_index < node->GetSize()
+                        ? parent->ValueIndex(node->GetPageId(), node->KeyAt(hint_index), comparator_)
+                        : parent->ValueIndex(node->GetPageId());
   assert(value_index != parent->GetSize());
   int sibling_page_id;
   if (value_index == 0) {
@@ -405,20 +1054,19 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
     buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
   }
   if (redistribute) {
-    if (value_index == 0) {
-      Redistribute<N>(sibling, node, 1);
-    }
+    // value_index == 0 时兄弟在右边，从它的头部借一个；否则从左兄弟的尾部借
+    Redistribute<N>(sibling, node, value_index);
     return false;
   }
   bool ret;
   if (value_index == 0) {
     // lab3
-    Coalesce<N>(node, sibling, parent, 1, transaction);
+    Coalesce<N>(node, sibling, parent, 1, transaction, level);
     transaction->AddIntoDeletedPageSet(sibling_page_id);
     ret = false;
   }
   else {
-    Coalesce<N>(sibling, node, parent, value_index, transaction);
+    Coalesce<N>(sibling, node, parent, value_index, transaction, level);
     ret = true;
   }
   buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
@@ -442,12 +1090,23 @@ INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
 bool BPLUSTREE_TYPE::Coalesce(N *neighbor_node, N *node,
                               BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *parent, int index,
-                              Transaction *transaction) {
+                              Transaction *transaction, int level) {
   node->MoveAllTo(neighbor_node, index, buffer_pool_manager_);
+  level_pages_[level]--;
+  // the leaf after node now follows neighbor_node
+  if (node->IsLeafPage()) {
+    if (rightmost_leaf_hint_ == node->GetPageId()) {
+      rightmost_leaf_hint_ = neighbor_node->GetPageId();
+    }
+    page_id_t next_page_id = reinterpret_cast<LeafPage *>(neighbor_node)->GetNextPageId();
+    if (next_page_id != INVALID_PAGE_ID) {
+      SetLeafPrevPageId(next_page_id, neighbor_node->GetPageId());
+    }
+  }
 
   parent->Remove(index);
 
-  if (CoalesceOrRedistribute(parent, transaction))
+  if (CoalesceOrRedistribute(parent, transaction, level + 1))
   {
     transaction->AddIntoDeletedPageSet(parent->GetPageId());
     return true;
@@ -473,16 +1132,9 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
     neighbor_node->MoveFirstToEndOf(node, buffer_pool_manager_);
   }
   else {
-    auto *page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
-    if (page == nullptr) {
-      throw Exception(ExceptionType::OUT_OF_MEMORY,
-                      "all page are pinned while Redistribute");
-    }
-    auto parent = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(page->GetData());
-    int idx = parent->ValueIndex(node->GetPageId());
-    buffer_pool_manager_->UnpinPage(parent->GetPageId(), false);
-    neighbor_node->MoveLastToFrontOf(node, idx, buffer_pool_manager_);
-  }  
+    // index is node's slot in the parent, which has not changed since CoalesceOrRedistribute looked it up
+    neighbor_node->MoveLastToFrontOf(node, index, buffer_pool_manager_);
+  }
 }
 /*
  * Update root page if necessary
@@ -499,6 +1151,9 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
   // 如果删除了最后一个节点
   if (old_root_node->IsLeafPage()) {
     if (old_root_node->GetSize() == 0) {
+      rightmost_leaf_hint_ = INVALID_PAGE_ID;
+      level_pages_[0] = 0;
+      height_ = 0;
       root_page_id_ = INVALID_PAGE_ID;
       UpdateRootPageId(false);
       return true;
@@ -510,6 +1165,8 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
     auto root = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(old_root_node);
     root_page_id_ = root->ValueAt(0);
     UpdateRootPageId(false);
+    level_pages_[height_ - 1] = 0;
+    height_--;
     auto *page = buffer_pool_manager_->FetchPage(root_page_id_);
     if (page == nullptr) {
       throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while AdjustRoot");
@@ -542,6 +1199,31 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
   return IndexIterator<KeyType, ValueType, KeyComparator>(leaf, index, buffer_pool_manager_);
 }
 
+/*
+ * Input parameter is high key, find the leaf page that contains the input key
+ * first, then construct a reverse index iterator starting at the last pair
+ * whose key <= input key
+ * @return : reverse index iterator, ++ moves to smaller keys
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin(const KeyType &key) {
+  LeafPage *leaf = FindLeafPage(key, false);
+  int index = -1;
+  if (leaf != nullptr) {
+    index = leaf->KeyIndex(key, comparator_);
+    if (index == leaf->GetSize() || comparator_(leaf->KeyAt(index), key) != 0) {
+      index--;
+    }
+  }
+  // used by the iterator to find the pairs before a key again after backing off a latch
+  auto find_before = [this](const KeyType &bound, int *before_index) {
+    LeafPage *bound_leaf = FindLeafPage(bound, false);
+    *before_index = bound_leaf == nullptr ? -1 : bound_leaf->KeyIndex(bound, comparator_) - 1;
+    return bound_leaf;
+  };
+  return IndexIterator<KeyType, ValueType, KeyComparator>(leaf, index, buffer_pool_manager_, find_before, key);
+}
+
 /*
  * Input parameter is void, construct an index iterator representing the end
  * of the key/value pair in the leaf node
@@ -555,6 +1237,108 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() {
   return iterator; 
 }
 
+/*****************************************************************************
+ * STATISTICS
+ *****************************************************************************/
+/*
+ * Read the counters kept by split, merge, root changes and leaf inserts and
+ * removes; nothing is latched or fetched. Every internal entry points to one
+ * page of the level below, so the internal fill factor needs no counter of its
+ * own. Under concurrent updates the counters are read one at a time and may be
+ * off by the changes in flight.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+BPlusTreeStats BPLUSTREE_TYPE::GetStats() const {
+  BPlusTreeStats stats;
+  stats.height_ = height_;
+  size_t internal_pages = 0;
+  size_t internal_entries = 0;
+  for (int level = 0; level < stats.height_; level++) {
+    stats.level_pages_.push_back(level_pages_[level]);
+    if (level > 0) {
+      internal_pages += stats.level_pages_[level];
+      internal_entries += stats.level_pages_[level - 1];
+    }
+  }
+  stats.leaf_entries_ = leaf_entries_;
+  if (!stats.level_pages_.empty() && stats.level_pages_[0] > 0) {
+    stats.leaf_fill_factor_ =
+        static_cast<double>(stats.leaf_entries_) / static_cast<double>(stats.level_pages_[0] * leaf_max_size_);
+  }
+  if (internal_pages > 0) {
+    stats.internal_fill_factor_ =
+        static_cast<double>(internal_entries) / static_cast<double>(internal_pages * internal_max_size_);
+  }
+  return stats;
+}
+
+/*
+ * Equi-depth histogram of the keys from a sample of leaves
+ * Each sample is one descent from the root to a leaf through uniformly chosen
+ * children, read latched with crabbing. A leaf is reached with probability
+ * 1 / (product of the fanouts on its path), so its keys are weighted by that
+ * product, which keeps leaves under small subtrees from being over-counted.
+ * The weighted keys are sorted and cut into buckets of equal weight.
+ * @return : buckets keys in key order, key i is the upper bound of bucket i
+ * (the last is the largest sampled key); empty for an empty tree
+ */
+INDEX_TEMPLATE_ARGUMENTS
+std::vector<KeyType> BPLUSTREE_TYPE::SampleHistogram(int buckets, int sample_leaves) {
+  thread_local std::mt19937 generator(std::random_device{}());
+  std::vector<std::pair<KeyType, double>> samples;
+  for (int i = 0; i < sample_leaves; i++) {
+    auto *page = FetchRootForRead("SampleHistogram");
+    if (page == nullptr) {
+      break;
+    }
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    double weight = 1;
+    while (!node->IsLeafPage()) {
+      auto *internal = reinterpret_cast<InternalPage *>(node);
+      weight *= internal->GetSize();
+      std::uniform_int_distribution<int> child_index(0, internal->GetSize() - 1);
+      auto *child = buffer_pool_manager_->FetchPage(internal->ValueAt(child_index(generator)));
+      if (child == nullptr) {
+        page->RUnlatch();
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while SampleHistogram");
+      }
+      child->RLatch();
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      page = child;
+      node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    }
+    auto *leaf = reinterpret_cast<LeafPage *>(node);
+    for (int j = 0; j < leaf->GetSize(); j++) {
+      samples.emplace_back(leaf->KeyAt(j), weight);
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+
+  std::vector<KeyType> bounds;
+  if (samples.empty() || buckets <= 0) {
+    return bounds;
+  }
+  std::sort(samples.begin(), samples.end(),
+            [this](const auto &lhs, const auto &rhs) { return comparator_(lhs.first, rhs.first) < 0; });
+  double total = 0;
+  for (const auto &sample : samples) {
+    total += sample.second;
+  }
+  double sum = 0;
+  size_t index = 0;
+  for (int bucket = 1; bucket <= buckets; bucket++) {
+    double depth = total * bucket / buckets;
+    while (index + 1 < samples.size() && sum + samples[index].second < depth) {
+      sum += samples[index++].second;
+    }
+    bounds.push_back(samples[index].first);
+  }
+  return bounds;
+}
+
 /*****************************************************************************
  * UTILITIES AND DEBUG
  *****************************************************************************/
@@ -571,6 +1355,10 @@ B_PLUS_TREE_LEAF_PAGE_TYPE *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, boo
     root_is_locked = true;
   }
   if (IsEmpty()) {
+    if (root_is_locked) {
+      root_is_locked = false;
+      unlockRoot();
+    }
     return nullptr;
   }
 
@@ -630,6 +1418,109 @@ B_PLUS_TREE_LEAF_PAGE_TYPE *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, boo
   return reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(node);  
 }
 
+/*
+ * The root page id is read without the root lock, so by the time its page is
+ * latched the root may have split (a new root above it) or been collapsed into
+ * a child. Check the latched page is still the root and start over otherwise.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FetchRootForRead(const char *caller) {
+  while (true) {
+    page_id_t root_page_id = root_page_id_;
+    if (root_page_id == INVALID_PAGE_ID) {
+      return nullptr;
+    }
+    auto *page = buffer_pool_manager_->FetchPage(root_page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, std::string("all page are pinned while ") + caller);
+    }
+    page->RLatch();
+    if (root_page_id == root_page_id_ && reinterpret_cast<BPlusTreePage *>(page->GetData())->IsRootPage()) {
+      return page;
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(root_page_id, false);
+    std::this_thread::yield();
+  }
+}
+
+/*
+ * Optimistic descent for INSERT/DELETE: crab down with read latches and only
+ * write latch the leaf. If the leaf is not safe for op (it may split or merge),
+ * release everything and return nullptr so the caller restarts with the
+ * pessimistic FindLeafPage(). A root leaf is always left to the pessimistic
+ * path, since it has no parent latch to protect the latch upgrade.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+B_PLUS_TREE_LEAF_PAGE_TYPE *BPLUSTREE_TYPE::FindLeafPageOptimistic(const KeyType &key, Operation op,
+                                                                   Transaction *transaction) {
+  if (transaction == nullptr || IsEmpty()) {
+    return nullptr;
+  }
+  page_id_t root_page_id = root_page_id_;
+  auto *parent = buffer_pool_manager_->FetchPage(root_page_id);
+  if (parent == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while FindLeafPageOptimistic");
+  }
+  parent->RLatch();
+  auto *node = reinterpret_cast<BPlusTreePage *>(parent->GetData());
+  // 拿到读锁之前根节点可能已经分裂或者被删掉了
+  if (root_page_id != root_page_id_ || !node->IsRootPage() || node->IsLeafPage()) {
+    parent->RUnlatch();
+    buffer_pool_manager_->UnpinPage(root_page_id, false);
+    return nullptr;
+  }
+
+  while (true) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_page_id = internal->Lookup(key, comparator_);
+    auto *child = buffer_pool_manager_->FetchPage(child_page_id);
+    if (child == nullptr) {
+      parent->RUnlatch();
+      buffer_pool_manager_->UnpinPage(parent->GetPageId(), false);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while FindLeafPageOptimistic");
+    }
+    child->RLatch();
+    auto *child_node = reinterpret_cast<BPlusTreePage *>(child->GetData());
+    if (child_node->IsLeafPage()) {
+      // the parent's read latch keeps the leaf from being split or merged away
+      // while we trade its read latch for a write latch
+      child->RUnlatch();
+      child->WLatch();
+      parent->RUnlatch();
+      buffer_pool_manager_->UnpinPage(parent->GetPageId(), false);
+      if (!isSafe(child_node, op)) {
+        child->WUnlatch();
+        buffer_pool_manager_->UnpinPage(child_page_id, false);
+        return nullptr;
+      }
+      transaction->AddIntoPageSet(child);
+      return reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(child_node);
+    }
+    parent->RUnlatch();
+    buffer_pool_manager_->UnpinPage(parent->GetPageId(), false);
+    parent = child;
+    node = child_node;
+  }
+}
+
+/*
+ * Point the prev link of a leaf (the right neighbor of a page being split or
+ * merged) to prev_page_id. The caller holds the write latch on the leaf to the
+ * left, so leaves are always latched left to right here.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetLeafPrevPageId(page_id_t page_id, page_id_t prev_page_id) {
+  auto *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while SetLeafPrevPageId");
+  }
+  page->WLatch();
+  reinterpret_cast<LeafPage *>(page->GetData())->SetPrevPageId(prev_page_id);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
 /* 
  * Update/Insert root page id in header page(where page_id = 0, header_page is
  * defined under include/page/header_page.h)
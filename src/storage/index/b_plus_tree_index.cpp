@@ -19,13 +19,26 @@ INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager)
     : Index(metadata),
       comparator_(metadata->GetKeySchema()),
-      container_(metadata->GetName(), buffer_pool_manager, comparator_) {}
+      container_(metadata->GetName(), buffer_pool_manager, comparator_, LEAF_PAGE_SIZE, INTERNAL_PAGE_SIZE, false) {
+  // the included columns go behind the (normalized) key columns, see GenericKey::SetPayload
+  const Schema *include_schema = metadata->GetIncludeSchema();
+  if (include_schema->GetColumnCount() > 0 &&
+      (!GetKeySchema()->IsInlined() || !include_schema->IsInlined() ||
+       GetKeySchema()->GetLength() + KeyType::PayloadSize(include_schema) > sizeof(KeyType))) {
+    throw NotImplementedException("BPlusTreeIndex: included columns need fixed size columns that fit the key size");
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct insert index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, GetKeySchema());
+  const Schema *include_schema = GetMetadata()->GetIncludeSchema();
+  if (include_schema->GetColumnCount() > 0) {
+    // the included columns follow the key columns in the entry tuple
+    index_key.SetPayload(rid, key.GetData() + GetKeySchema()->GetLength(), include_schema);
+  }
 
   container_.Insert(index_key, rid, transaction);
 }
@@ -34,20 +47,52 @@ INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct delete index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, GetKeySchema());
 
-  container_.Remove(index_key, transaction);
+  container_.Remove(index_key, rid, transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
   // construct scan index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  index_key.SetFromKey(key, GetKeySchema());
 
   container_.GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *result,
+                                    Transaction *transaction) {
+  // construct scan index keys
+  std::vector<KeyType> index_keys(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    index_keys[i].SetFromKey(keys[i], GetKeySchema());
+  }
+
+  container_.GetValues(index_keys, result, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::ScanRange(const KeyType *lo, bool lo_inclusive, const KeyType *hi, bool hi_inclusive,
+                                     const std::function<bool(const KeyType &)> &filter,
+                                     std::vector<MappingType> *out_batch, size_t max_batch) {
+  return container_.ScanRange(lo, lo_inclusive, hi, hi_inclusive, filter, out_batch, max_batch);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+std::vector<KeyType> BPLUSTREE_INDEX_TYPE::GetPartitionKeys(const KeyType *lo, const KeyType *hi, int partitions) {
+  return container_.GetPartitionKeys(lo, hi, partitions);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+BPlusTreeStats BPLUSTREE_INDEX_TYPE::GetStats() const { return container_.GetStats(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+std::vector<KeyType> BPLUSTREE_INDEX_TYPE::SampleHistogram(int buckets, int sample_leaves) {
+  return container_.SampleHistogram(buckets, sample_leaves);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator() { return container_.begin(); }
 
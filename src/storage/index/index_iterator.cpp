@@ -2,6 +2,8 @@
  * index_iterator.cpp
  */
 #include <cassert>
+#include <thread>  // NOLINT
+#include <utility>
 
 #include "storage/index/index_iterator.h"
 
@@ -15,18 +17,45 @@ namespace bustub {
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator(BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *leaf,
-              int index_, BufferPoolManager *buff_pool_manager) : leaf_(leaf), index_(index_), buff_pool_manager_(buff_pool_manager) {}
+              int index_, BufferPoolManager *buff_pool_manager) : leaf_(leaf), index_(index_), buff_pool_manager_(buff_pool_manager) {
+  // the start position may be past the last key of its leaf
+  if (leaf_ != nullptr) {
+    SkipExhaustedLeaves();
+    LoadItem();
+  }
+}
+
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *leaf, int index,
+                                  BufferPoolManager *buff_pool_manager, FindBeforeFunc find_before,
+                                  const KeyType &key)
+    : leaf_(leaf),
+      index_(index),
+      buff_pool_manager_(buff_pool_manager),
+      reverse_(true),
+      find_before_(std::move(find_before)) {
+  // until the first pair is loaded, the start key bounds the pairs still to come
+  item_.first = key;
+  if (leaf_ != nullptr) {
+    SkipExhaustedLeavesReverse();
+    LoadItem();
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() {
-  buff_pool_manager_->FetchPage(leaf_->GetPageId())->RUnlatch();
-  buff_pool_manager_->UnpinPage(leaf_->GetPageId(), false);
-  buff_pool_manager_->UnpinPage(leaf_->GetPageId(), false);
+  if (leaf_ == nullptr) {
+    return;
+  }
+  ReleaseLeaf();
 };
 
 INDEX_TEMPLATE_ARGUMENTS
 bool INDEXITERATOR_TYPE::isEnd() {
+  if (reverse_) {
+    return leaf_ == nullptr || (index_ < 0 && leaf_->GetPrevPageId() == INVALID_PAGE_ID);
+  }
     return (leaf_ == nullptr || (index_ == leaf_->GetSize() &&
     leaf_->GetNextPageId() == INVALID_PAGE_ID));
 }
@@ -36,13 +65,59 @@ const MappingType &INDEXITERATOR_TYPE::operator*() {
     if (isEnd()) {
         throw std::out_of_range("IndexIterator: out of range");
     }
-    return leaf_->GetItem(index_);
+    return item_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
+  if (reverse_) {
+    if (posting_index_ > 0) {
+      item_.second = postings_[--posting_index_];
+      return *this;
+    }
+    --index_;
+    SkipExhaustedLeavesReverse();
+    LoadItem();
+    return *this;
+  }
+  // the values of a duplicate key come one at a time
+  if (posting_index_ + 1 < postings_.size()) {
+    item_.second = postings_[++posting_index_];
+    return *this;
+  }
   ++index_;
-  if (index_ == leaf_->GetSize() && leaf_->GetNextPageId() != INVALID_PAGE_ID) {
+  SkipExhaustedLeaves();
+  LoadItem();
+  return *this;
+}
+
+/*
+ * Copy the item at the current position; if its value is a list, read
+ * the whole list and start with its first value (its last one when reversed)
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::LoadItem() {
+  postings_.clear();
+  posting_index_ = 0;
+  if (leaf_ == nullptr || index_ < 0 || index_ >= leaf_->GetSize()) {
+    return;
+  }
+  item_ = leaf_->GetItem(index_);
+  if (B_PLUS_TREE_LEAF_PAGE_TYPE::IsList(item_.second)) {
+    leaf_->GetValues(item_.second, &postings_, buff_pool_manager_);
+    posting_index_ = reverse_ ? postings_.size() - 1 : 0;
+    item_.second = postings_[posting_index_];
+  }
+}
+
+/*
+ * Move on to the next leaf while the current one has no more items. Leaves
+ * can be empty (e.g. after removals in a BLinkTree, which never merges), so
+ * this keeps going until an item or the last leaf is found.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeaves() {
+  while (index_ >= leaf_->GetSize() && leaf_->GetNextPageId() != INVALID_PAGE_ID) {
     // first unpin leaf_, then get the next leaf
     page_id_t next_page_id = leaf_->GetNextPageId();
 
@@ -53,9 +128,7 @@ INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
     // first acquire next page, then release previous page
     page->RLatch();
 
-    buff_pool_manager_->FetchPage(leaf_->GetPageId())->RUnlatch();
-    buff_pool_manager_->UnpinPage(leaf_->GetPageId(), false);
-    buff_pool_manager_->UnpinPage(leaf_->GetPageId(), false);
+    ReleaseLeaf();
 
     auto next_leaf =
         reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType,
@@ -64,7 +137,51 @@ INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
     index_ = 0;
     leaf_ = next_leaf;
   }
-  return *this;    
+}
+
+/*
+ * Reverse counterpart of SkipExhaustedLeaves(), following the prev links.
+ * Writers latch neighboring leaves in both directions: a split or merge
+ * write-latches the right neighbor to fix its prev link while holding the left
+ * leaf, and CoalesceOrRedistribute write-latches the left sibling while holding
+ * the right node. Waiting for the left leaf while holding this one could
+ * therefore deadlock with the first kind of writer, and nothing else orders the
+ * two latches: the left leaf is only try-latched, and if that fails this leaf
+ * is released and the pairs before the last key returned are looked up again
+ * from the root.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeavesReverse() {
+  while (leaf_ != nullptr && index_ < 0 && leaf_->GetPrevPageId() != INVALID_PAGE_ID) {
+    page_id_t prev_page_id = leaf_->GetPrevPageId();
+    auto *page = buff_pool_manager_->FetchPage(prev_page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while IndexIterator(operator++)");
+    }
+    if (page->TryRLatch()) {
+      ReleaseLeaf();
+      leaf_ = reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *>(page->GetData());
+      assert(leaf_->IsLeafPage());
+      index_ = leaf_->GetSize() - 1;
+      continue;
+    }
+    buff_pool_manager_->UnpinPage(prev_page_id, false);
+    // the last key returned bounds the rest of the scan (the leaf itself may be empty, see deferred merge)
+    KeyType bound = item_.first;
+    ReleaseLeaf();
+    std::this_thread::yield();
+    leaf_ = find_before_(bound, &index_);
+  }
+}
+
+/*
+ * Release the read latch and pin on the current leaf
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::ReleaseLeaf() {
+  buff_pool_manager_->FetchPage(leaf_->GetPageId())->RUnlatch();
+  buff_pool_manager_->UnpinPage(leaf_->GetPageId(), false);
+  buff_pool_manager_->UnpinPage(leaf_->GetPageId(), false);
 }
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
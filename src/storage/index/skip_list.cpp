@@ -0,0 +1,285 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// skip_list.cpp
+//
+// Identification: src/storage/index/skip_list.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/skip_list.h"
+
+#include <new>
+#include <random>
+
+#include "common/rid.h"
+
+namespace bustub {
+
+/*****************************************************************************
+ * ITERATOR
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+SKIPLIST_ITERATOR_TYPE::SkipListIterator(Node *node, std::unique_ptr<EpochManager::Guard> guard)
+    : node_(node), guard_(std::move(guard)) {
+  while (node_ != nullptr && (node_->next_[0].load() & 1) != 0) {
+    node_ = reinterpret_cast<Node *>(node_->next_[0].load() & ~static_cast<uintptr_t>(1));
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+SKIPLIST_ITERATOR_TYPE &SKIPLIST_ITERATOR_TYPE::operator++() {
+  // step over removed nodes, their next pointers stay valid while we are in the epoch
+  do {
+    node_ = reinterpret_cast<Node *>(node_->next_[0].load() & ~static_cast<uintptr_t>(1));
+  } while (node_ != nullptr && (node_->next_[0].load() & 1) != 0);
+  return *this;
+}
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+SKIPLIST_TYPE::SkipList(const KeyComparator &comparator)
+    : comparator_(comparator), head_(NewNode(MappingType(), MAX_HEIGHT)) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+SKIPLIST_TYPE::~SkipList() {
+  // nodes still linked at the bottom level; unlinked ones are freed by the epoch manager
+  Node *node = head_;
+  while (node != nullptr) {
+    Node *next = Ptr(node->next_[0].load());
+    FreeNode(node);
+    node = next;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+typename SKIPLIST_TYPE::Node *SKIPLIST_TYPE::NewNode(const MappingType &item, uint32_t height) {
+  void *memory = ::operator new(sizeof(Node) + (height - 1) * sizeof(std::atomic<uintptr_t>));
+  auto *node = new (memory) Node{item, height, {}};
+  for (uint32_t level = 0; level < height; level++) {
+    new (&node->next_[level]) std::atomic<uintptr_t>(0);
+  }
+  return node;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void SKIPLIST_TYPE::FreeNode(void *node) {
+  static_cast<Node *>(node)->~Node();
+  ::operator delete(node);
+}
+
+/*
+ * Geometric heights with p = 1/4, as in the original skip list paper.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+uint32_t SKIPLIST_TYPE::RandomHeight() {
+  thread_local std::mt19937 generator(std::random_device{}());
+  uint32_t bits = generator();
+  uint32_t height = 1;
+  while (height < MAX_HEIGHT && (bits & 3) == 0) {
+    height++;
+    bits >>= 2;
+  }
+  return height;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int SKIPLIST_TYPE::Compare(const MappingType &lhs, const MappingType &rhs) const {
+  int cmp = comparator_(lhs.first, rhs.first);
+  if (cmp != 0) {
+    return cmp;
+  }
+  int64_t lhs_value = lhs.second.Get();
+  int64_t rhs_value = rhs.second.Get();
+  return (lhs_value > rhs_value) - (lhs_value < rhs_value);
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+/*
+ * A failed unlink means pred changed (or was marked itself) under us, then
+ * the search restarts from the head.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool SKIPLIST_TYPE::Find(const MappingType &item, Node **preds, Node **succs) {
+  bool retry = true;
+  while (retry) {
+    retry = false;
+    Node *pred = head_;
+    for (int level = MAX_HEIGHT - 1; level >= 0 && !retry; level--) {
+      Node *curr = Ptr(pred->next_[level].load());
+      while (curr != nullptr) {
+        uintptr_t succ = curr->next_[level].load();
+        if (IsMarked(succ)) {
+          uintptr_t expected = reinterpret_cast<uintptr_t>(curr);
+          if (!pred->next_[level].compare_exchange_strong(expected, succ & ~static_cast<uintptr_t>(1))) {
+            retry = true;
+            break;
+          }
+          curr = Ptr(succ);
+          continue;
+        }
+        if (Compare(curr->item_, item) >= 0) {
+          break;
+        }
+        pred = curr;
+        curr = Ptr(succ);
+      }
+      preds[level] = pred;
+      succs[level] = curr;
+    }
+  }
+  return succs[0] != nullptr && Compare(succs[0]->item_, item) == 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+typename SKIPLIST_TYPE::Node *SKIPLIST_TYPE::LowerBound(const KeyType &key) const {
+  Node *pred = head_;
+  Node *curr = nullptr;
+  for (int level = MAX_HEIGHT - 1; level >= 0; level--) {
+    curr = Ptr(pred->next_[level].load());
+    while (curr != nullptr && comparator_(curr->item_.first, key) < 0) {
+      pred = curr;
+      curr = Ptr(curr->next_[level].load());
+    }
+  }
+  return curr;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool SKIPLIST_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result) {
+  EpochManager::Guard guard(&epoch_manager_);
+  bool found = false;
+  for (Node *node = LowerBound(key); node != nullptr && comparator_(node->item_.first, key) == 0;
+       node = Ptr(node->next_[0].load())) {
+    if (!IsMarked(node->next_[0].load())) {
+      result->push_back(node->item_.second);
+      found = true;
+    }
+  }
+  return found;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+SKIPLIST_ITERATOR_TYPE SKIPLIST_TYPE::Begin() {
+  auto guard = std::make_unique<EpochManager::Guard>(&epoch_manager_);
+  return SKIPLIST_ITERATOR_TYPE(Ptr(head_->next_[0].load()), std::move(guard));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+SKIPLIST_ITERATOR_TYPE SKIPLIST_TYPE::Begin(const KeyType &key) {
+  auto guard = std::make_unique<EpochManager::Guard>(&epoch_manager_);
+  return SKIPLIST_ITERATOR_TYPE(LowerBound(key), std::move(guard));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+SKIPLIST_ITERATOR_TYPE SKIPLIST_TYPE::End() { return SKIPLIST_ITERATOR_TYPE(nullptr, nullptr); }
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * The node is in the list once it is linked at the bottom level; the upper
+ * levels are only shortcuts and are linked afterwards. A concurrent remove may
+ * mark the node meanwhile: linking stops, and a last search unlinks whatever
+ * was linked after the remover's own search.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool SKIPLIST_TYPE::Insert(const KeyType &key, const ValueType &value) {
+  EpochManager::Guard guard(&epoch_manager_);
+  MappingType item(key, value);
+  Node *preds[MAX_HEIGHT];
+  Node *succs[MAX_HEIGHT];
+  uint32_t height = RandomHeight();
+  Node *node = nullptr;
+  while (true) {
+    if (Find(item, preds, succs)) {
+      if (node != nullptr) {
+        FreeNode(node);
+      }
+      return false;
+    }
+    if (node == nullptr) {
+      node = NewNode(item, height);
+    }
+    for (uint32_t level = 0; level < height; level++) {
+      node->next_[level].store(reinterpret_cast<uintptr_t>(succs[level]));
+    }
+    uintptr_t expected = reinterpret_cast<uintptr_t>(succs[0]);
+    if (preds[0]->next_[0].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node))) {
+      break;
+    }
+  }
+
+  for (uint32_t level = 1; level < height; level++) {
+    while (true) {
+      uintptr_t next = node->next_[level].load();
+      if (IsMarked(next)) {
+        break;
+      }
+      if (next != reinterpret_cast<uintptr_t>(succs[level]) &&
+          !node->next_[level].compare_exchange_strong(next, reinterpret_cast<uintptr_t>(succs[level]))) {
+        // marked by a remover
+        break;
+      }
+      uintptr_t expected = reinterpret_cast<uintptr_t>(succs[level]);
+      if (preds[level]->next_[level].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node))) {
+        break;
+      }
+      Find(item, preds, succs);
+    }
+  }
+  if (IsMarked(node->next_[0].load())) {
+    Find(item, preds, succs);
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+bool SKIPLIST_TYPE::Remove(const KeyType &key, const ValueType &value) {
+  EpochManager::Guard guard(&epoch_manager_);
+  MappingType item(key, value);
+  Node *preds[MAX_HEIGHT];
+  Node *succs[MAX_HEIGHT];
+  if (!Find(item, preds, succs)) {
+    return false;
+  }
+  Node *victim = succs[0];
+  for (uint32_t level = victim->height_ - 1; level > 0; level--) {
+    uintptr_t next = victim->next_[level].load();
+    while (!IsMarked(next) && !victim->next_[level].compare_exchange_weak(next, next | 1)) {
+    }
+  }
+  uintptr_t next = victim->next_[0].load();
+  while (!IsMarked(next)) {
+    if (victim->next_[0].compare_exchange_weak(next, next | 1)) {
+      // we removed it: unlink it at every level, then free it once no reader can hold it
+      Find(item, preds, succs);
+      epoch_manager_.Retire(victim, &FreeNode);
+      return true;
+    }
+  }
+  // another remover won
+  return false;
+}
+
+template class SkipList<GenericKey<4>, RID, GenericComparator<4>>;
+template class SkipList<GenericKey<8>, RID, GenericComparator<8>>;
+template class SkipList<GenericKey<16>, RID, GenericComparator<16>>;
+template class SkipList<GenericKey<32>, RID, GenericComparator<32>>;
+template class SkipList<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class SkipListIterator<GenericKey<4>, RID, GenericComparator<4>>;
+template class SkipListIterator<GenericKey<8>, RID, GenericComparator<8>>;
+template class SkipListIterator<GenericKey<16>, RID, GenericComparator<16>>;
+template class SkipListIterator<GenericKey<32>, RID, GenericComparator<32>>;
+template class SkipListIterator<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
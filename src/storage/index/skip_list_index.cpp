@@ -0,0 +1,61 @@
+#include <vector>
+
+#include "storage/index/skip_list_index.h"
+
+namespace bustub {
+/*
+ * Constructor
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+SKIPLIST_INDEX_TYPE::SkipListIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager)
+    : Index(metadata), comparator_(metadata->GetKeySchema()), container_(comparator_) {}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void SKIPLIST_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct insert index key
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+
+  container_.Insert(index_key, rid);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void SKIPLIST_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct delete index key
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+
+  container_.Remove(index_key, rid);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void SKIPLIST_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  // construct scan index key
+  KeyType index_key;
+  index_key.SetFromKey(key, GetKeySchema());
+
+  container_.GetValue(index_key, result);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+SKIPLIST_ITERATOR_TYPE SKIPLIST_INDEX_TYPE::GetBeginIterator() {
+  return container_.Begin();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+SKIPLIST_ITERATOR_TYPE SKIPLIST_INDEX_TYPE::GetBeginIterator(const KeyType &key) {
+  return container_.Begin(key);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+SKIPLIST_ITERATOR_TYPE SKIPLIST_INDEX_TYPE::GetEndIterator() {
+  return container_.End();
+}
+
+template class SkipListIndex<GenericKey<4>, RID, GenericComparator<4>>;
+template class SkipListIndex<GenericKey<8>, RID, GenericComparator<8>>;
+template class SkipListIndex<GenericKey<16>, RID, GenericComparator<16>>;
+template class SkipListIndex<GenericKey<32>, RID, GenericComparator<32>>;
+template class SkipListIndex<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,412 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/index/var_key_b_plus_tree.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "storage/index/var_key_b_plus_tree.h"
+#include "storage/page/header_page.h"
+
+namespace bustub {
+
+VarKeyBPlusTree::VarKeyBPlusTree(std::string name, BufferPoolManager *buffer_pool_manager)
+    : index_name_(std::move(name)), root_page_id_(INVALID_PAGE_ID), buffer_pool_manager_(buffer_pool_manager) {}
+
+/*
+ * Helper function to decide whether current tree is empty
+ */
+bool VarKeyBPlusTree::IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID; }
+
+Page *VarKeyBPlusTree::FetchPage(page_id_t page_id) {
+  auto *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while VarKeyBPlusTree fetching page");
+  }
+  return page;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+/*
+ * Return the only value that associated with input key
+ * This method is used for point query
+ * @return : true means key exists
+ */
+bool VarKeyBPlusTree::GetValue(const std::string &key, std::vector<RID> *result, Transaction *transaction) {
+  auto *page = FindLeafPage(key, false);
+  if (page == nullptr) {
+    return false;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->KeyIndex(key);
+  bool ret = index < leaf->GetSize() && leaf->KeyAt(index) == key;
+  if (ret) {
+    result->push_back(leaf->ValueAt(index));
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return ret;
+}
+
+/*
+ * Leaves are read latched left to right, the next one before the current one
+ * is released, so a scan never misses the entries a split moves right.
+ */
+void VarKeyBPlusTree::Scan(const std::string &lo, const std::function<bool(const std::string &, const RID &)> &func,
+                           Transaction *transaction) {
+  auto *page = FindLeafPage(lo, false);
+  if (page == nullptr) {
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->KeyIndex(lo);
+  while (true) {
+    for (; index < leaf->GetSize(); index++) {
+      if (!func(leaf->KeyAt(index), leaf->ValueAt(index))) {
+        page->RUnlatch();
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+        return;
+      }
+    }
+    page_id_t next_page_id = leaf->GetNextPageId();
+    Page *next = next_page_id == INVALID_PAGE_ID ? nullptr : FetchPage(next_page_id);
+    if (next != nullptr) {
+      next->RLatch();
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    if (next == nullptr) {
+      break;
+    }
+    page = next;
+    leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    index = 0;
+  }
+}
+
+/*
+ * The root page id is read without the root latch, so by the time its page is
+ * latched the root may have split. Check the latched page is still the root
+ * and start over otherwise.
+ */
+Page *VarKeyBPlusTree::FetchRootForRead() {
+  while (true) {
+    page_id_t root_page_id = root_page_id_;
+    if (root_page_id == INVALID_PAGE_ID) {
+      return nullptr;
+    }
+    auto *page = FetchPage(root_page_id);
+    page->RLatch();
+    if (root_page_id == root_page_id_ && reinterpret_cast<BPlusTreePage *>(page->GetData())->IsRootPage()) {
+      return page;
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(root_page_id, false);
+    std::this_thread::yield();
+  }
+}
+
+/*
+ * Find the leaf page responsible for key, crabbing down with read latches.
+ * A leaf to be latched exclusively trades its read latch for a write latch
+ * while its parent is still read latched, which keeps it from being split; a
+ * root leaf has no parent, so it is checked to still be the root afterwards.
+ */
+Page *VarKeyBPlusTree::FindLeafPage(const std::string &key, bool exclusive) {
+  while (true) {
+    auto *page = FetchRootForRead();
+    if (page == nullptr) {
+      return nullptr;
+    }
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (node->IsLeafPage()) {
+      if (!exclusive) {
+        return page;
+      }
+      page_id_t page_id = page->GetPageId();
+      page->RUnlatch();
+      page->WLatch();
+      if (page_id == root_page_id_ && node->IsRootPage()) {
+        return page;
+      }
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      std::this_thread::yield();
+      continue;
+    }
+    while (!node->IsLeafPage()) {
+      auto *internal = reinterpret_cast<InternalPage *>(node);
+      auto *child = FetchPage(internal->ValueAt(internal->ChildIndex(key)));
+      child->RLatch();
+      node = reinterpret_cast<BPlusTreePage *>(child->GetData());
+      if (exclusive && node->IsLeafPage()) {
+        child->RUnlatch();
+        child->WLatch();
+      }
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      page = child;
+    }
+    return page;
+  }
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * Insert constant key & value pair into the tree
+ * A leaf that cannot hold the new entry is split by bytes, and the separator
+ * posted to the parent is the shortest prefix of the right half's first key
+ * that still sorts after the left half's last key.
+ * @return: since we only support unique key, if user try to insert duplicate
+ * keys (or a key longer than SLOTTED_PAGE_MAX_KEY_SIZE) return false,
+ * otherwise return true.
+ */
+bool VarKeyBPlusTree::Insert(const std::string &key, const RID &value, Transaction *transaction) {
+  if (key.size() > SLOTTED_PAGE_MAX_KEY_SIZE) {
+    return false;
+  }
+  // optimistic: only the leaf is write latched, which is enough unless it splits
+  auto *page = FindLeafPage(key, true);
+  if (page == nullptr) {
+    return InsertPessimistic(key, value);
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->KeyIndex(key);
+  bool duplicate = index < leaf->GetSize() && leaf->KeyAt(index) == key;
+  bool inserted = !duplicate && leaf->Insert(index, key, value);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), inserted);
+  if (duplicate || inserted) {
+    return inserted;
+  }
+  return InsertPessimistic(key, value);
+}
+
+bool VarKeyBPlusTree::InsertPessimistic(const std::string &key, const RID &value) {
+  std::unique_lock<std::mutex> root_lock(root_latch_);
+  if (IsEmpty()) {
+    StartNewTree(key, value);
+    return true;
+  }
+  // the write latched path from the highest page that may split (or the root) down to the leaf
+  std::vector<Page *> path;
+  page_id_t page_id = root_page_id_;
+  while (true) {
+    auto *page = FetchPage(page_id);
+    page->WLatch();
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    // a page with room for one more entry does not split, so its ancestors are not changed
+    bool safe = node->IsLeafPage() ? reinterpret_cast<LeafPage *>(node)->HasRoomFor(key.size())
+                                   : reinterpret_cast<InternalPage *>(node)->HasRoomFor(SLOTTED_PAGE_MAX_KEY_SIZE);
+    if (safe) {
+      ReleasePages(&path, false);
+      if (root_lock.owns_lock()) {
+        root_lock.unlock();
+      }
+    }
+    path.push_back(page);
+    if (node->IsLeafPage()) {
+      break;
+    }
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    page_id = internal->ValueAt(internal->ChildIndex(key));
+  }
+
+  auto *leaf = reinterpret_cast<LeafPage *>(path.back()->GetData());
+  page_id = leaf->GetPageId();
+  int index = leaf->KeyIndex(key);
+  if (index < leaf->GetSize() && leaf->KeyAt(index) == key) {
+    ReleasePages(&path, false);
+    return false;
+  }
+  if (leaf->Insert(index, key, value)) {
+    ReleasePages(&path, true);
+    return true;
+  }
+
+  std::vector<LeafPage::Entry> entries;
+  leaf->GetEntries(&entries);
+  entries.emplace(entries.begin() + index, key, value);
+  int split = LeafPage::SplitIndex(entries, true);
+  if (split < 0) {
+    ReleasePages(&path, false);
+    throw Exception("VarKeyBPlusTree found no split for a full leaf page.");
+  }
+  page_id_t new_page_id;
+  auto *page = buffer_pool_manager_->NewPage(&new_page_id);
+  if (page == nullptr) {
+    ReleasePages(&path, false);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while VarKeyBPlusTree splitting.");
+  }
+  // a new page is filled before a latched page links to it, so it is not latched itself
+  auto *new_leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  new_leaf->Init(new_page_id, leaf->GetParentPageId(), IndexPageType::LEAF_PAGE);
+  new_leaf->SetEntries(entries.begin() + split, entries.end());
+  leaf->SetEntries(entries.begin(), entries.begin() + split);
+  new_leaf->SetNextPageId(leaf->GetNextPageId());
+  leaf->SetNextPageId(new_page_id);
+
+  // suffix truncation
+  const std::string &left_key = entries[split - 1].first;
+  const std::string &right_key = entries[split].first;
+  size_t common = 0;
+  while (common < left_key.size() && left_key[common] == right_key[common]) {
+    common++;
+  }
+  InsertIntoParent(leaf, right_key.substr(0, common + 1), new_leaf);
+
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  ReleasePages(&path, true);
+  return true;
+}
+
+void VarKeyBPlusTree::ReleasePages(std::vector<Page *> *pages, bool is_dirty) {
+  for (auto *page : *pages) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+  }
+  pages->clear();
+}
+
+/*
+ * Insert constant key & value pair into an empty tree
+ */
+void VarKeyBPlusTree::StartNewTree(const std::string &key, const RID &value) {
+  page_id_t page_id;
+  auto *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while StartNewTree.");
+  }
+  auto *root = reinterpret_cast<LeafPage *>(page->GetData());
+  root->Init(page_id, INVALID_PAGE_ID, IndexPageType::LEAF_PAGE);
+  root->Insert(0, key, value);
+  root_page_id_ = page_id;
+  UpdateRootPageId(1);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
+/*
+ * Insert key (the first key of new_node) & new_node's page id into the parent
+ * of old_node, splitting the parent if it is full. An internal split moves the
+ * middle key up; its child becomes the first (key-less) entry of the new page.
+ */
+void VarKeyBPlusTree::InsertIntoParent(BPlusTreePage *old_node, const std::string &key, BPlusTreePage *new_node) {
+  if (old_node->IsRootPage()) {
+    page_id_t root_page_id;
+    auto *page = buffer_pool_manager_->NewPage(&root_page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while VarKeyBPlusTree growing root.");
+    }
+    auto *root = reinterpret_cast<InternalPage *>(page->GetData());
+    root->Init(root_page_id, INVALID_PAGE_ID, IndexPageType::INTERNAL_PAGE);
+    std::vector<InternalPage::Entry> entries = {{std::string(), old_node->GetPageId()},
+                                                {key, new_node->GetPageId()}};
+    root->SetEntries(entries.begin(), entries.end());
+    old_node->SetParentPageId(root_page_id);
+    new_node->SetParentPageId(root_page_id);
+    root_page_id_ = root_page_id;
+    UpdateRootPageId(0);
+    buffer_pool_manager_->UnpinPage(root_page_id, true);
+    return;
+  }
+
+  page_id_t parent_page_id = old_node->GetParentPageId();
+  auto *parent = reinterpret_cast<InternalPage *>(FetchPage(parent_page_id)->GetData());
+  int index = parent->ValueIndex(old_node->GetPageId()) + 1;
+  new_node->SetParentPageId(parent_page_id);
+  if (parent->Insert(index, key, new_node->GetPageId())) {
+    buffer_pool_manager_->UnpinPage(parent_page_id, true);
+    return;
+  }
+
+  std::vector<InternalPage::Entry> entries;
+  parent->GetEntries(&entries);
+  entries.emplace(entries.begin() + index, key, new_node->GetPageId());
+  int split = InternalPage::SplitIndex(entries, false);
+  if (split < 0) {
+    buffer_pool_manager_->UnpinPage(parent_page_id, false);
+    throw Exception("VarKeyBPlusTree found no split for a full internal page.");
+  }
+  std::string middle_key = std::move(entries[split].first);
+  entries[split].first.clear();
+
+  page_id_t new_page_id;
+  auto *page = buffer_pool_manager_->NewPage(&new_page_id);
+  if (page == nullptr) {
+    buffer_pool_manager_->UnpinPage(parent_page_id, false);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while VarKeyBPlusTree splitting.");
+  }
+  auto *new_internal = reinterpret_cast<InternalPage *>(page->GetData());
+  new_internal->Init(new_page_id, parent->GetParentPageId(), IndexPageType::INTERNAL_PAGE);
+  new_internal->SetEntries(entries.begin() + split, entries.end());
+  parent->SetEntries(entries.begin(), entries.begin() + split);
+  for (auto it = entries.begin() + split; it != entries.end(); ++it) {
+    // the two pages being linked in are already pinned by the caller
+    if (it->second == old_node->GetPageId() || it->second == new_node->GetPageId()) {
+      (it->second == old_node->GetPageId() ? old_node : new_node)->SetParentPageId(new_page_id);
+      continue;
+    }
+    auto *child = reinterpret_cast<BPlusTreePage *>(FetchPage(it->second)->GetData());
+    child->SetParentPageId(new_page_id);
+    buffer_pool_manager_->UnpinPage(it->second, true);
+  }
+
+  InsertIntoParent(parent, middle_key, new_internal);
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  buffer_pool_manager_->UnpinPage(parent_page_id, true);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * Delete key & value pair associated with input key
+ * Only the leaf entry is removed, underfull pages are not merged.
+ */
+void VarKeyBPlusTree::Remove(const std::string &key, Transaction *transaction) {
+  auto *page = FindLeafPage(key, true);
+  if (page == nullptr) {
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->KeyIndex(key);
+  bool found = index < leaf->GetSize() && leaf->KeyAt(index) == key;
+  if (found) {
+    leaf->Remove(index);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), found);
+}
+
+/*****************************************************************************
+ * UTILITIES AND DEBUG
+ *****************************************************************************/
+/*
+ * Update/Insert root page id in header page(where page_id = 0, header_page is
+ * defined under include/page/header_page.h)
+ */
+void VarKeyBPlusTree::UpdateRootPageId(int insert_record) {
+  auto *header_page = static_cast<HeaderPage *>(FetchPage(HEADER_PAGE_ID));
+  if (insert_record != 0) {
+    header_page->InsertRecord(index_name_, root_page_id_);
+  } else {
+    header_page->UpdateRecord(index_name_, root_page_id_);
+  }
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+}
+
+}  // namespace bustub
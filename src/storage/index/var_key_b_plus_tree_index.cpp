@@ -0,0 +1,88 @@
+#include <string>
+#include <vector>
+
+#include "common/exception.h"
+#include "storage/index/var_key_b_plus_tree_index.h"
+
+namespace bustub {
+/*
+ * Constructor
+ */
+VarKeyBPlusTreeIndex::VarKeyBPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager)
+    : Index(metadata), container_(metadata->GetName(), buffer_pool_manager) {}
+
+bool VarKeyBPlusTreeIndex::SupportsKeySchema(const Schema *key_schema) {
+  for (const auto &column : key_schema->GetColumns()) {
+    if (column.GetType() != TypeId::VARCHAR) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string VarKeyBPlusTreeIndex::EncodeKey(const Tuple &key) const {
+  const Schema *key_schema = GetKeySchema();
+  std::string encoded;
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    Value value = key.GetValue(key_schema, i);
+    if (value.IsNull()) {
+      encoded.push_back('\x00');
+      continue;
+    }
+    encoded.push_back('\x01');
+    for (char c : value.ToString()) {
+      encoded.push_back(c);
+      if (c == '\x00') {
+        encoded.push_back('\xff');
+      }
+    }
+    encoded.append(2, '\x00');
+  }
+  return encoded;
+}
+
+std::string VarKeyBPlusTreeIndex::EncodeEntry(const Tuple &key, RID rid) const {
+  std::string encoded = EncodeKey(key);
+  // big endian, so entries of a key are in RID order
+  for (uint32_t part : {static_cast<uint32_t>(rid.GetPageId()), rid.GetSlotNum()}) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      encoded.push_back(static_cast<char>((part >> shift) & 0xff));
+    }
+  }
+  return encoded;
+}
+
+void VarKeyBPlusTreeIndex::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  std::string entry = EncodeEntry(key, rid);
+  if (entry.size() > SLOTTED_PAGE_MAX_KEY_SIZE) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "VarKeyBPlusTreeIndex: key of index " + GetName() + " is too long");
+  }
+  container_.Insert(entry, rid, transaction);
+}
+
+void VarKeyBPlusTreeIndex::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_.Remove(EncodeEntry(key, rid), transaction);
+}
+
+void VarKeyBPlusTreeIndex::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  // the terminators keep an encoded key from being a prefix of another key
+  std::string prefix = EncodeKey(key);
+  container_.Scan(
+      prefix,
+      [&](const std::string &entry, const RID &rid) {
+        if (entry.compare(0, prefix.size(), prefix) != 0) {
+          return false;
+        }
+        result->push_back(rid);
+        return true;
+      },
+      transaction);
+}
+
+void VarKeyBPlusTreeIndex::Scan(const std::string &lo,
+                                const std::function<bool(const std::string &, const RID &)> &func,
+                                Transaction *transaction) {
+  container_.Scan(lo, func, transaction);
+}
+
+}  // namespace bustub
@@ -34,6 +34,8 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id
   //
   SetParentPageId(parent_id);
   //
+  SetNextPageId(INVALID_PAGE_ID);
+  //
   SetMaxSize(max_size);
 }
 /*
@@ -69,6 +71,53 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const {
   return GetSize();
 }
 
+/*
+ * Same as ValueIndex(value), but values are not ordered, so use a key that
+ * lies in the child's subtree (e.g. its first key) to binary search for the
+ * slot first; only fall back to the full scan if the hint misses.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value, const KeyType &key,
+                                               const KeyComparator &comparator) const {
+  int index = ChildIndex(key, comparator);
+  if (array[index].second == value) {
+    return index;
+  }
+  return ValueIndex(value);
+}
+
+/*
+ * Helper method to find the index of the child whose subtree contains key,
+ * i.e. the last index i so that i == 0 or array[i].first <= key, which is
+ * the number of keys <= key among KEY(1)..KEY(n-1).
+ * Branch-free binary search over those keys, see
+ * BPlusTreeLeafPage::KeyIndex().
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ChildIndex(const KeyType &key, const KeyComparator &comparator) const {
+  if (GetSize() <= 1) {
+    return 0;
+  }
+  const MappingType *base = array + 1;
+  int len = GetSize() - 1;
+  if (comparator.IsIntegerComparable()) {
+    uint64_t target = comparator.ToInteger(key);
+    while (len > KeyComparator::SCAN_WINDOW) {
+      int half = len / 2;
+      base = comparator.ToInteger(base[half].first) <= target ? base + half : base;
+      len -= half;
+    }
+    return static_cast<int>(base - array) - 1 +
+           comparator.CountLess(&base->first, sizeof(MappingType), len, target, true);
+  }
+  while (len > 1) {
+    int half = len / 2;
+    base = comparator(base[half].first, key) <= 0 ? base + half : base;
+    len -= half;
+  }
+  return static_cast<int>(base - array) - (comparator(base->first, key) <= 0 ? 0 : 1);
+}
+
 /*
  * Helper method to get the value associated with input "index"(a.k.a array
  * offset)
@@ -85,6 +134,22 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &valu
   assert(0 <= index && index < GetSize());
   array[index].second = value;
 }
+
+/*
+ * Helper methods to get/set the B-link right link and high key. The high key
+ * is only valid when the right link is valid.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetNextPageId() const { return next_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetHighKey() const { return high_key_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetHighKey(const KeyType &key) { high_key_ = key; }
 /*****************************************************************************
  * LOOKUP
  *****************************************************************************/
@@ -96,27 +161,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &valu
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
   assert(GetSize() > 1);
-  if (comparator(key, array[1].first) < 0) {
-    return array[0].second;
-  }
-  else if (comparator(key, array[GetSize() - 1].first) >= 0) {
-    return array[GetSize() - 1].second;
-  }  
-  int low = 1, high = GetSize() - 1, mid;
-  while (low <= high) {
-    // 二分查找 左闭右闭
-    mid = low + (high - low) / 2;
-    if (comparator(key, array[mid].first) < 0) {
-      high = mid - 1;
-    }
-    else if (comparator(key, array[mid].first) > 0) {
-      low = mid + 1;
-    }else {
-      return array[mid].second;
-    }
-  }
-  return array[low].second;
-
+  return array[ChildIndex(key, comparator)].second;
 }
 
 /*****************************************************************************
@@ -158,6 +203,26 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value,
   return GetSize();
 }
 
+/*
+ * Insert new_key & new_value pair at the position given by key order. Unlike
+ * InsertNodeAfter() this does not need the left neighbour of the new child to
+ * be present in this page, which is what B-link splits rely on.
+ * @return:  new size after insertion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value,
+                                           const KeyComparator &comparator) {
+  assert(GetSize() < GetMaxSize());
+  int index = GetSize();
+  while (index > 1 && comparator(key, array[index - 1].first) < 0) {
+    array[index] = array[index - 1];
+    --index;
+  }
+  array[index] = {key, value};
+  IncreaseSize(1);
+  return GetSize();
+}
+
 /*****************************************************************************
  * SPLIT
  *****************************************************************************/
@@ -254,7 +319,13 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient,
 
   buffer_pool_manager->UnpinPage(parent->GetPageId(), true);
 
-  recipient->CopyNFrom(array, GetSize(), buffer_pool_manager);  
+  // 追加到 recipient 的末尾，CopyNFrom 只能用于刚 Init 的空页面
+  assert(recipient->GetSize() + GetSize() <= recipient->GetMaxSize());
+  int start = recipient->GetSize();
+  for (int i = 0; i < GetSize(); ++i) {
+    recipient->array[start + i] = array[i];
+  }
+  recipient->IncreaseSize(GetSize());
   // 更新孩子节点的父节点id
   for (auto index = 0; index < GetSize(); ++index) {
     auto *page = buffer_pool_manager->FetchPage(ValueAt(index));
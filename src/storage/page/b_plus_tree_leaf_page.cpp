@@ -9,12 +9,15 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <sstream>
+#include <utility>
 
 #include "common/exception.h"
 #include "common/rid.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 #include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_posting_page.h"
 
 namespace bustub {
 
@@ -38,6 +41,8 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, in
   SetParentPageId(parent_id);
   //
   SetNextPageId(INVALID_PAGE_ID);
+  SetPrevPageId(INVALID_PAGE_ID);
+  num_lists_ = 0;
   //
   SetMaxSize(max_size);
 }
@@ -51,18 +56,56 @@ page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const { return next_page_i
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
+/**
+ * Helper methods to set/get prev page id
+ */
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetPrevPageId() const { return prev_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetPrevPageId(page_id_t prev_page_id) { prev_page_id_ = prev_page_id; }
+
+/**
+ * Helper methods to set/get the high key (B-link upper bound, valid only when
+ * next page id is valid)
+ */
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::GetHighKey() const { return high_key_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetHighKey(const KeyType &key) { high_key_ = key; }
+
 /**
  * Helper method to find the first index i so that array[i].first >= key
- * NOTE: This method is only used when generating index iterator
+ * Branch-free binary search: the loop always runs log2(size) times and the
+ * comparison result only selects the next base, so it compiles to a
+ * conditional move instead of a hard to predict branch.
+ *
+ * Keys that compare as integers are searched on those instead, and the last
+ * SCAN_WINDOW candidates are counted with SIMD compares.
  */
 INDEX_TEMPLATE_ARGUMENTS
-int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const { 
-  for (int i = 0; i < GetSize(); ++i) {
-    if (comparator(key, array[i].first) <= 0) {
-      return i;
+int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
+  if (GetSize() == 0) {
+    return 0;
+  }
+  const MappingType *base = array;
+  int len = GetSize();
+  if (comparator.IsIntegerComparable()) {
+    uint64_t target = comparator.ToInteger(key);
+    while (len > KeyComparator::SCAN_WINDOW) {
+      int half = len / 2;
+      base = comparator.ToInteger(base[half].first) < target ? base + half : base;
+      len -= half;
     }
+    return static_cast<int>(base - array) + comparator.CountLess(&base->first, sizeof(MappingType), len, target, false);
+  }
+  while (len > 1) {
+    int half = len / 2;
+    base = comparator(base[half].first, key) < 0 ? base + half : base;
+    len -= half;
   }
-  return GetSize();  
+  return static_cast<int>(base - array) + (comparator(base->first, key) < 0 ? 1 : 0);
 }
 
 /*
@@ -87,6 +130,230 @@ const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) {
   return array[index];
 }
 
+/*
+ * Helper method to replace the value associated with input "index"
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
+  assert(0 <= index && index < GetSize());
+  array[index].first = key;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  assert(0 <= index && index < GetSize());
+  array[index].second = value;
+}
+
+/*****************************************************************************
+ * VALUE LISTS
+ *****************************************************************************/
+/*
+ * Inline lists are stored back to front from the end of the page, so list i
+ * starts i + 1 lists before the end. An entry refers to its list by index,
+ * as RID(list index, INLINE_LIST_SLOT).
+ */
+INDEX_TEMPLATE_ARGUMENTS
+typename B_PLUS_TREE_LEAF_PAGE_TYPE::InlineList *B_PLUS_TREE_LEAF_PAGE_TYPE::ListAt(int list_index) {
+  assert(0 <= list_index && list_index < num_lists_);
+  return reinterpret_cast<InlineList *>(reinterpret_cast<char *>(this) + PAGE_SIZE) - (list_index + 1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+const typename B_PLUS_TREE_LEAF_PAGE_TYPE::InlineList *B_PLUS_TREE_LEAF_PAGE_TYPE::ListAt(int list_index) const {
+  assert(0 <= list_index && list_index < num_lists_);
+  return reinterpret_cast<const InlineList *>(reinterpret_cast<const char *>(this) + PAGE_SIZE) - (list_index + 1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::Fits(int size, int num_lists) const {
+  auto entries_end = static_cast<size_t>(reinterpret_cast<const char *>(array + size) -
+                                         reinterpret_cast<const char *>(this));
+  return entries_end + num_lists * sizeof(InlineList) <= PAGE_SIZE;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::IsList(const ValueType &value) {
+  return IsInlineList(value) || BPlusTreePostingPage::IsPostingList(value);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::GetValues(const ValueType &value, std::vector<ValueType> *values,
+                                           BufferPoolManager *buffer_pool_manager) const {
+  if (IsInlineList(value)) {
+    const InlineList *list = ListAt(value.GetPageId());
+    values->insert(values->end(), list->values_, list->values_ + list->size_);
+  } else if (BPlusTreePostingPage::IsPostingList(value)) {
+    BPlusTreePostingPage::GetListRids(buffer_pool_manager, value.GetPageId(), values);
+  } else {
+    values->push_back(value);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_LEAF_PAGE_TYPE::NewList(const std::vector<ValueType> &values,
+                                              BufferPoolManager *buffer_pool_manager) {
+  if (values.size() > static_cast<size_t>(INLINE_LIST_SIZE) || !Fits(GetSize(), num_lists_ + 1)) {
+    return BPlusTreePostingPage::PostingListRid(BPlusTreePostingPage::CreateList(buffer_pool_manager, values));
+  }
+  num_lists_++;
+  InlineList *list = ListAt(num_lists_ - 1);
+  list->size_ = static_cast<int>(values.size());
+  std::copy(values.begin(), values.end(), list->values_);
+  return ValueType(num_lists_ - 1, INLINE_LIST_SLOT);
+}
+
+/*
+ * The last list takes the place of the deleted one, so the lists stay packed
+ * against the end of the page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::DeleteInlineList(int list_index) {
+  int last = num_lists_ - 1;
+  if (list_index != last) {
+    *ListAt(list_index) = *ListAt(last);
+    for (int i = 0; i < GetSize(); i++) {
+      if (array[i].second == ValueType(last, INLINE_LIST_SLOT)) {
+        array[i].second = ValueType(list_index, INLINE_LIST_SLOT);
+        break;
+      }
+    }
+  }
+  num_lists_--;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SpillInlineList(int index, BufferPoolManager *buffer_pool_manager) {
+  int list_index = array[index].second.GetPageId();
+  const InlineList *list = ListAt(list_index);
+  std::vector<ValueType> values(list->values_, list->values_ + list->size_);
+  array[index].second =
+      BPlusTreePostingPage::PostingListRid(BPlusTreePostingPage::CreateList(buffer_pool_manager, values));
+  DeleteInlineList(list_index);
+}
+
+/*
+ * The second value of a key starts an inline list; a list that outgrows
+ * INLINE_LIST_SIZE moves to a posting list. Values are kept sorted either way.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::InsertValue(int index, const ValueType &value,
+                                             BufferPoolManager *buffer_pool_manager) {
+  assert(0 <= index && index < GetSize());
+  ValueType current = array[index].second;
+  if (BPlusTreePostingPage::IsPostingList(current)) {
+    return BPlusTreePostingPage::InsertIntoList(buffer_pool_manager, current.GetPageId(), value);
+  }
+  if (!IsInlineList(current)) {
+    if (current == value) {
+      return false;
+    }
+    std::vector<ValueType> values{current, value};
+    std::sort(values.begin(), values.end(), BPlusTreePostingPage::RidLess);
+    array[index].second = NewList(values, buffer_pool_manager);
+    return true;
+  }
+  InlineList *list = ListAt(current.GetPageId());
+  ValueType *end = list->values_ + list->size_;
+  ValueType *it = std::lower_bound(list->values_, end, value, BPlusTreePostingPage::RidLess);
+  if (it != end && *it == value) {
+    return false;
+  }
+  if (list->size_ == INLINE_LIST_SIZE) {
+    SpillInlineList(index, buffer_pool_manager);
+    return BPlusTreePostingPage::InsertIntoList(buffer_pool_manager, array[index].second.GetPageId(), value);
+  }
+  std::move_backward(it, end, end + 1);
+  *it = value;
+  list->size_++;
+  return true;
+}
+
+/*
+ * A list left with one value turns back into that plain value.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveValue(int index, const ValueType &value,
+                                             BufferPoolManager *buffer_pool_manager) {
+  assert(0 <= index && index < GetSize() && IsList(array[index].second));
+  ValueType current = array[index].second;
+  if (BPlusTreePostingPage::IsPostingList(current)) {
+    page_id_t head_page_id = current.GetPageId();
+    if (!BPlusTreePostingPage::RemoveFromList(buffer_pool_manager, head_page_id, value)) {
+      return false;
+    }
+    if (BPlusTreePostingPage::GetListSize(buffer_pool_manager, head_page_id) == 1) {
+      std::vector<ValueType> values;
+      BPlusTreePostingPage::GetListRids(buffer_pool_manager, head_page_id, &values);
+      BPlusTreePostingPage::DeleteList(buffer_pool_manager, head_page_id);
+      array[index].second = values[0];
+    }
+    return true;
+  }
+  InlineList *list = ListAt(current.GetPageId());
+  ValueType *end = list->values_ + list->size_;
+  ValueType *it = std::find(list->values_, end, value);
+  if (it == end) {
+    return false;
+  }
+  std::move(it + 1, end, it);
+  if (--list->size_ == 1) {
+    array[index].second = list->values_[0];
+    DeleteInlineList(current.GetPageId());
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::DeleteValues(int index, BufferPoolManager *buffer_pool_manager) {
+  assert(0 <= index && index < GetSize());
+  if (BPlusTreePostingPage::IsPostingList(array[index].second)) {
+    BPlusTreePostingPage::DeleteList(buffer_pool_manager, array[index].second.GetPageId());
+  }
+}
+
+/*
+ * Spill the list stored last, which is the cheapest to delete, until the
+ * entries fit.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MakeRoomForEntries(int count, BufferPoolManager *buffer_pool_manager) {
+  while (num_lists_ > 0 && !Fits(GetSize() + count, num_lists_)) {
+    for (int i = 0; i < GetSize(); i++) {
+      if (array[i].second == ValueType(num_lists_ - 1, INLINE_LIST_SLOT)) {
+        SpillInlineList(i, buffer_pool_manager);
+        break;
+      }
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::AdoptLists(const BPlusTreeLeafPage *donor, int begin, int count,
+                                            BufferPoolManager *buffer_pool_manager) {
+  for (int i = begin; i < begin + count; i++) {
+    if (IsInlineList(array[i].second)) {
+      const InlineList *list = donor->ListAt(array[i].second.GetPageId());
+      array[i].second = NewList(std::vector<ValueType>(list->values_, list->values_ + list->size_), buffer_pool_manager);
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::CompactLists() {
+  std::vector<std::pair<int, InlineList>> lists;
+  for (int i = 0; i < GetSize(); i++) {
+    if (IsInlineList(array[i].second)) {
+      lists.emplace_back(i, *ListAt(array[i].second.GetPageId()));
+    }
+  }
+  num_lists_ = static_cast<int>(lists.size());
+  for (int list_index = 0; list_index < num_lists_; list_index++) {
+    *ListAt(list_index) = lists[list_index].second;
+    array[lists[list_index].first].second = ValueType(list_index, INLINE_LIST_SLOT);
+  }
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -100,33 +367,17 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &valu
   if (GetSize() == 0 || comparator(key, KeyAt(GetSize() - 1)) > 0) {
     array[GetSize()] = {key, value};
   }
-  // 要插入的值比当前最小的还小,赶紧给我腾位置 array 
-  else if (comparator(key, array[0].first) < 0) {
-    memmove(array + 1, array, static_cast<size_t>(GetSize() * sizeof(MappingType)));
-    array[0] = {key, value};
-  }
   else {
-    int low = 0, high = GetSize() - 1, mid;
-    while (low <= high) {
-      mid = low + (high - low) / 2;
-      if (comparator(key, KeyAt(mid)) > 0) {
-        low = mid + 1;
-      }
-      else if (comparator(key, KeyAt(mid)) < 0) {
-        high = mid - 1;
-      }
-      else {
-        // 由于不支持重复的key， 所以不应该执行到这里
-        assert(0);
-      }
-    }
-    //找到该插入的位置了为high，接下来将它右面的东西移动一下
-    memmove(array + high + 1, array + high, static_cast<size_t>(GetSize() - high) * sizeof(MappingType));
-    array[high] = {key, value};
+    int index = KeyIndex(key, comparator);
+    // 由于不支持重复的key， 所以不应该找到相等的key
+    assert(comparator(key, array[index].first) != 0);
+    //找到该插入的位置了为index，接下来将它右面的东西移动一下
+    memmove(array + index + 1, array + index, static_cast<size_t>(GetSize() - index) * sizeof(MappingType));
+    array[index] = {key, value};
   }
 
   IncreaseSize(1);
-  assert(GetSize() <= GetMaxSize());
+  assert(GetSize() <= GetMaxSize() && Fits(GetSize(), num_lists_));
   return GetSize();    
 }
 
@@ -141,8 +392,12 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient, Buffer
   assert(GetSize() > 0);
   int size = GetSize() / 2;
   MappingType *src = array + GetSize() - size;
+  int begin = recipient->GetSize();
+  recipient->MakeRoomForEntries(size, buffer_pool_manager);
   recipient->CopyNFrom(src, size);
+  recipient->AdoptLists(this, begin, size, buffer_pool_manager);
   this->IncreaseSize(-1 * size);
+  CompactLists();
 }
  
 /*
@@ -170,23 +425,12 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value, const KeyComparator &comparator) const {
-  if (GetSize() == 0 || comparator(key, KeyAt(0)) < 0 || comparator(key, KeyAt(GetSize() - 1)) > 0)
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(key, array[index].first) != 0) {
     return false;
-  int low = 0, high = GetSize() - 1, mid;
-  while (low <= high) {
-    mid = low + (high - low) / 2;
-    if (comparator(key, KeyAt(mid)) > 0) {
-      low = mid + 1;
-    }
-    else if (comparator(key, KeyAt(mid)) < 0) {
-      high = mid - 1;
-    }
-    else {
-      value = array[mid].second;
-      return true;
-    }
   }
-  return false;
+  value = array[index].second;
+  return true;
 }
 
 /*****************************************************************************
@@ -200,24 +444,15 @@ bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value, co
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
-  if (GetSize() == 0 || comparator(key, KeyAt(0)) < 0 || comparator(key, KeyAt(GetSize() - 1)) > 0 ) {
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(key, array[index].first) != 0) {
     return GetSize();
   }
-  int low = 0, high = GetSize() - 1, mid;
-  while (low <= high) {
-    mid = low + (high - low) / 2;
-    if (comparator(key, KeyAt(mid)) > 0) {
-      low = mid + 1;
-    }
-    else if (comparator(key, KeyAt(mid)) < 0) {
-      high = mid - 1;
-    }
-    else {
-      memmove(array + mid, array + mid + 1, static_cast<size_t>((GetSize() - mid - 1) * sizeof(MappingType)));
-      IncreaseSize(-1);
-      break;
-    }
+  if (IsInlineList(array[index].second)) {
+    DeleteInlineList(array[index].second.GetPageId());
   }
+  memmove(array + index, array + index + 1, static_cast<size_t>((GetSize() - index - 1) * sizeof(MappingType)));
+  IncreaseSize(-1);
   return GetSize();
 }
 
@@ -229,8 +464,11 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const
  * to update the next_page id in the sibling page
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient, int, BufferPoolManager *) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient, int, BufferPoolManager *buffer_pool_manager) {
+  int begin = recipient->GetSize();
+  recipient->MakeRoomForEntries(GetSize(), buffer_pool_manager);
   recipient->CopyNFrom(array, GetSize());
+  recipient->AdoptLists(this, begin, GetSize(), buffer_pool_manager);
   // ?这块不应该是从 x 拷贝 到 y 吗？不应该是设置 x 的 NextPageId？怎么变成了设置 y 的 NextPageId？？？
   recipient->SetNextPageId(GetNextPageId());
 }
@@ -247,7 +485,10 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient,
   IncreaseSize(-1);
   memmove(array, array + 1, static_cast<size_t>(GetSize() * sizeof(MappingType)));
 
+  recipient->MakeRoomForEntries(1, buffer_pool_manager);
   recipient->CopyLastFrom(pair);
+  recipient->AdoptLists(this, recipient->GetSize() - 1, 1, buffer_pool_manager);
+  CompactLists();
 
   auto *page = buffer_pool_manager->FetchPage(GetParentPageId());
   if (page == nullptr)
@@ -258,7 +499,8 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient,
  
   auto parent = reinterpret_cast<BPlusTreeInternalPage<KeyType, decltype(GetPageId()), KeyComparator> *>(page->GetData());
 
-  parent->SetKeyAt(parent->ValueIndex(GetPageId()), pair.first);
+  // 父节点中的分隔键要变成本页新的第一个键
+  parent->SetKeyAt(parent->ValueIndex(GetPageId()), array[0].first);
 
   buffer_pool_manager->UnpinPage(GetParentPageId(), true);
 }
@@ -280,7 +522,10 @@ INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient, int parent_index, BufferPoolManager *buffer_pool_manager) {
   MappingType pair = GetItem(GetSize() - 1);
   IncreaseSize(-1);
+  recipient->MakeRoomForEntries(1, buffer_pool_manager);
   recipient->CopyFirstFrom(pair, parent_index, buffer_pool_manager);
+  recipient->AdoptLists(this, 0, 1, buffer_pool_manager);
+  CompactLists();
 }
 
 /*
@@ -0,0 +1,277 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/b_plus_tree_posting_page.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+
+#include "common/exception.h"
+#include "storage/page/b_plus_tree_posting_page.h"
+
+namespace bustub {
+
+namespace {
+// RIDs ordered as unsigned (page id, slot) pairs
+inline uint64_t RidKey(const RID &rid) {
+  return static_cast<uint64_t>(static_cast<uint32_t>(rid.GetPageId())) << 32 | rid.GetSlotNum();
+}
+
+inline RID KeyRid(uint64_t key) {
+  return RID(static_cast<page_id_t>(static_cast<uint32_t>(key >> 32)), static_cast<uint32_t>(key));
+}
+}  // namespace
+
+bool BPlusTreePostingPage::RidLess(const RID &lhs, const RID &rhs) { return RidKey(lhs) < RidKey(rhs); }
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+/**
+ * Init method after creating a new posting page
+ */
+void BPlusTreePostingPage::Init() {
+  next_page_id_ = INVALID_PAGE_ID;
+  size_ = 0;
+  list_size_ = 0;
+  bytes_used_ = 0;
+  last_rid_ = 0;
+}
+
+void BPlusTreePostingPage::GetRids(std::vector<RID> *rids) const {
+  uint64_t key = 0;
+  int offset = 0;
+  for (int i = 0; i < size_; i++) {
+    uint64_t delta = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+      byte = data_[offset++];
+      delta |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      shift += 7;
+    } while ((byte & 0x80) != 0);
+    key += delta;
+    rids->push_back(KeyRid(key));
+  }
+}
+
+int BPlusTreePostingPage::SetRids(const RID *rids, int count) {
+  uint64_t prev = 0;
+  int offset = 0;
+  int stored = 0;
+  for (; stored < count; stored++) {
+    uint64_t key = RidKey(rids[stored]);
+    uint64_t delta = key - prev;
+    // a varint of a 64 bit value takes at most 10 bytes
+    uint8_t buf[10];
+    int len = 0;
+    do {
+      buf[len] = static_cast<uint8_t>(delta & 0x7f);
+      delta >>= 7;
+      if (delta != 0) {
+        buf[len] |= 0x80;
+      }
+      len++;
+    } while (delta != 0);
+    if (offset + len > static_cast<int>(POSTING_PAGE_DATA_SIZE)) {
+      break;
+    }
+    memcpy(data_ + offset, buf, len);
+    offset += len;
+    prev = key;
+  }
+  size_ = stored;
+  bytes_used_ = offset;
+  last_rid_ = prev;
+  return stored;
+}
+
+BPlusTreePostingPage *BPlusTreePostingPage::FetchPostingPage(BufferPoolManager *buffer_pool_manager,
+                                                             page_id_t page_id) {
+  auto *page = buffer_pool_manager->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while fetching posting page");
+  }
+  return reinterpret_cast<BPlusTreePostingPage *>(page->GetData());
+}
+
+BPlusTreePostingPage *BPlusTreePostingPage::NewPostingPage(BufferPoolManager *buffer_pool_manager,
+                                                           page_id_t *page_id) {
+  auto *page = buffer_pool_manager->NewPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "all page are pinned while creating posting page");
+  }
+  auto *posting_page = reinterpret_cast<BPlusTreePostingPage *>(page->GetData());
+  posting_page->Init();
+  return posting_page;
+}
+
+page_id_t BPlusTreePostingPage::FindPage(BufferPoolManager *buffer_pool_manager, page_id_t head_page_id,
+                                         const RID &rid, page_id_t *prev_page_id) {
+  page_id_t page_id = head_page_id;
+  *prev_page_id = INVALID_PAGE_ID;
+  while (true) {
+    auto *page = FetchPostingPage(buffer_pool_manager, page_id);
+    page_id_t next_page_id = page->GetNextPageId();
+    bool found = next_page_id == INVALID_PAGE_ID || (page->GetSize() > 0 && RidKey(rid) <= page->last_rid_);
+    buffer_pool_manager->UnpinPage(page_id, false);
+    if (found) {
+      return page_id;
+    }
+    *prev_page_id = page_id;
+    page_id = next_page_id;
+  }
+}
+
+/*****************************************************************************
+ * POSTING LIST
+ *****************************************************************************/
+/*
+ * Create a posting list holding first and second, return its head page id
+ */
+page_id_t BPlusTreePostingPage::CreateList(BufferPoolManager *buffer_pool_manager, const RID &first,
+                                           const RID &second) {
+  page_id_t head_page_id;
+  auto *head = NewPostingPage(buffer_pool_manager, &head_page_id);
+  RID rids[2] = {first, second};
+  if (RidLess(second, first)) {
+    std::swap(rids[0], rids[1]);
+  }
+  head->SetRids(rids, 2);
+  head->list_size_ = 2;
+  buffer_pool_manager->UnpinPage(head_page_id, true);
+  return head_page_id;
+}
+
+page_id_t BPlusTreePostingPage::CreateList(BufferPoolManager *buffer_pool_manager, const std::vector<RID> &rids) {
+  assert(rids.size() >= 2);
+  page_id_t head_page_id = CreateList(buffer_pool_manager, rids[0], rids[1]);
+  for (size_t i = 2; i < rids.size(); i++) {
+    InsertIntoList(buffer_pool_manager, head_page_id, rids[i]);
+  }
+  return head_page_id;
+}
+
+/*
+ * Insert rid into the page whose run covers it, splitting that page in half
+ * (into a new page linked right after it) if the run no longer fits.
+ */
+bool BPlusTreePostingPage::InsertIntoList(BufferPoolManager *buffer_pool_manager, page_id_t head_page_id,
+                                          const RID &rid) {
+  page_id_t prev_page_id;
+  page_id_t page_id = FindPage(buffer_pool_manager, head_page_id, rid, &prev_page_id);
+  auto *page = FetchPostingPage(buffer_pool_manager, page_id);
+  std::vector<RID> rids;
+  page->GetRids(&rids);
+  auto it = std::lower_bound(rids.begin(), rids.end(), rid, RidLess);
+  if (it != rids.end() && RidKey(*it) == RidKey(rid)) {
+    buffer_pool_manager->UnpinPage(page_id, false);
+    return false;
+  }
+  rids.insert(it, rid);
+  int size = static_cast<int>(rids.size());
+  if (page->SetRids(rids.data(), size) < size) {
+    int half = size / 2;
+    page->SetRids(rids.data(), half);
+    page_id_t new_page_id;
+    auto *new_page = NewPostingPage(buffer_pool_manager, &new_page_id);
+    new_page->SetRids(rids.data() + half, size - half);
+    new_page->SetNextPageId(page->GetNextPageId());
+    page->SetNextPageId(new_page_id);
+    buffer_pool_manager->UnpinPage(new_page_id, true);
+  }
+  buffer_pool_manager->UnpinPage(page_id, true);
+
+  auto *head = FetchPostingPage(buffer_pool_manager, head_page_id);
+  head->list_size_++;
+  buffer_pool_manager->UnpinPage(head_page_id, true);
+  return true;
+}
+
+/*
+ * Remove rid from the list. A page left empty is unlinked and deleted; if it
+ * is the head, the second page is pulled into it so the head page id (which
+ * the leaf points to) stays valid.
+ */
+bool BPlusTreePostingPage::RemoveFromList(BufferPoolManager *buffer_pool_manager, page_id_t head_page_id,
+                                          const RID &rid) {
+  page_id_t prev_page_id;
+  page_id_t page_id = FindPage(buffer_pool_manager, head_page_id, rid, &prev_page_id);
+  auto *page = FetchPostingPage(buffer_pool_manager, page_id);
+  std::vector<RID> rids;
+  page->GetRids(&rids);
+  auto it = std::lower_bound(rids.begin(), rids.end(), rid, RidLess);
+  if (it == rids.end() || RidKey(*it) != RidKey(rid)) {
+    buffer_pool_manager->UnpinPage(page_id, false);
+    return false;
+  }
+  rids.erase(it);
+
+  page_id_t next_page_id = page->GetNextPageId();
+  if (!rids.empty()) {
+    page->SetRids(rids.data(), static_cast<int>(rids.size()));
+    buffer_pool_manager->UnpinPage(page_id, true);
+  } else if (page_id != head_page_id) {
+    buffer_pool_manager->UnpinPage(page_id, false);
+    buffer_pool_manager->DeletePage(page_id);
+    auto *prev = FetchPostingPage(buffer_pool_manager, prev_page_id);
+    prev->SetNextPageId(next_page_id);
+    buffer_pool_manager->UnpinPage(prev_page_id, true);
+  } else if (next_page_id != INVALID_PAGE_ID) {
+    auto *next = FetchPostingPage(buffer_pool_manager, next_page_id);
+    next->GetRids(&rids);
+    page->SetNextPageId(next->GetNextPageId());
+    buffer_pool_manager->UnpinPage(next_page_id, false);
+    buffer_pool_manager->DeletePage(next_page_id);
+    page->SetRids(rids.data(), static_cast<int>(rids.size()));
+    buffer_pool_manager->UnpinPage(page_id, true);
+  } else {
+    page->SetRids(nullptr, 0);
+    buffer_pool_manager->UnpinPage(page_id, true);
+  }
+
+  auto *head = FetchPostingPage(buffer_pool_manager, head_page_id);
+  head->list_size_--;
+  buffer_pool_manager->UnpinPage(head_page_id, true);
+  return true;
+}
+
+/*
+ * Append all RIDs of the list to rids, in order
+ */
+void BPlusTreePostingPage::GetListRids(BufferPoolManager *buffer_pool_manager, page_id_t head_page_id,
+                                       std::vector<RID> *rids) {
+  page_id_t page_id = head_page_id;
+  while (page_id != INVALID_PAGE_ID) {
+    auto *page = FetchPostingPage(buffer_pool_manager, page_id);
+    page->GetRids(rids);
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+int BPlusTreePostingPage::GetListSize(BufferPoolManager *buffer_pool_manager, page_id_t head_page_id) {
+  auto *head = FetchPostingPage(buffer_pool_manager, head_page_id);
+  int list_size = head->list_size_;
+  buffer_pool_manager->UnpinPage(head_page_id, false);
+  return list_size;
+}
+
+void BPlusTreePostingPage::DeleteList(BufferPoolManager *buffer_pool_manager, page_id_t head_page_id) {
+  page_id_t page_id = head_page_id;
+  while (page_id != INVALID_PAGE_ID) {
+    auto *page = FetchPostingPage(buffer_pool_manager, page_id);
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    buffer_pool_manager->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,271 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/b_plus_tree_slotted_page.cpp
+//
+// Copyright (c) 2018, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+
+#include "common/rid.h"
+#include "storage/page/b_plus_tree_slotted_page.h"
+
+namespace bustub {
+
+/*****************************************************************************
+ * HELPER METHODS AND UTILITIES
+ *****************************************************************************/
+/*
+ * Init method after creating a new slotted page
+ */
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::Init(page_id_t page_id, page_id_t parent_id, IndexPageType page_type) {
+  SetPageType(page_type);
+  SetSize(0);
+  SetPageId(page_id);
+  SetParentPageId(parent_id);
+  // capacity depends on the key sizes, splits are driven by free space
+  SetMaxSize(0);
+  next_page_id_ = INVALID_PAGE_ID;
+  prefix_size_ = 0;
+  data_start_ = SLOTTED_PAGE_DATA_SIZE;
+}
+
+template <typename ValueType>
+int BPlusTreeSlottedPage<ValueType>::FreeSpace() const {
+  return data_start_ - static_cast<int>(SlotArrayOffset(prefix_size_)) - GetSize() * static_cast<int>(sizeof(Slot));
+}
+
+/*
+ * Insert() rebuilds the page for a key outside the prefix, so the bound is the
+ * size of the page rebuilt with every key stored in full, plus the new entry
+ * and a padding byte.
+ */
+template <typename ValueType>
+bool BPlusTreeSlottedPage<ValueType>::HasRoomFor(size_t key_size) const {
+  size_t bytes = (GetSize() + 1) * (sizeof(Slot) + sizeof(ValueType)) + key_size + 1;
+  for (int i = FirstKeyIndex(); i < GetSize(); i++) {
+    bytes += prefix_size_ + Slots()[i].suffix_size_;
+  }
+  return bytes <= SLOTTED_PAGE_DATA_SIZE;
+}
+
+template <typename ValueType>
+std::string_view BPlusTreeSlottedPage<ValueType>::SuffixAt(int index) const {
+  const Slot &slot = Slots()[index];
+  return std::string_view(data_ + slot.offset_ + sizeof(ValueType), slot.suffix_size_);
+}
+
+template <typename ValueType>
+std::string BPlusTreeSlottedPage<ValueType>::KeyAt(int index) const {
+  assert(0 <= index && index < GetSize());
+  if (index < FirstKeyIndex()) {
+    return std::string();
+  }
+  std::string key(GetPrefix());
+  key.append(SuffixAt(index));
+  return key;
+}
+
+template <typename ValueType>
+ValueType BPlusTreeSlottedPage<ValueType>::ValueAt(int index) const {
+  assert(0 <= index && index < GetSize());
+  ValueType value;
+  memcpy(&value, data_ + Slots()[index].offset_, sizeof(ValueType));
+  return value;
+}
+
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::SetValueAt(int index, const ValueType &value) {
+  memcpy(data_ + Slots()[index].offset_, &value, sizeof(ValueType));
+}
+
+/*****************************************************************************
+ * LOOKUP
+ *****************************************************************************/
+/*
+ * The key is compared with the page prefix once; only when it starts with the
+ * prefix is the binary search over the suffixes needed.
+ */
+template <typename ValueType>
+int BPlusTreeSlottedPage<ValueType>::Bound(std::string_view key, bool upper) const {
+  int lo = FirstKeyIndex();
+  int hi = GetSize();
+  int cmp = key.compare(0, prefix_size_, GetPrefix());
+  if (cmp != 0) {
+    return cmp < 0 ? lo : hi;
+  }
+  key.remove_prefix(prefix_size_);
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    int mid_cmp = SuffixAt(mid).compare(key);
+    if (mid_cmp < 0 || (upper && mid_cmp == 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+template <typename ValueType>
+int BPlusTreeSlottedPage<ValueType>::KeyIndex(std::string_view key) const {
+  return Bound(key, false);
+}
+
+template <typename ValueType>
+int BPlusTreeSlottedPage<ValueType>::ChildIndex(std::string_view key) const {
+  return Bound(key, true) - 1;
+}
+
+template <typename ValueType>
+int BPlusTreeSlottedPage<ValueType>::ValueIndex(const ValueType &value) const {
+  for (int i = 0; i < GetSize(); i++) {
+    if (ValueAt(i) == value) {
+      return i;
+    }
+  }
+  return GetSize();
+}
+
+/*****************************************************************************
+ * INSERTION & REMOVAL
+ *****************************************************************************/
+/*
+ * Insert in place when the key starts with the page prefix and the free space
+ * is large enough; otherwise rebuild the page, which shrinks the prefix and
+ * compacts away the holes left by removals.
+ */
+template <typename ValueType>
+bool BPlusTreeSlottedPage<ValueType>::Insert(int index, const std::string &key, const ValueType &value) {
+  assert(0 <= index && index <= GetSize());
+  bool keyed = index >= FirstKeyIndex();
+  if (!keyed || key.compare(0, prefix_size_, GetPrefix()) == 0) {
+    size_t suffix_size = keyed ? key.size() - prefix_size_ : 0;
+    int entry_size = static_cast<int>(sizeof(ValueType) + suffix_size);
+    if (FreeSpace() >= entry_size + static_cast<int>(sizeof(Slot))) {
+      data_start_ -= entry_size;
+      memcpy(data_ + data_start_, &value, sizeof(ValueType));
+      memcpy(data_ + data_start_ + sizeof(ValueType), key.data() + key.size() - suffix_size, suffix_size);
+      Slot *slots = Slots();
+      memmove(slots + index + 1, slots + index, (GetSize() - index) * sizeof(Slot));
+      slots[index] = {data_start_, static_cast<uint16_t>(suffix_size)};
+      IncreaseSize(1);
+      return true;
+    }
+  }
+  std::vector<Entry> entries;
+  GetEntries(&entries);
+  entries.emplace(entries.begin() + index, keyed ? key : std::string(), value);
+  return SetEntries(entries.begin(), entries.end());
+}
+
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::Remove(int index) {
+  assert(0 <= index && index < GetSize());
+  Slot *slots = Slots();
+  memmove(slots + index, slots + index + 1, (GetSize() - index - 1) * sizeof(Slot));
+  IncreaseSize(-1);
+}
+
+template <typename ValueType>
+void BPlusTreeSlottedPage<ValueType>::GetEntries(std::vector<Entry> *entries) const {
+  entries->reserve(entries->size() + GetSize());
+  for (int i = 0; i < GetSize(); i++) {
+    entries->emplace_back(KeyAt(i), ValueAt(i));
+  }
+}
+
+template <typename ValueType>
+bool BPlusTreeSlottedPage<ValueType>::SetEntries(typename std::vector<Entry>::const_iterator first,
+                                                 typename std::vector<Entry>::const_iterator last) {
+  int count = static_cast<int>(last - first);
+  int first_key = FirstKeyIndex();
+  // keys are sorted, so the prefix shared by the first and last key is shared by all
+  std::string_view prefix;
+  if (count > first_key) {
+    std::string_view low((first + first_key)->first);
+    std::string_view high(std::prev(last)->first);
+    size_t size = 0;
+    while (size < low.size() && size < high.size() && low[size] == high[size]) {
+      size++;
+    }
+    prefix = low.substr(0, size);
+  }
+
+  size_t total = SlotArrayOffset(prefix.size()) + count * sizeof(Slot);
+  for (auto it = first; it != last; ++it) {
+    total += sizeof(ValueType) + (it - first >= first_key ? it->first.size() - prefix.size() : 0);
+  }
+  if (total > SLOTTED_PAGE_DATA_SIZE) {
+    return false;
+  }
+
+  memcpy(data_, prefix.data(), prefix.size());
+  prefix_size_ = static_cast<uint16_t>(prefix.size());
+  Slot *slots = Slots();
+  uint16_t data_start = SLOTTED_PAGE_DATA_SIZE;
+  for (auto it = first; it != last; ++it) {
+    int index = static_cast<int>(it - first);
+    size_t suffix_size = index >= first_key ? it->first.size() - prefix.size() : 0;
+    data_start -= sizeof(ValueType) + suffix_size;
+    memcpy(data_ + data_start, &it->second, sizeof(ValueType));
+    memcpy(data_ + data_start + sizeof(ValueType), it->first.data() + prefix.size(), suffix_size);
+    slots[index] = {data_start, static_cast<uint16_t>(suffix_size)};
+  }
+  data_start_ = data_start;
+  SetSize(count);
+  return true;
+}
+
+/*
+ * Each half gets its own prefix, so the byte size of a candidate split is
+ * computed as SetEntries would lay it out. Both halves keep at least one
+ * entry (internal pages: one child besides the key-less first entry).
+ */
+template <typename ValueType>
+int BPlusTreeSlottedPage<ValueType>::SplitIndex(const std::vector<Entry> &entries, bool leaf) {
+  int count = static_cast<int>(entries.size());
+  int first_key = leaf ? 0 : 1;
+  std::vector<size_t> key_bytes(count + 1, 0);
+  for (int i = 0; i < count; i++) {
+    key_bytes[i + 1] = key_bytes[i] + entries[i].first.size();
+  }
+  auto page_bytes = [&](int first, int last) {
+    size_t bytes = (last - first) * (sizeof(Slot) + sizeof(ValueType));
+    if (last - first > first_key) {
+      const std::string &low = entries[first + first_key].first;
+      const std::string &high = entries[last - 1].first;
+      size_t prefix_size = 0;
+      while (prefix_size < low.size() && prefix_size < high.size() && low[prefix_size] == high[prefix_size]) {
+        prefix_size++;
+      }
+      bytes += SlotArrayOffset(prefix_size) + key_bytes[last] - key_bytes[first + first_key] -
+               (last - first - first_key) * prefix_size;
+    }
+    return bytes;
+  };
+
+  int split = -1;
+  size_t split_bytes = SLOTTED_PAGE_DATA_SIZE + 1;
+  for (int i = first_key + 1; i <= count - first_key - 1; i++) {
+    size_t bytes = std::max(page_bytes(0, i), page_bytes(i, count));
+    if (bytes < split_bytes) {
+      split = i;
+      split_bytes = bytes;
+    }
+  }
+  return split;
+}
+
+template class BPlusTreeSlottedPage<RID>;
+template class BPlusTreeSlottedPage<page_id_t>;
+
+}  // namespace bustub
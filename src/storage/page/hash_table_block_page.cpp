@@ -13,34 +13,106 @@
 #include "storage/page/hash_table_block_page.h"
 #include "storage/index/generic_key.h"
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 namespace bustub {
 
+namespace {
+
+/*
+ * Gathers the bits of TAG_GROUP_SIZE consecutive indexes from a bitmap; bytes
+ * past the end of the bitmap read as zero.
+ */
+uint32_t BitmapGroup(const std::atomic_char *bitmap, size_t bitmap_size, slot_offset_t bucket_ind) {
+  uint64_t bits = 0;
+  for (size_t i = 0; i < 5 && bucket_ind / 8 + i < bitmap_size; i++) {
+    bits |= static_cast<uint64_t>(static_cast<uint8_t>(bitmap[bucket_ind / 8 + i].load())) << (8 * i);
+  }
+  return static_cast<uint32_t>(bits >> (bucket_ind % 8));
+}
+
+}  // namespace
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 KeyType HASH_TABLE_BLOCK_TYPE::KeyAt(slot_offset_t bucket_ind) const {
-  return {};
+  return array_[bucket_ind].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 ValueType HASH_TABLE_BLOCK_TYPE::ValueAt(slot_offset_t bucket_ind) const {
-  return {};
+  return array_[bucket_ind].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) {
-  return false;
+bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value,
+                                   uint8_t tag) {
+  static_assert(sizeof(HASH_TABLE_BLOCK_TYPE) + BLOCK_ARRAY_SIZE * sizeof(MappingType) <= PAGE_SIZE,
+                "block page does not fit a page");
+  char mask = static_cast<char>(1 << (bucket_ind % 8));
+  if ((readable_[bucket_ind / 8] & mask) != 0) {
+    return false;
+  }
+  array_[bucket_ind] = MappingType(key, value);
+  tags_[bucket_ind] = tag;
+  occupied_[bucket_ind / 8] |= mask;
+  readable_[bucket_ind / 8] |= mask;
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {}
+void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {
+  readable_[bucket_ind / 8] &= static_cast<char>(~(1 << (bucket_ind % 8)));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsOccupied(slot_offset_t bucket_ind) const {
-  return false;
+  return (occupied_[bucket_ind / 8] & (1 << (bucket_ind % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsReadable(slot_offset_t bucket_ind) const {
-  return false;
+  return (readable_[bucket_ind / 8] & (1 << (bucket_ind % 8))) != 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BLOCK_TYPE::MatchTag(slot_offset_t bucket_ind, uint8_t tag) const {
+  const uint8_t *tags = tags_ + bucket_ind;
+#if defined(__AVX2__)
+  __m256i cmp = _mm256_cmpeq_epi8(_mm256_set1_epi8(static_cast<char>(tag)),
+                                  _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tags)));
+  return static_cast<uint32_t>(_mm256_movemask_epi8(cmp));
+#elif defined(__SSE2__)
+  __m128i needle = _mm_set1_epi8(static_cast<char>(tag));
+  auto low = static_cast<uint32_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(needle, _mm_loadu_si128(reinterpret_cast<const __m128i *>(tags)))));
+  auto high = static_cast<uint32_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(needle, _mm_loadu_si128(reinterpret_cast<const __m128i *>(tags + 16)))));
+  return low | high << 16;
+#else
+  uint32_t mask = 0;
+  for (slot_offset_t i = 0; i < TAG_GROUP_SIZE; i++) {
+    mask |= static_cast<uint32_t>(tags[i] == tag) << i;
+  }
+  return mask;
+#endif
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BLOCK_TYPE::OccupiedMask(slot_offset_t bucket_ind) const {
+  return BitmapGroup(occupied_, sizeof(occupied_), bucket_ind);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BLOCK_TYPE::ReadableMask(slot_offset_t bucket_ind) const {
+  return BitmapGroup(readable_, sizeof(readable_), bucket_ind);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::Prefetch(slot_offset_t bucket_ind) const {
+  __builtin_prefetch(tags_ + bucket_ind);
+  __builtin_prefetch(array_ + bucket_ind);
 }
 
 // DO NOT REMOVE ANYTHING BELOW THIS LINE
@@ -0,0 +1,183 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_util_test.cpp
+//
+// Identification: test/common/hash_util_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "container/hash/hash_function.h"
+#include "gtest/gtest.h"
+#include "murmur3/MurmurHash3.h"
+#include "storage/index/generic_key.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+// the hash the hash tables used before, for comparison
+template <typename KeyType>
+uint64_t MurmurHash(const KeyType &key) {
+  uint64_t hash[2];
+  murmur3::MurmurHash3_x64_128(reinterpret_cast<const void *>(&key), static_cast<int>(sizeof(KeyType)), 0,
+                               reinterpret_cast<void *>(&hash));
+  return hash[0];
+}
+
+template <typename KeyType>
+std::vector<KeyType> SequentialKeys(int num_keys) {
+  std::vector<KeyType> keys(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    keys[i].SetFromInteger(i);
+  }
+  return keys;
+}
+
+template <>
+std::vector<int> SequentialKeys<int>(int num_keys) {
+  std::vector<int> keys(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    keys[i] = i;
+  }
+  return keys;
+}
+
+// collision quality of a hash over a key set, see MeasureQuality
+struct Quality {
+  size_t distinct_hashes_;
+  size_t used_buckets_;
+  size_t max_bucket_;
+  size_t max_tag_;
+};
+
+/*
+ * Hashes the keys into as many buckets as keys by the low bits, as slots are
+ * chosen, and into 256 by the top byte, as tags are.
+ */
+template <typename KeyType, typename Hasher>
+Quality MeasureQuality(const std::vector<KeyType> &keys, Hasher hasher) {
+  std::unordered_set<uint64_t> hashes;
+  std::vector<size_t> buckets(keys.size());
+  std::vector<size_t> tags(256);
+  for (const auto &key : keys) {
+    uint64_t hash = hasher(key);
+    hashes.insert(hash);
+    buckets[hash % keys.size()]++;
+    tags[hash >> 56]++;
+  }
+  return {hashes.size(), static_cast<size_t>(std::count_if(buckets.begin(), buckets.end(), [](size_t b) { return b; })),
+          *std::max_element(buckets.begin(), buckets.end()), *std::max_element(tags.begin(), tags.end())};
+}
+
+template <typename KeyType>
+void ExpectGoodHash(const char *name) {
+  const int num_keys = 1 << 16;
+  Quality quality = MeasureQuality(SequentialKeys<KeyType>(num_keys), [](const KeyType &key) {
+    return HashFunction<KeyType>().GetHash(key);
+  });
+  EXPECT_EQ(num_keys, quality.distinct_hashes_) << name;
+  // a random hash leaves 1/e of the buckets empty and puts at most about 8 keys into one
+  EXPECT_GT(quality.used_buckets_, num_keys * 6 / 10) << name;
+  EXPECT_LE(quality.max_bucket_, 12) << name;
+  // 256 keys per tag on average
+  EXPECT_LE(quality.max_tag_, 256 * 5 / 4) << name;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, HashFunctionQualityTest) {
+  ExpectGoodHash<int>("int");
+  ExpectGoodHash<GenericKey<4>>("GenericKey<4>");
+  ExpectGoodHash<GenericKey<8>>("GenericKey<8>");
+  ExpectGoodHash<GenericKey<16>>("GenericKey<16>");
+  ExpectGoodHash<GenericKey<64>>("GenericKey<64>");
+
+  // every byte of a long key counts, also in the zero padded tail
+  char bytes[37] = {};
+  uint64_t hash = HashUtil::HashWords(bytes, sizeof(bytes));
+  for (size_t i = 0; i < sizeof(bytes); i++) {
+    bytes[i] = 1;
+    EXPECT_NE(hash, HashUtil::HashWords(bytes, sizeof(bytes))) << i;
+    bytes[i] = 0;
+  }
+  EXPECT_NE(HashUtil::HashWords(bytes, 36), HashUtil::HashWords(bytes, 37));
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, HashValueTest) {
+  // integers hash by value whatever their width, as before
+  Value small = ValueFactory::GetSmallIntValue(42);
+  Value big = ValueFactory::GetBigIntValue(42);
+  EXPECT_EQ(HashUtil::HashValue(&small), HashUtil::HashValue(&big));
+  Value other = ValueFactory::GetBigIntValue(43);
+  EXPECT_NE(HashUtil::HashValue(&big), HashUtil::HashValue(&other));
+
+  Value name = ValueFactory::GetVarcharValue("bustub");
+  Value same = ValueFactory::GetVarcharValue(std::string("bustub"));
+  Value different = ValueFactory::GetVarcharValue("bustuc");
+  EXPECT_EQ(HashUtil::HashValue(&name), HashUtil::HashValue(&same));
+  EXPECT_NE(HashUtil::HashValue(&name), HashUtil::HashValue(&different));
+
+  // group by (a, b) and (b, a) are different groups
+  hash_t a = HashUtil::HashValue(&big);
+  hash_t b = HashUtil::HashValue(&other);
+  EXPECT_NE(HashUtil::CombineHashes(HashUtil::CombineHashes(0, a), b),
+            HashUtil::CombineHashes(HashUtil::CombineHashes(0, b), a));
+}
+
+namespace {
+
+template <typename KeyType, typename Hasher>
+void RunHashBenchmark(const char *name, const char *hasher_name, const std::vector<KeyType> &keys, Hasher hasher) {
+  const int rounds = 20;
+  uint64_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < rounds; round++) {
+    for (const auto &key : keys) {
+      sink += hasher(key);
+    }
+  }
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  Quality quality = MeasureQuality(keys, hasher);
+  std::cout << name << "," << hasher_name << "," << static_cast<double>(ns) / (rounds * keys.size()) << ","
+            << keys.size() - quality.distinct_hashes_ << "," << quality.used_buckets_ << "," << quality.max_bucket_
+            << "," << quality.max_tag_ << (sink == 0 ? " " : "") << std::endl;
+}
+
+template <typename KeyType>
+void CompareHashes(const char *name) {
+  std::vector<KeyType> keys = SequentialKeys<KeyType>(1 << 20);
+  RunHashBenchmark(name, "murmur3", keys, [](const KeyType &key) { return MurmurHash(key); });
+  HashFunction<KeyType> hash_fn;
+  RunHashBenchmark(name, "fixed", keys, [&hash_fn](const KeyType &key) { return hash_fn.GetHash(key); });
+}
+
+}  // namespace
+
+/*
+ * Throughput and collision quality of the fixed-width hashes against
+ * MurmurHash3_x64_128 on 2^20 sequential keys, one CSV row per key type and
+ * hash. Run with --gtest_also_run_disabled_tests.
+ */
+TEST(HashUtilTest, DISABLED_HashBenchmark) {
+  std::cout << "key,hash,ns_per_hash,collisions,used_buckets,max_bucket,max_tag" << std::endl;
+  CompareHashes<int>("int");
+  CompareHashes<GenericKey<8>>("GenericKey<8>");
+  CompareHashes<GenericKey<16>>("GenericKey<16>");
+  CompareHashes<GenericKey<32>>("GenericKey<32>");
+  CompareHashes<GenericKey<64>>("GenericKey<64>");
+}
+
+}  // namespace bustub
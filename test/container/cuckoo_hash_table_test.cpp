@@ -0,0 +1,184 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// cuckoo_hash_table_test.cpp
+//
+// Identification: test/container/cuckoo_hash_table_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "container/hash/cuckoo_hash_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(CuckooHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  CuckooHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  // insert a few values, and one more value for each key but 0
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  for (int i = 0; i < 5; i++) {
+    // duplicate values for the same key are not allowed
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+    EXPECT_EQ(i != 0, ht.Insert(nullptr, i, 2 * i));
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(i == 0 ? 1 : 2, res.size());
+  }
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+
+  // delete some values
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+    res.clear();
+    ht.GetValue(nullptr, i, &res);
+    if (i == 0) {
+      EXPECT_EQ(0, res.size());
+    } else {
+      EXPECT_EQ(std::vector<int>({2 * i}), res);
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(CuckooHashTableTest, GrowTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  CuckooHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+
+  // a single block page to start with, the table has to double several times
+  size_t initial_size = ht.GetSize();
+  const int num_keys = 20000;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_GT(ht.GetSize(), 4 * initial_size);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(std::vector<int>({i}), res);
+  }
+
+  for (int i = 0; i < num_keys; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(i % 2 == 1, ht.GetValue(nullptr, i, &res));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(CuckooHashTableTest, OverflowTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  CuckooHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  // the values of a key past its two buckets go to an overflow chain, neither to the stash nor by growing
+  size_t size = ht.GetSize();
+  const int num_values = 1000;
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, 7, i));
+  }
+  EXPECT_EQ(0, ht.GetStashSize());
+  EXPECT_EQ(size, ht.GetSize());
+  EXPECT_LT(0, ht.GetOverflowSize());
+  EXPECT_FALSE(ht.Insert(nullptr, 7, num_values - 1));
+  std::vector<int> res;
+  EXPECT_TRUE(ht.GetValue(nullptr, 7, &res));
+  std::sort(res.begin(), res.end());
+  EXPECT_EQ(num_values, res.size());
+  for (int i = 0; i < static_cast<int>(res.size()); i++) {
+    EXPECT_EQ(i, res[i]);
+  }
+
+  // values in the chain are removed as well, and their slots are reused
+  for (int i = 0; i < num_values; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, 7, i));
+  }
+  EXPECT_FALSE(ht.Remove(nullptr, 7, 0));
+  size_t overflow_size = ht.GetOverflowSize();
+  for (int i = 0; i < num_values; i += 2) {
+    EXPECT_TRUE(ht.Insert(nullptr, 7, i));
+  }
+  EXPECT_EQ(overflow_size, ht.GetOverflowSize());
+  res.clear();
+  EXPECT_TRUE(ht.GetValue(nullptr, 7, &res));
+  EXPECT_EQ(num_values, res.size());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(CuckooHashTableTest, ConcurrentTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  CuckooHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+
+  // preloaded keys must stay visible to readers while writers evict and grow
+  const int num_preloaded = 2000;
+  for (int key = 0; key < num_preloaded; key++) {
+    EXPECT_TRUE(ht.Insert(nullptr, -key - 1, key));
+  }
+
+  const int num_threads = 4;
+  const int per_thread = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < per_thread; i++) {
+        int key = i * num_threads + t;
+        EXPECT_TRUE(ht.Insert(nullptr, key, key));
+        std::vector<int> res;
+        EXPECT_TRUE(ht.GetValue(nullptr, key, &res));
+        res.clear();
+        EXPECT_TRUE(ht.GetValue(nullptr, -(key % num_preloaded) - 1, &res));
+      }
+      for (int i = 1; i < per_thread; i += 2) {
+        int key = i * num_threads + t;
+        EXPECT_TRUE(ht.Remove(nullptr, key, key));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int key = 0; key < num_threads * per_thread; key++) {
+    std::vector<int> res;
+    EXPECT_EQ((key / num_threads) % 2 == 0, ht.GetValue(nullptr, key, &res));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
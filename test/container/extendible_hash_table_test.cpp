@@ -0,0 +1,200 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_test.cpp
+//
+// Identification: test/container/extendible_hash_table_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "container/hash/extendible_hash_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // insert a few values, and one more value for each key but 0
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  for (int i = 0; i < 5; i++) {
+    // duplicate values for the same key are not allowed
+    EXPECT_EQ(i != 0, ht.Insert(nullptr, i, 2 * i));
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(i == 0 ? 1 : 2, res.size());
+  }
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+
+  // delete some values
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+    res.clear();
+    ht.GetValue(nullptr, i, &res);
+    if (i == 0) {
+      EXPECT_EQ(0, res.size());
+    } else {
+      EXPECT_EQ(std::vector<int>({2 * i}), res);
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, GrowShrinkTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // far more pairs than one bucket holds, with a few values for every key
+  const int num_keys = 10000;
+  for (int i = 0; i < num_keys; i++) {
+    for (int j = 0; j < 3; j++) {
+      EXPECT_TRUE(ht.Insert(nullptr, i, j));
+    }
+  }
+  uint32_t global_depth = ht.GetGlobalDepth();
+  EXPECT_GT(global_depth, 0);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(3, res.size());
+  }
+
+  // splits only happen in the buckets that overflow, removing keeps the rest
+  for (int i = 0; i < num_keys; i++) {
+    for (int j = 0; j < 2; j++) {
+      EXPECT_TRUE(ht.Remove(nullptr, i, j));
+    }
+  }
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(std::vector<int>({2}), res);
+  }
+
+  // empty buckets merge back and the directory shrinks to a single bucket
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, 2));
+  }
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_LE(ht.GetGlobalDepth(), global_depth);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, OverflowTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // no split divides the values of one key, they go to overflow pages without growing the directory
+  const int num_values = 2000;
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, 7, i));
+  }
+  EXPECT_FALSE(ht.Insert(nullptr, 7, 0));
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+  std::vector<int> res;
+  EXPECT_TRUE(ht.GetValue(nullptr, 7, &res));
+  EXPECT_EQ(num_values, res.size());
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, 7, i));
+  }
+  res.clear();
+  EXPECT_FALSE(ht.GetValue(nullptr, 7, &res));
+
+  // keys whose hashes share their low bits split up to the maximum depth, then overflow
+  ExtendibleHashTable<int, int, IntComparator> colliding_ht("blah", bpm, IntComparator(), HashFunction<int>());
+  HashFunction<int> hash_fn;
+  std::vector<int> keys;
+  for (int key = 0; keys.size() < static_cast<size_t>(num_values); key++) {
+    if ((static_cast<uint32_t>(hash_fn.GetHash(key)) & (DIRECTORY_ARRAY_SIZE / 2 - 1)) == 0) {
+      keys.push_back(key);
+    }
+  }
+  for (int key : keys) {
+    EXPECT_TRUE(colliding_ht.Insert(nullptr, key, key));
+  }
+  EXPECT_EQ(DIRECTORY_MAX_DEPTH, colliding_ht.GetGlobalDepth());
+  for (int key : keys) {
+    res.clear();
+    EXPECT_TRUE(colliding_ht.GetValue(nullptr, key, &res));
+    EXPECT_EQ(std::vector<int>({key}), res);
+  }
+
+  // emptied buckets merge back along with their overflow pages
+  for (int key : keys) {
+    EXPECT_TRUE(colliding_ht.Remove(nullptr, key, key));
+  }
+  EXPECT_EQ(0, colliding_ht.GetGlobalDepth());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, ConcurrentTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // every thread inserts its keys and removes the odd ones, splits and merges run concurrently
+  const int num_threads = 4;
+  const int per_thread = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < per_thread; i++) {
+        int key = i * num_threads + t;
+        EXPECT_TRUE(ht.Insert(nullptr, key, key));
+        std::vector<int> res;
+        EXPECT_TRUE(ht.GetValue(nullptr, key, &res));
+      }
+      for (int i = 1; i < per_thread; i += 2) {
+        int key = i * num_threads + t;
+        EXPECT_TRUE(ht.Remove(nullptr, key, key));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int key = 0; key < num_threads * per_thread; key++) {
+    std::vector<int> res;
+    EXPECT_EQ((key / num_threads) % 2 == 0, ht.GetValue(nullptr, key, &res));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
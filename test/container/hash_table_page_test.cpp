@@ -23,7 +23,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_HeaderPageSampleTest) {
+TEST(HashTablePageTest, HeaderPageSampleTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -61,7 +61,7 @@ TEST(HashTablePageTest, DISABLED_HeaderPageSampleTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
+TEST(HashTablePageTest, BlockPageSampleTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -111,4 +111,49 @@ TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BlockPageTagTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+
+  page_id_t block_page_id = INVALID_PAGE_ID;
+  auto block_page =
+      reinterpret_cast<HashTableBlockPage<int, int, IntComparator> *>(bpm->NewPage(&block_page_id, nullptr)->GetData());
+
+  // tags 0, 1, 2, 0, 1, 2, ... in the first 40 slots, then remove every 4th
+  for (unsigned i = 0; i < 40; i++) {
+    EXPECT_TRUE(block_page->Insert(i, i, i, i % 3));
+  }
+  for (unsigned i = 0; i < 40; i += 4) {
+    block_page->Remove(i);
+  }
+
+  // groups that start in the middle of a bitmap byte, and one at the end of the block
+  for (unsigned start : {0U, 5U, 13U, 20U}) {
+    uint32_t tag_mask = block_page->MatchTag(start, 1);
+    uint32_t occupied = block_page->OccupiedMask(start);
+    uint32_t readable = block_page->ReadableMask(start);
+    for (unsigned i = 0; i < 32; i++) {
+      unsigned slot = start + i;
+      EXPECT_EQ(slot < 40 && slot % 3 == 1, (tag_mask >> i & 1) == 1) << slot;
+      EXPECT_EQ(slot < 40, (occupied >> i & 1) == 1) << slot;
+      EXPECT_EQ(slot < 40 && slot % 4 != 0, (readable >> i & 1) == 1) << slot;
+    }
+  }
+  // BLOCK_ARRAY_SIZE is spelled in terms of KeyType and ValueType
+  using KeyType = int;
+  using ValueType = int;
+  size_t last = BLOCK_ARRAY_SIZE - 1;
+  EXPECT_TRUE(block_page->Insert(last, 1, 1, 7));
+  EXPECT_EQ(1, block_page->MatchTag(last, 7) & 1);
+  EXPECT_EQ(1, block_page->OccupiedMask(last));
+  EXPECT_EQ(1, block_page->ReadableMask(last));
+
+  bpm->UnpinPage(block_page_id, true, nullptr);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -10,6 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -21,7 +25,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTableTest, DISABLED_SampleTest) {
+TEST(HashTableTest, SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(50, disk_manager);
 
@@ -104,4 +108,277 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, ResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+  size_t initial_size = ht.GetSize();
+  EXPECT_GE(initial_size, 1000);
+
+  // the table grows several times, pairs stay visible while they migrate
+  const int num_keys = 20000;
+  bool resized = false;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    resized = resized || ht.IsResizing();
+    if (ht.IsResizing()) {
+      // a pair still in the old layout is not inserted twice
+      EXPECT_FALSE(ht.Insert(nullptr, i / 2, i / 2));
+      std::vector<int> res;
+      EXPECT_TRUE(ht.GetValue(nullptr, i / 2, &res));
+      EXPECT_EQ(std::vector<int>({i / 2}), res);
+    }
+  }
+  EXPECT_TRUE(resized);
+  EXPECT_GE(ht.GetSize(), num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(std::vector<int>({i}), res);
+  }
+
+  // an explicit resize only allocates, the following operations finish it
+  size_t size = ht.GetSize();
+  ht.Resize(size);
+  EXPECT_TRUE(ht.IsResizing());
+  EXPECT_GE(ht.GetSize(), 2 * size);
+  for (int i = 0; i < num_keys; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(i % 2 == 1, ht.GetValue(nullptr, i, &res));
+  }
+  EXPECT_FALSE(ht.IsResizing());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, BatchTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+  const int num_keys = 5000;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    if (i % 3 == 1) {
+      EXPECT_TRUE(ht.Insert(nullptr, i, -i));
+    }
+  }
+
+  // hits, misses and repeated keys, answered like one GetValue per key, before and during a resize
+  std::vector<int> keys;
+  for (int i = num_keys + 100; i >= -100; i--) {
+    keys.push_back(i);
+    if (i % 7 == 0) {
+      keys.push_back(i);
+    }
+  }
+  for (bool resizing : {false, true}) {
+    if (resizing) {
+      ht.Resize(ht.GetSize());
+    }
+    EXPECT_EQ(resizing, ht.IsResizing());
+    std::vector<std::vector<int>> results;
+    ht.GetValues(nullptr, keys, &results);
+    ASSERT_EQ(keys.size(), results.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+      std::vector<int> res;
+      ht.GetValue(nullptr, keys[i], &res);
+      std::sort(res.begin(), res.end());
+      std::sort(results[i].begin(), results[i].end());
+      EXPECT_EQ(res, results[i]);
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  // every thread inserts its keys and removes the odd ones while the table grows
+  const int num_threads = 4;
+  const int per_thread = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < per_thread; i++) {
+        int key = i * num_threads + t;
+        EXPECT_TRUE(ht.Insert(nullptr, key, key));
+        std::vector<int> res;
+        EXPECT_TRUE(ht.GetValue(nullptr, key, &res));
+      }
+      for (int i = 1; i < per_thread; i += 2) {
+        int key = i * num_threads + t;
+        EXPECT_TRUE(ht.Remove(nullptr, key, key));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int key = 0; key < num_threads * per_thread; key++) {
+    std::vector<int> res;
+    EXPECT_EQ((key / num_threads) % 2 == 0, ht.GetValue(nullptr, key, &res));
+  }
+
+  // the same pairs from all threads at once, with tombstones to reuse: each pair gets in once
+  threads.clear();
+  std::atomic<int> inserted{0};
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&] {
+      for (int key = 0; key < num_threads * per_thread; key++) {
+        if (ht.Insert(nullptr, key, -1)) {
+          inserted++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_threads * per_thread, inserted);
+  for (int key = 0; key < num_threads * per_thread; key++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, key, &res));
+    EXPECT_EQ((key / num_threads) % 2 == 0 ? 2 : 1, res.size());
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  // keys below num_stable are there all along and must be seen exactly once while the table grows under them
+  const int num_stable = 500;
+  const int num_keys = 20000;
+  for (int key = 0; key < num_stable; key++) {
+    EXPECT_TRUE(ht.Insert(nullptr, key, key));
+  }
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  threads.emplace_back([&] {
+    for (int key = num_stable; key < num_keys; key++) {
+      EXPECT_TRUE(ht.Insert(nullptr, key, key));
+    }
+    done = true;
+  });
+  for (int t = 0; t < 3; t++) {
+    threads.emplace_back([&, t] {
+      for (int key = t; !done; key = (key + 7) % num_stable) {
+        std::vector<int> res;
+        EXPECT_TRUE(ht.GetValue(nullptr, key, &res));
+        EXPECT_EQ(1, res.size());
+        std::vector<std::vector<int>> results;
+        ht.GetValues(nullptr, {key, (key + 1) % num_stable}, &results);
+        EXPECT_EQ(1, results[0].size());
+        EXPECT_EQ(1, results[1].size());
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // removes race the migration of the pairs they remove
+  threads.clear();
+  for (int t = 0; t < 2; t++) {
+    threads.emplace_back([&, t] {
+      for (int key = t; key < num_keys; key += 2) {
+        EXPECT_TRUE(ht.Remove(nullptr, key, key));
+      }
+    });
+  }
+  threads.emplace_back([&] {
+    for (int key = num_keys; key < 2 * num_keys; key++) {
+      EXPECT_TRUE(ht.Insert(nullptr, key, key));
+    }
+  });
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int key = 0; key < 2 * num_keys; key++) {
+    std::vector<int> res;
+    EXPECT_EQ(key >= num_keys, ht.GetValue(nullptr, key, &res));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+/*
+ * Hit and miss lookups on a table filled right up to its resize threshold,
+ * where probe chains are longest. Run with --gtest_also_run_disabled_tests.
+ */
+TEST(HashTableTest, DISABLED_ProbeBenchmark) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(500, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 100000, HashFunction<int>());
+  const int num_keys = static_cast<int>(ht.GetSize() * 3 / 4);
+  for (int i = 0; i < num_keys; i++) {
+    ht.Insert(nullptr, i, i);
+  }
+  EXPECT_FALSE(ht.IsResizing());
+  for (bool hit : {true, false}) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> res;
+    for (int i = 0; i < num_keys; i++) {
+      ht.GetValue(nullptr, hit ? i : num_keys + i, &res);
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(hit ? num_keys : 0, res.size());
+    std::cout << (hit ? "hit" : "miss") << " lookups: " << ns / num_keys << " ns/op" << std::endl;
+  }
+
+  // the same lookups in batches, as a hash join probes its build side
+  const int batch_size = 1024;
+  for (bool hit : {true, false}) {
+    auto start = std::chrono::steady_clock::now();
+    size_t found = 0;
+    for (int begin = 0; begin < num_keys; begin += batch_size) {
+      std::vector<int> keys;
+      for (int i = begin; i < std::min(num_keys, begin + batch_size); i++) {
+        keys.push_back(hit ? i : num_keys + i);
+      }
+      std::vector<std::vector<int>> results;
+      ht.GetValues(nullptr, keys, &results);
+      for (const auto &res : results) {
+        found += res.size();
+      }
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(hit ? num_keys : 0, found);
+    std::cout << (hit ? "hit" : "miss") << " batched lookups: " << ns / num_keys << " ns/op" << std::endl;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -10,8 +10,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstdio>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <set>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -26,12 +30,16 @@
 #include "execution/execution_engine.h"
 #include "execution/executor_context.h"
 #include "execution/executors/aggregation_executor.h"
+#include "execution/executors/index_scan_executor.h"
 #include "execution/executors/insert_executor.h"
+#include "execution/executors/nested_index_join_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
 #include "execution/expressions/aggregate_value_expression.h"
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/nested_index_join_plan.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "gtest/gtest.h"
 #include "storage/b_plus_tree_test_util.h"  // NOLINT
@@ -335,6 +343,219 @@ TEST_F(ExecutorTest, DISABLED_SimpleRawInsertWithIndexTest) {
   delete key_schema;
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, CoveringIndexScanTest) {
+  // CREATE INDEX index1 ON test_1 (colB) INCLUDE (colC): colB has 10 values, so most keys have many tuples
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  Schema *key_schema = ParseCreateStatement("b integer");
+  auto index_info = GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<16>, RID, GenericComparator<16>>(
+      GetTxn(), "index1", "test_1", schema, *key_schema, {1}, 16, {2});
+  ASSERT_EQ(index_info->index_->GetIndexColumnCount(), 1);
+  ASSERT_EQ(index_info->key_schema_.GetColumnCount(), 1);
+  ASSERT_EQ(index_info->index_->GetEntrySchema()->GetColumnCount(), 2);
+  ASSERT_TRUE(index_info->index_->Covers({1, 2}));
+  ASSERT_FALSE(index_info->index_->Covers({1, 3}));
+
+  // the included column is not part of the key: a key lookup finds every tuple of the key
+  std::vector<Tuple> keys;
+  std::vector<size_t> key_counts(10);
+  std::vector<std::pair<RID, std::vector<int32_t>>> rows;
+  for (auto it = table_info->table_->Begin(GetTxn()); it != table_info->table_->End(); ++it) {
+    std::vector<int32_t> row;
+    for (uint32_t i = 0; i < 4; i++) {
+      row.push_back(it->GetValue(&schema, i).GetAs<int32_t>());
+    }
+    key_counts[row[1]]++;
+    rows.emplace_back(it->GetRid(), row);
+  }
+  for (int32_t b = 0; b < 10; b++) {
+    std::vector<RID> rids;
+    index_info->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(b)}, key_schema), &rids, GetTxn());
+    ASSERT_EQ(rids.size(), key_counts[b]);
+  }
+
+  // changing the included column of a tuple replaces its entry, the other tuples of the key keep theirs
+  const auto &changed = rows[0];
+  Tuple old_entry({ValueFactory::GetIntegerValue(changed.second[1]), ValueFactory::GetIntegerValue(changed.second[2])},
+                  index_info->index_->GetEntrySchema());
+  Tuple new_entry({ValueFactory::GetIntegerValue(changed.second[1]), ValueFactory::GetIntegerValue(-1)},
+                  index_info->index_->GetEntrySchema());
+  index_info->index_->DeleteEntry(old_entry, changed.first, GetTxn());
+  index_info->index_->InsertEntry(new_entry, changed.first, GetTxn());
+  std::vector<RID> rids;
+  index_info->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(changed.second[1])}, key_schema), &rids, GetTxn());
+  ASSERT_EQ(rids.size(), key_counts[changed.second[1]]);
+
+  auto colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto colC = MakeColumnValueExpression(schema, 0, "colC");
+  auto colD = MakeColumnValueExpression(schema, 0, "colD");
+  auto predicate =
+      MakeComparisonExpression(colB, MakeConstantValueExpression(ValueFactory::GetIntegerValue(changed.second[1])),
+                               ComparisonType::Equal);
+
+  // SELECT colB, colC FROM test_1 WHERE colB = changed.colB, from the index entries as far as they hold colC
+  std::multiset<std::pair<int32_t, int32_t>> expected;
+  std::multiset<std::pair<int32_t, int32_t>> expected_uncovered;
+  for (const auto &row : rows) {
+    if (row.second[1] == changed.second[1]) {
+      expected.emplace(row.second[1], row.first == changed.first ? -1 : row.second[2]);
+      expected_uncovered.emplace(row.second[0], row.second[3]);
+    }
+  }
+  auto *covered_schema = MakeOutputSchema({{"colB", colB}, {"colC", colC}});
+  IndexScanPlanNode covered_plan{covered_schema, predicate, index_info->index_oid_};
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&covered_plan, &result_set, GetTxn(), GetExecutorContext());
+  std::multiset<std::pair<int32_t, int32_t>> result;
+  for (const auto &tuple : result_set) {
+    result.emplace(tuple.GetValue(covered_schema, 0).GetAs<int32_t>(),
+                   tuple.GetValue(covered_schema, 1).GetAs<int32_t>());
+  }
+  // the latest entry of the key holds colC, which was only changed in the index: -1 proves it was read from there
+  ASSERT_EQ(result, expected);
+
+  // SELECT colA, colD FROM test_1 WHERE colB = changed.colB, colA and colD are read from the table
+  auto *uncovered_schema = MakeOutputSchema({{"colA", colA}, {"colD", colD}});
+  IndexScanPlanNode uncovered_plan{uncovered_schema, predicate, index_info->index_oid_};
+  result_set.clear();
+  GetExecutionEngine()->Execute(&uncovered_plan, &result_set, GetTxn(), GetExecutorContext());
+  result.clear();
+  for (const auto &tuple : result_set) {
+    result.emplace(tuple.GetValue(uncovered_schema, 0).GetAs<int32_t>(),
+                   tuple.GetValue(uncovered_schema, 1).GetAs<int32_t>());
+  }
+  ASSERT_EQ(result, expected_uncovered);
+
+  // only B+ trees store included columns
+  ASSERT_THROW((GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<16>, RID, GenericComparator<16>>(
+                   GetTxn(), "index2", "test_1", schema, *key_schema, {1}, 16, {2}, IndexKind::ART)),
+               NotImplementedException);
+  delete key_schema;
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, IndexScanRangeTest) {
+  // CREATE INDEX ON test_1 (colB, colA), once per ordered index kind
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  Schema *key_schema = ParseCreateStatement("b integer,a integer");
+  std::vector<IndexInfo *> index_infos;
+  for (auto kind : {IndexKind::BPLUS_TREE, IndexKind::ART, IndexKind::SKIP_LIST}) {
+    index_infos.push_back(GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+        GetTxn(), "index" + std::to_string(index_infos.size()), "test_1", schema, *key_schema, {1, 0}, 8, {}, kind));
+  }
+
+  std::vector<std::vector<int32_t>> rows;
+  for (auto it = table_info->table_->Begin(GetTxn()); it != table_info->table_->End(); ++it) {
+    rows.push_back({it->GetValue(&schema, 1).GetAs<int32_t>(), it->GetValue(&schema, 0).GetAs<int32_t>(),
+                    it->GetValue(&schema, 2).GetAs<int32_t>()});
+  }
+  std::sort(rows.begin(), rows.end());
+
+  auto colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto colC = MakeColumnValueExpression(schema, 0, "colC");
+  auto const4 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(4));
+  auto const5000 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(5000));
+  auto *out_schema = MakeOutputSchema({{"colB", colB}, {"colA", colA}, {"colC", colC}});
+
+  // SELECT colB, colA, colC FROM test_1 WHERE predicate, in (colB, colA) order
+  auto check = [&](const AbstractExpression *predicate, const std::function<bool(const std::vector<int32_t> &)> &pred) {
+    std::vector<std::vector<int32_t>> expected;
+    std::copy_if(rows.begin(), rows.end(), std::back_inserter(expected), pred);
+    ASSERT_FALSE(expected.empty());
+    for (auto *index_info : index_infos) {
+      IndexScanPlanNode plan{out_schema, predicate, index_info->index_oid_};
+      std::vector<Tuple> result_set;
+      GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+      ASSERT_EQ(result_set.size(), expected.size());
+      for (size_t i = 0; i < result_set.size(); i++) {
+        for (uint32_t j = 0; j < 3; j++) {
+          ASSERT_EQ(result_set[i].GetValue(out_schema, j).GetAs<int32_t>(), expected[i][j]);
+        }
+      }
+    }
+  };
+  // bounds on the leading key column, the key suffix (colA) must not cut them short
+  check(MakeComparisonExpression(colB, const4, ComparisonType::Equal), [](const auto &row) { return row[0] == 4; });
+  check(MakeComparisonExpression(colB, const4, ComparisonType::LessThan), [](const auto &row) { return row[0] < 4; });
+  check(MakeComparisonExpression(colB, const4, ComparisonType::LessThanOrEqual),
+        [](const auto &row) { return row[0] <= 4; });
+  check(MakeComparisonExpression(colB, const4, ComparisonType::GreaterThan),
+        [](const auto &row) { return row[0] > 4; });
+  check(MakeComparisonExpression(colB, const4, ComparisonType::GreaterThanOrEqual),
+        [](const auto &row) { return row[0] >= 4; });
+  check(MakeComparisonExpression(const4, colB, ComparisonType::LessThan), [](const auto &row) { return row[0] > 4; });
+  check(MakeComparisonExpression(colB, const4, ComparisonType::NotEqual), [](const auto &row) { return row[0] != 4; });
+  // a key column that is not leading is filtered on the keys, other columns on the table tuples
+  check(MakeComparisonExpression(colA, const4, ComparisonType::LessThan), [](const auto &row) { return row[1] < 4; });
+  check(MakeComparisonExpression(colC, const5000, ComparisonType::GreaterThanOrEqual),
+        [](const auto &row) { return row[2] >= 5000; });
+
+  // hash indexes have no key order to scan in
+  auto hash_info = GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "hash_index", "test_1", schema, *key_schema, {1, 0}, 8, {}, IndexKind::EXTENDIBLE_HASH);
+  IndexScanPlanNode hash_plan{out_schema, nullptr, hash_info->index_oid_};
+  IndexScanExecutor hash_scan{GetExecutorContext(), &hash_plan};
+  ASSERT_THROW(hash_scan.Init(), NotImplementedException);
+  delete key_schema;
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, ParallelIndexScanTest) {
+  // CREATE TABLE big (a integer, b integer); CREATE INDEX ON big (b, a)
+  auto *catalog = GetExecutorContext()->GetCatalog();
+  Schema *table_schema = ParseCreateStatement("a integer,b integer");
+  auto table_info = catalog->CreateTable(GetTxn(), "big", *table_schema);
+  auto &schema = table_info->schema_;
+  // enough keys for several chunks per partition
+  const int num_rows = 8000;
+  for (int a = 0; a < num_rows; a++) {
+    RID rid;
+    Tuple tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetIntegerValue(a % 10)}, &schema);
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+  Schema *key_schema = ParseCreateStatement("b integer,a integer");
+  auto index_info = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "big_ba", "big", schema, *key_schema, {1, 0}, 8);
+
+  auto colA = MakeColumnValueExpression(schema, 0, "a");
+  auto colB = MakeColumnValueExpression(schema, 0, "b");
+  auto const3 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(3));
+  auto const6000 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(6000));
+  auto *out_schema = MakeOutputSchema({{"b", colB}, {"a", colA}});
+
+  // SELECT b, a FROM big WHERE predicate, in (b, a) order with and without splitting the range
+  auto check = [&](const AbstractExpression *predicate, const std::function<bool(int32_t, int32_t)> &pred) {
+    std::vector<std::pair<int32_t, int32_t>> expected;
+    for (int32_t b = 0; b < 10; b++) {
+      for (int32_t a = b; a < num_rows; a += 10) {
+        if (pred(b, a)) {
+          expected.emplace_back(b, a);
+        }
+      }
+    }
+    for (bool parallel : {false, true}) {
+      IndexScanPlanNode plan{out_schema, predicate, index_info->index_oid_, parallel};
+      std::vector<Tuple> result_set;
+      GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+      std::vector<std::pair<int32_t, int32_t>> scanned;
+      for (const auto &tuple : result_set) {
+        scanned.emplace_back(tuple.GetValue(out_schema, 0).GetAs<int32_t>(),
+                             tuple.GetValue(out_schema, 1).GetAs<int32_t>());
+      }
+      EXPECT_EQ(scanned, expected);
+    }
+  };
+  // filtered on the keys over the whole tree, and over a range bounded by the leading column
+  check(MakeComparisonExpression(colA, const6000, ComparisonType::LessThan), [](int32_t b, int32_t a) { return a < 6000; });
+  check(MakeComparisonExpression(colB, const3, ComparisonType::GreaterThan), [](int32_t b, int32_t a) { return b > 3; });
+  delete table_schema;
+  delete key_schema;
+}
+
 // NOLINTNEXTLINE
 TEST_F(ExecutorTest, DISABLED_SimpleDeleteTest) {
   // SELECT colA FROM test_1 WHERE colA == 50
@@ -385,6 +606,149 @@ TEST_F(ExecutorTest, DISABLED_SimpleDeleteTest) {
   delete key_schema;
 }
 
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, NestedIndexJoinTest) {
+  // SELECT test_3.col1, test_3.col3, test_1.colA, test_1.colB FROM test_3 JOIN test_1 ON test_3.col1 = test_1.colB
+  auto *catalog = GetExecutorContext()->GetCatalog();
+  auto outer_info = catalog->GetTable("test_3");
+  auto inner_info = catalog->GetTable("test_1");
+  Schema *outer_key_schema = ParseCreateStatement("col1 integer");
+  Schema *inner_key_schema = ParseCreateStatement("colB integer");
+  auto outer_index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "test_3_col1", "test_3", outer_info->schema_, *outer_key_schema, {0}, 8);
+  auto index_name = [](IndexKind kind) { return "test_1_colB_" + std::to_string(static_cast<int>(kind)); };
+  // the B+ tree probes a batch with one descent per group of keys, a hash index one key at a time
+  for (auto kind : {IndexKind::BPLUS_TREE, IndexKind::EXTENDIBLE_HASH}) {
+    catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(GetTxn(), index_name(kind), "test_1",
+                                                                  inner_info->schema_, *inner_key_schema, {1}, 8, {},
+                                                                  kind);
+  }
+
+  std::multiset<std::pair<int32_t, int32_t>> expected;
+  for (auto it = inner_info->table_->Begin(GetTxn()); it != inner_info->table_->End(); ++it) {
+    int32_t colB = it->GetValue(&inner_info->schema_, 1).GetAs<int32_t>();
+    if (colB < static_cast<int32_t>(TEST2_SIZE)) {
+      expected.emplace(colB, it->GetValue(&inner_info->schema_, 0).GetAs<int32_t>());
+    }
+  }
+  ASSERT_FALSE(expected.empty());
+
+  auto col1 = MakeColumnValueExpression(outer_info->schema_, 0, "col1");
+  auto col3 = MakeColumnValueExpression(outer_info->schema_, 0, "col3");
+  auto *outer_schema = MakeOutputSchema({{"col1", col1}, {"col3", col3}});
+  IndexScanPlanNode outer_plan{outer_schema, nullptr, outer_index->index_oid_};
+  auto colA = MakeColumnValueExpression(inner_info->schema_, 0, "colA");
+  auto colB = MakeColumnValueExpression(inner_info->schema_, 0, "colB");
+  auto *inner_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+
+  // col1 and col3 have a tuple index of 0 because they are the outer side of the join
+  auto out_col1 = MakeColumnValueExpression(*outer_schema, 0, "col1");
+  auto out_col3 = MakeColumnValueExpression(*outer_schema, 0, "col3");
+  // colA and colB have a tuple index of 1 because they are the inner side of the join
+  auto out_colA = MakeColumnValueExpression(*inner_schema, 1, "colA");
+  auto out_colB = MakeColumnValueExpression(*inner_schema, 1, "colB");
+  auto *out_final = MakeOutputSchema({{"col1", out_col1}, {"col3", out_col3}, {"colA", out_colA}, {"colB", out_colB}});
+  for (auto kind : {IndexKind::BPLUS_TREE, IndexKind::EXTENDIBLE_HASH}) {
+    NestedIndexJoinPlanNode join_plan{out_final,
+                                      {&outer_plan},
+                                      MakeComparisonExpression(out_col1, out_colB, ComparisonType::Equal),
+                                      inner_info->oid_,
+                                      index_name(kind),
+                                      outer_schema,
+                                      inner_schema};
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), expected.size());
+    std::multiset<std::pair<int32_t, int32_t>> joined;
+    for (size_t i = 0; i < result_set.size(); i++) {
+      int32_t outer_col1 = result_set[i].GetValue(out_final, 0).GetAs<int32_t>();
+      ASSERT_EQ(outer_col1, result_set[i].GetValue(out_final, 3).GetAs<int32_t>());
+      // in the order of the outer tuples
+      if (i > 0) {
+        ASSERT_LE(result_set[i - 1].GetValue(out_final, 0).GetAs<int32_t>(), outer_col1);
+      }
+      joined.emplace(outer_col1, result_set[i].GetValue(out_final, 2).GetAs<int32_t>());
+    }
+    ASSERT_EQ(joined, expected);
+  }
+
+  // the predicate must give the probe key
+  NestedIndexJoinPlanNode range_plan{out_final,
+                                     {&outer_plan},
+                                     MakeComparisonExpression(out_col1, out_colB, ComparisonType::LessThan),
+                                     inner_info->oid_,
+                                     index_name(IndexKind::BPLUS_TREE),
+                                     outer_schema,
+                                     inner_schema};
+  NestIndexJoinExecutor range_join{GetExecutorContext(), &range_plan,
+                                   std::make_unique<IndexScanExecutor>(GetExecutorContext(), &outer_plan)};
+  ASSERT_THROW(range_join.Init(), NotImplementedException);
+  delete outer_key_schema;
+  delete inner_key_schema;
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, VarKeyIndexScanTest) {
+  // CREATE TABLE names (name varchar(64), id integer); CREATE INDEX ON names (name)
+  auto *catalog = GetExecutorContext()->GetCatalog();
+  Schema *table_schema = ParseCreateStatement("name varchar(64),id integer");
+  auto table_info = catalog->CreateTable(GetTxn(), "names", *table_schema);
+  auto &schema = table_info->schema_;
+  const int num_rows = 500;
+  // long keys sharing a prefix, each key held by several rows
+  auto make_name = [](int id) {
+    int key = id % 97;
+    return "/home/bustub/users/" + std::to_string(key) + std::string(key % 7, '_');
+  };
+  for (int id = 0; id < num_rows; id++) {
+    RID rid;
+    Tuple tuple({ValueFactory::GetVarcharValue(make_name(id)), ValueFactory::GetIntegerValue(id)}, &schema);
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+  Schema *key_schema = ParseCreateStatement("name varchar(64)");
+  auto index_info = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "names_name", "names", schema, *key_schema, {0}, 8, {}, IndexKind::VAR_KEY_BPLUS_TREE);
+
+  std::vector<RID> rids;
+  index_info->index_->ScanKey(Tuple({ValueFactory::GetVarcharValue(make_name(7))}, key_schema), &rids, GetTxn());
+  EXPECT_EQ(rids.size(), 6);
+  rids.clear();
+  // a prefix of a key matches none of its rows
+  index_info->index_->ScanKey(Tuple({ValueFactory::GetVarcharValue("/home/bustub/users/9")}, key_schema), &rids,
+                              GetTxn());
+  EXPECT_TRUE(rids.empty());
+
+  // SELECT name, id FROM names WHERE id < 400, in name order
+  auto name = MakeColumnValueExpression(schema, 0, "name");
+  auto id = MakeColumnValueExpression(schema, 0, "id");
+  auto const400 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(400));
+  auto *out_schema = MakeOutputSchema({{"name", name}, {"id", id}});
+  IndexScanPlanNode plan{out_schema, MakeComparisonExpression(id, const400, ComparisonType::LessThan),
+                         index_info->index_oid_};
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+  std::vector<std::pair<std::string, int32_t>> expected;
+  for (int id = 0; id < 400; id++) {
+    expected.emplace_back(make_name(id), id);
+  }
+  std::sort(expected.begin(), expected.end());
+  std::vector<std::pair<std::string, int32_t>> scanned;
+  for (const auto &tuple : result_set) {
+    scanned.emplace_back(tuple.GetValue(out_schema, 0).ToString(), tuple.GetValue(out_schema, 1).GetAs<int32_t>());
+  }
+  // rows sharing a name come in RID order, which is the insertion order here
+  EXPECT_EQ(scanned, expected);
+
+  // only VARCHAR columns can be encoded
+  Schema *int_key_schema = ParseCreateStatement("id integer");
+  ASSERT_THROW((catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+                   GetTxn(), "names_id", "names", schema, *int_key_schema, {1}, 8, {}, IndexKind::VAR_KEY_BPLUS_TREE)),
+               NotImplementedException);
+  delete table_schema;
+  delete key_schema;
+  delete int_key_schema;
+}
+
 // NOLINTNEXTLINE
 TEST_F(ExecutorTest, DISABLED_SimpleNestedLoopJoinTest) {
   // SELECT test_1.colA, test_1.colB, test_2.col1, test_2.col3 FROM test_1 JOIN test_2 ON test_1.colA = test_2.col1
@@ -0,0 +1,284 @@
+/**
+ * art_index_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/art_index.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+// big-endian, so that the byte order is the key order
+std::vector<uint8_t> EncodeKey(uint64_t key, size_t key_size) {
+  std::vector<uint8_t> bytes(key_size, 0);
+  for (size_t i = 0; i < 8; i++) {
+    bytes[key_size - 1 - i] = static_cast<uint8_t>(key >> (8 * i));
+  }
+  return bytes;
+}
+
+uint64_t DecodeKey(const uint8_t *bytes, size_t key_size) {
+  uint64_t key = 0;
+  for (size_t i = key_size - 8; i < key_size; i++) {
+    key = (key << 8) | bytes[i];
+  }
+  return key;
+}
+
+}  // namespace
+
+TEST(ARTIndexTest, InsertScanRemoveTest) {
+  // 32 byte keys: the leading zero bytes make long compressed prefixes
+  const size_t key_size = 32;
+  AdaptiveRadixTree tree(key_size);
+  std::vector<uint64_t> keys;
+  std::mt19937_64 rng(15445);
+  for (int i = 0; i < 5000; i++) {
+    // dense runs (full Node256 fan-out) and sparse keys (Node4 / Node16)
+    keys.push_back(i < 2000 ? static_cast<uint64_t>(i) : rng() >> (i % 48));
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  std::vector<uint64_t> shuffled(keys);
+  std::shuffle(shuffled.begin(), shuffled.end(), rng);
+  for (auto key : shuffled) {
+    EXPECT_TRUE(tree.Insert(EncodeKey(key, key_size).data(), RID(static_cast<page_id_t>(key >> 32), key)));
+  }
+  // duplicate pairs are rejected, more values per key are kept
+  EXPECT_FALSE(tree.Insert(EncodeKey(keys[0], key_size).data(), RID(0, keys[0])));
+  EXPECT_TRUE(tree.Insert(EncodeKey(keys[0], key_size).data(), RID(1, 1)));
+
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    rids.clear();
+    EXPECT_TRUE(tree.GetValue(EncodeKey(key, key_size).data(), &rids));
+    EXPECT_EQ(rids[0].GetSlotNum(), static_cast<uint32_t>(key));
+  }
+  EXPECT_EQ(rids.size(), 1);
+  rids.clear();
+  tree.GetValue(EncodeKey(keys[0], key_size).data(), &rids);
+  EXPECT_EQ(rids.size(), 2);
+  rids.clear();
+  EXPECT_FALSE(tree.GetValue(EncodeKey(keys.back() + 1, key_size).data(), &rids));
+
+  std::vector<uint64_t> scanned;
+  tree.Scan(nullptr, nullptr, [&](const uint8_t *key, const RID &rid) {
+    if (rid.GetSlotNum() == static_cast<uint32_t>(DecodeKey(key, key_size))) {
+      scanned.push_back(DecodeKey(key, key_size));
+    }
+    return true;
+  });
+  EXPECT_EQ(scanned, keys);
+
+  // remove every other key, and the extra value
+  EXPECT_TRUE(tree.Remove(EncodeKey(keys[0], key_size).data(), RID(1, 1)));
+  EXPECT_FALSE(tree.Remove(EncodeKey(keys[0], key_size).data(), RID(1, 1)));
+  std::vector<uint64_t> kept;
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (i % 2 == 0) {
+      EXPECT_TRUE(tree.Remove(EncodeKey(keys[i], key_size).data(),
+                              RID(static_cast<page_id_t>(keys[i] >> 32), keys[i])));
+    } else {
+      kept.push_back(keys[i]);
+    }
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    rids.clear();
+    EXPECT_EQ(tree.GetValue(EncodeKey(keys[i], key_size).data(), &rids), i % 2 == 1);
+  }
+
+  // bounded scan from a removed key
+  uint64_t lo = keys[keys.size() / 2 + 1];
+  uint64_t hi = keys[keys.size() / 2 + 301];
+  scanned.clear();
+  tree.Scan(EncodeKey(lo, key_size).data(), EncodeKey(hi, key_size).data(), [&](const uint8_t *key, const RID &rid) {
+    scanned.push_back(DecodeKey(key, key_size));
+    return true;
+  });
+  EXPECT_EQ(scanned, std::vector<uint64_t>(std::lower_bound(kept.begin(), kept.end(), lo),
+                                           std::upper_bound(kept.begin(), kept.end(), hi)));
+
+  // removing everything shrinks the tree back to the root
+  for (auto key : kept) {
+    EXPECT_TRUE(tree.Remove(EncodeKey(key, key_size).data(), RID(static_cast<page_id_t>(key >> 32), key)));
+  }
+  scanned.clear();
+  tree.Scan(nullptr, nullptr, [&](const uint8_t *key, const RID &rid) {
+    scanned.push_back(DecodeKey(key, key_size));
+    return true;
+  });
+  EXPECT_TRUE(scanned.empty());
+}
+
+TEST(ARTIndexTest, ConcurrentTest) {
+  const size_t key_size = 8;
+  AdaptiveRadixTree tree(key_size);
+  const int num_threads = 4;
+  const int per_thread = 20000;
+  // threads insert interleaved keys, remove the odd ones, and look up keys of the others meanwhile
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::vector<RID> rids;
+      for (int i = 0; i < per_thread; i++) {
+        uint64_t key = static_cast<uint64_t>(i) * num_threads + t;
+        tree.Insert(EncodeKey(key, key_size).data(), RID(0, key));
+        rids.clear();
+        tree.GetValue(EncodeKey(key ^ 1, key_size).data(), &rids);
+      }
+      for (int i = 1; i < per_thread; i += 2) {
+        uint64_t key = static_cast<uint64_t>(i) * num_threads + t;
+        tree.Remove(EncodeKey(key, key_size).data(), RID(0, key));
+      }
+    });
+  }
+  // a scanner running alongside only ever sees ascending keys
+  threads.emplace_back([&] {
+    for (int round = 0; round < 20; round++) {
+      uint64_t prev = 0;
+      bool first = true;
+      tree.Scan(nullptr, nullptr, [&](const uint8_t *key, const RID &rid) {
+        uint64_t value = DecodeKey(key, key_size);
+        EXPECT_TRUE(first || value > prev);
+        prev = value;
+        first = false;
+        return true;
+      });
+    }
+  });
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::vector<uint64_t> scanned;
+  tree.Scan(nullptr, nullptr, [&](const uint8_t *key, const RID &rid) {
+    scanned.push_back(DecodeKey(key, key_size));
+    return true;
+  });
+  std::vector<uint64_t> expected;
+  for (int i = 0; i < per_thread; i += 2) {
+    for (int t = 0; t < num_threads; t++) {
+      expected.push_back(static_cast<uint64_t>(i) * num_threads + t);
+    }
+  }
+  EXPECT_EQ(scanned, expected);
+}
+
+TEST(ARTIndexTest, IndexTest) {
+  Schema *schema = ParseCreateStatement("a bigint");
+  // the index owns its metadata
+  ARTIndex<GenericKey<8>, RID, GenericComparator<8>> index(new IndexMetadata("foo_pk", "foo", schema, {0}), nullptr);
+  for (int64_t key = -500; key < 500; key++) {
+    Tuple tuple({ValueFactory::GetBigIntValue(key)}, schema);
+    index.InsertEntry(tuple, RID(0, static_cast<uint32_t>(key + 500)), nullptr);
+  }
+  std::vector<RID> rids;
+  index.ScanKey(Tuple({ValueFactory::GetBigIntValue(-7)}, schema), &rids, nullptr);
+  ASSERT_EQ(rids.size(), 1);
+  EXPECT_EQ(rids[0].GetSlotNum(), 493);
+  index.DeleteEntry(Tuple({ValueFactory::GetBigIntValue(-7)}, schema), RID(0, 493), nullptr);
+  rids.clear();
+  index.ScanKey(Tuple({ValueFactory::GetBigIntValue(-7)}, schema), &rids, nullptr);
+  EXPECT_TRUE(rids.empty());
+
+  // normalized keys scan in value order, negative keys first
+  GenericKey<8> lo;
+  GenericKey<8> hi;
+  lo.SetFromInteger(-10);
+  hi.SetFromInteger(10);
+  std::vector<int64_t> scanned;
+  index.ScanRange(&lo, &hi, [&](const GenericKey<8> &key, const RID &rid) {
+    scanned.push_back(key.ToString());
+    return true;
+  });
+  std::vector<int64_t> expected;
+  for (int64_t key = -10; key <= 10; key++) {
+    if (key != -7) {
+      expected.push_back(key);
+    }
+  }
+  EXPECT_EQ(scanned, expected);
+  delete schema;
+}
+
+/*
+ * ARTIndex against BPlusTreeIndex on random 8 byte keys, run with
+ * --gtest_also_run_disabled_tests.
+ */
+TEST(ARTIndexTest, DISABLED_BenchmarkTest) {
+  const int num_keys = 1000000;
+  Schema *schema = ParseCreateStatement("a bigint");
+  std::vector<Tuple> tuples;
+  std::mt19937_64 rng(15445);
+  for (int i = 0; i < num_keys; i++) {
+    tuples.emplace_back(std::vector<Value>{ValueFactory::GetBigIntValue(static_cast<int64_t>(rng() >> 1))}, schema);
+  }
+  GenericKey<8> lo;
+  lo.SetFromInteger(0);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50000, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> b_plus_tree(
+      new IndexMetadata("foo_pk", "foo", schema, {0}), bpm);
+  ARTIndex<GenericKey<8>, RID, GenericComparator<8>> art(new IndexMetadata("foo_art", "foo", schema, {0}), bpm);
+
+  // the B+ tree latch crabbing records its latches in the transaction
+  Transaction transaction(0);
+  auto run = [&](const char *name, Index *index, const std::function<int()> &scan) {
+    auto start = std::chrono::steady_clock::now();
+    auto lap = [&](const char *phase) {
+      auto now = std::chrono::steady_clock::now();
+      auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
+      std::cout << name << " " << phase << ": " << ms << " ms" << std::endl;
+      start = now;
+    };
+    for (int i = 0; i < num_keys; i++) {
+      index->InsertEntry(tuples[i], RID(0, i), &transaction);
+    }
+    lap("insert");
+    std::vector<RID> rids;
+    for (int i = 0; i < num_keys; i++) {
+      rids.clear();
+      index->ScanKey(tuples[i], &rids, &transaction);
+    }
+    lap("lookup");
+    EXPECT_EQ(scan(), num_keys);
+    lap("scan");
+  };
+  run("b+ tree", &b_plus_tree, [&] {
+    int count = 0;
+    for (auto it = b_plus_tree.GetBeginIterator(lo); !it.isEnd(); ++it) {
+      count++;
+    }
+    return count;
+  });
+  run("art", &art, [&] {
+    int count = 0;
+    art.ScanRange(&lo, nullptr, [&](const GenericKey<8> &key, const RID &rid) { return ++count > 0; });
+    return count;
+  });
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  delete schema;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,238 @@
+/**
+ * b_link_tree_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>                   // NOLINT
+#include "b_plus_tree_test_util.h"  // NOLINT
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_link_tree.h"
+
+namespace bustub {
+// helper function to launch multiple threads
+template <typename... Args>
+void LaunchParallelTest(uint64_t num_threads, Args &&... args) {
+  std::vector<std::thread> thread_group;
+
+  // Launch a group of threads
+  for (uint64_t thread_itr = 0; thread_itr < num_threads; ++thread_itr) {
+    thread_group.push_back(std::thread(args..., thread_itr));
+  }
+
+  // Join the threads with the main thread
+  for (uint64_t thread_itr = 0; thread_itr < num_threads; ++thread_itr) {
+    thread_group[thread_itr].join();
+  }
+}
+
+// helper function to seperate insert
+void InsertHelperSplit(BLinkTree<GenericKey<8>, RID, GenericComparator<8>> *tree, const std::vector<int64_t> &keys,
+                       int total_threads, uint64_t thread_itr) {
+  GenericKey<8> index_key;
+  RID rid;
+  for (auto key : keys) {
+    if (static_cast<uint64_t>(key) % total_threads == thread_itr) {
+      int64_t value = key & 0xFFFFFFFF;
+      rid.Set(static_cast<int32_t>(key >> 32), value);
+      index_key.SetFromInteger(key);
+      tree->Insert(index_key, rid);
+    }
+  }
+}
+
+// helper function to seperate delete
+void DeleteHelperSplit(BLinkTree<GenericKey<8>, RID, GenericComparator<8>> *tree,
+                       const std::vector<int64_t> &remove_keys, int total_threads, uint64_t thread_itr) {
+  GenericKey<8> index_key;
+  for (auto key : remove_keys) {
+    if (static_cast<uint64_t>(key) % total_threads == thread_itr) {
+      index_key.SetFromInteger(key);
+      tree->Remove(index_key);
+    }
+  }
+}
+
+TEST(BLinkTreeTest, InsertRemoveTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(500, disk_manager);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  // small pages so that splits propagate up several levels
+  BLinkTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 3);
+  GenericKey<8> index_key;
+  RID rid;
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 200; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid));
+  }
+  // duplicate keys are rejected
+  index_key.SetFromInteger(keys[0]);
+  EXPECT_FALSE(tree.Insert(index_key, rid));
+
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    EXPECT_EQ(rids.size(), 1);
+    EXPECT_EQ(rids[0].GetSlotNum(), key);
+  }
+
+  // remove every odd key, leaves are left underfull or empty
+  for (auto key : keys) {
+    if (key % 2 == 1) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+    }
+  }
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), key % 2 == 0);
+  }
+
+  int64_t current_key = 2;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key += 2;
+  }
+  EXPECT_EQ(current_key, 202);
+
+  // start in the middle, on a removed key
+  current_key = 100;
+  index_key.SetFromInteger(99);
+  for (auto iterator = tree.Begin(index_key); !iterator.isEnd(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key += 2;
+  }
+  EXPECT_EQ(current_key, 202);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BLinkTreeTest, SmallPoolTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  // far fewer frames than operations, every operation must give its pins back
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  BLinkTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 3);
+  GenericKey<8> index_key;
+  RID rid;
+
+  for (int64_t key = 1; key <= 300; key++) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid));
+  }
+  index_key.SetFromInteger(1);
+  EXPECT_FALSE(tree.Insert(index_key, rid));
+
+  std::vector<RID> rids;
+  for (int round = 0; round < 2; round++) {
+    for (int64_t key = 1; key <= 300; key++) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    }
+  }
+  for (int64_t key = 1; key <= 300; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key);
+  }
+  int64_t current_key = 2;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key += 2;
+  }
+  EXPECT_EQ(current_key, 302);
+
+  page_id_t probe_id;
+  EXPECT_NE(bpm->NewPage(&probe_id), nullptr);
+  bpm->UnpinPage(probe_id, false);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BLinkTreeTest, ConcurrentInsertRemoveTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(1000, disk_manager);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  BLinkTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+  GenericKey<8> index_key;
+  std::vector<RID> rids;
+
+  // even keys exist up front and are removed while odd keys are inserted
+  std::vector<int64_t> even_keys;
+  std::vector<int64_t> odd_keys;
+  for (int64_t key = 1; key <= 1000; key++) {
+    (key % 2 == 0 ? even_keys : odd_keys).push_back(key);
+  }
+  LaunchParallelTest(4, InsertHelperSplit, &tree, even_keys, 4);
+
+  std::thread remover([&tree, &even_keys] { LaunchParallelTest(2, DeleteHelperSplit, &tree, even_keys, 2); });
+  LaunchParallelTest(4, InsertHelperSplit, &tree, odd_keys, 4);
+  remover.join();
+
+  for (int64_t key = 1; key <= 1000; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), key % 2 == 1);
+  }
+
+  int64_t current_key = 1;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key += 2;
+  }
+  EXPECT_EQ(current_key, 1001);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
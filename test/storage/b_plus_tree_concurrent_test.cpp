@@ -2,6 +2,7 @@
  * b_plus_tree_test.cpp
  */
 
+#include <algorithm>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
@@ -197,6 +198,62 @@ TEST(BPlusTreeConcurrentTest, InsertTest2) {
   remove("test.log");
 }
 
+TEST(BPlusTreeConcurrentTest, SplitInsertTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(500, disk_manager);
+  // small pages so that most inserts take the optimistic path and some of them have to retry
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  // keys to Insert
+  std::vector<int64_t> keys;
+  int64_t scale_factor = 300;
+  for (int64_t key = 1; key < scale_factor; key++) {
+    keys.push_back(key);
+  }
+  LaunchParallelTest(4, InsertHelperSplit, &tree, keys, 4);
+
+  std::vector<RID> rids;
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    tree.GetValue(index_key, &rids);
+    EXPECT_EQ(rids.size(), 1);
+
+    int64_t value = key & 0xFFFFFFFF;
+    EXPECT_EQ(rids[0].GetSlotNum(), value);
+  }
+
+  // remove half of the keys concurrently, then check what is left
+  std::vector<int64_t> remove_keys;
+  for (int64_t key = 1; key < scale_factor; key += 2) {
+    remove_keys.push_back(key);
+  }
+  LaunchParallelTest(4, DeleteHelperSplit, &tree, remove_keys, 4);
+
+  int64_t current_key = 2;
+  index_key.SetFromInteger(current_key);
+  for (auto iterator = tree.Begin(index_key); iterator.isEnd() == false; ++iterator) {
+    auto location = (*iterator).second;
+    EXPECT_EQ(location.GetSlotNum(), current_key);
+    current_key = current_key + 2;
+  }
+  EXPECT_EQ(current_key, scale_factor);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 TEST(BPlusTreeConcurrentTest, DeleteTest1) {
   // create KeyComparator and index schema
   Schema *key_schema = ParseCreateStatement("a bigint");
@@ -330,4 +387,175 @@ TEST(BPlusTreeConcurrentTest, MixTest) {
   remove("test.log");
 }
 
+TEST(BPlusTreeConcurrentTest, ReverseScanTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(200, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // even keys exist up front, odd keys are inserted while scanning backwards
+  std::vector<int64_t> even_keys;
+  std::vector<int64_t> odd_keys;
+  for (int64_t key = 1; key <= 1000; key++) {
+    (key % 2 == 0 ? even_keys : odd_keys).push_back(key);
+  }
+  InsertHelper(&tree, even_keys);
+
+  std::thread scanner([&tree] {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(1000);
+    for (int round = 0; round < 20; round++) {
+      int64_t prev_key = 1001;
+      int64_t evens = 0;
+      for (auto iterator = tree.RBegin(index_key); iterator.isEnd() == false; ++iterator) {
+        int64_t key = (*iterator).second.GetSlotNum();
+        EXPECT_LT(key, prev_key);
+        evens += key % 2 == 0 ? 1 : 0;
+        prev_key = key;
+      }
+      // the even keys are never removed, so every one of them is seen
+      EXPECT_EQ(evens, 500);
+    }
+  });
+  LaunchParallelTest(2, InsertHelperSplit, &tree, odd_keys, 2);
+  scanner.join();
+
+  int64_t current_key = 1000;
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(current_key);
+  for (auto iterator = tree.RBegin(index_key); iterator.isEnd() == false; ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key--;
+  }
+  EXPECT_EQ(current_key, 0);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, ParallelScanTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(1000, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 8, 8);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 3000; key++) {
+    keys.push_back(key);
+  }
+  InsertHelper(&tree, keys);
+
+  GenericKey<8> lo;
+  GenericKey<8> hi;
+  lo.SetFromInteger(100);
+  hi.SetFromInteger(2900);
+  for (int partitions : {1, 3, 8}) {
+    std::vector<std::vector<int64_t>> scanned(partitions);
+    int used = tree.ParallelScan(&lo, &hi, partitions, [&scanned](int partition, const auto &item) {
+      scanned[partition].push_back(item.second.GetSlotNum());
+    });
+    EXPECT_EQ(used, partitions);
+
+    // partitions are non-empty, ordered, and together hold exactly [lo, hi]
+    std::vector<int64_t> all;
+    for (int i = 0; i < used; i++) {
+      EXPECT_FALSE(scanned[i].empty());
+      EXPECT_TRUE(std::is_sorted(scanned[i].begin(), scanned[i].end()));
+      all.insert(all.end(), scanned[i].begin(), scanned[i].end());
+    }
+    ASSERT_EQ(all.size(), 2801);
+    for (size_t i = 0; i < all.size(); i++) {
+      EXPECT_EQ(all[i], static_cast<int64_t>(i) + 100);
+    }
+    // roughly equal sizes
+    for (int i = 0; i < used; i++) {
+      EXPECT_LT(scanned[i].size(), 3 * all.size() / used);
+    }
+  }
+
+  // open bounds
+  std::vector<int64_t> counts(4, 0);
+  int used = tree.ParallelScan(nullptr, nullptr, 4, [&counts](int partition, const auto &) { counts[partition]++; });
+  EXPECT_EQ(used, 4);
+  EXPECT_EQ(counts[0] + counts[1] + counts[2] + counts[3], 3000);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, CompactorTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(1000, disk_manager);
+  // create b+ tree whose underfull leaves are merged by the background compactor
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+  tree.SetDeferredMerge(true);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  std::vector<int64_t> keys;
+  std::vector<int64_t> remove_keys;
+  for (int64_t key = 1; key <= 2000; key++) {
+    keys.push_back(key);
+    if (key % 4 != 0) {
+      remove_keys.push_back(key);
+    }
+  }
+  InsertHelper(&tree, keys);
+
+  // removals race with the compactor
+  tree.StartCompactor(std::chrono::milliseconds(1), 16);
+  LaunchParallelTest(4, DeleteHelperSplit, &tree, remove_keys, 4);
+  for (int i = 0; i < 5000 && tree.GetUnderfullLeafCount() > 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  tree.StopCompactor();
+  EXPECT_EQ(tree.GetUnderfullLeafCount(), 0);
+
+  int64_t current_key = 4;
+  for (auto iterator = tree.begin(); iterator.isEnd() == false; ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key += 4;
+  }
+  EXPECT_EQ(current_key, 2004);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
 
 #include "b_plus_tree_test_util.h"  // NOLINT
 #include "buffer/buffer_pool_manager.h"
@@ -170,4 +171,320 @@ TEST(BPlusTreeTests, DeleteTest2) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, ReverseIteratorTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree with small pages, so that leaves split and merge often
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  index_key.SetFromInteger(10);
+  EXPECT_TRUE(tree.RBegin(index_key).isEnd());
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 300; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  // start on an existing key and past the last key
+  int64_t current_key = 150;
+  index_key.SetFromInteger(current_key);
+  for (auto iterator = tree.RBegin(index_key); iterator.isEnd() == false; ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key--;
+  }
+  EXPECT_EQ(current_key, 0);
+  current_key = 300;
+  index_key.SetFromInteger(1000);
+  for (auto iterator = tree.RBegin(index_key); iterator.isEnd() == false; ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key--;
+  }
+  EXPECT_EQ(current_key, 0);
+
+  // merges must keep the prev links intact
+  for (auto key : keys) {
+    if (key % 3 != 0) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, transaction);
+    }
+  }
+  current_key = 198;
+  index_key.SetFromInteger(200);
+  for (auto iterator = tree.RBegin(index_key); iterator.isEnd() == false; ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key -= 3;
+  }
+  EXPECT_EQ(current_key, 0);
+  index_key.SetFromInteger(2);
+  EXPECT_TRUE(tree.RBegin(index_key).isEnd());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+TEST(BPlusTreeTests, DeferredMergeTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(200, disk_manager);
+  // create b+ tree with small pages, removals only mark underfull leaves
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+  tree.SetDeferredMerge(true);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 300; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  // keep the multiples of 5 and the keys 101..120, which leaves empty leaves behind
+  std::vector<int64_t> expected;
+  for (int64_t key = 1; key <= 300; key++) {
+    if (key % 5 == 0 || (key > 100 && key <= 120)) {
+      expected.push_back(key);
+    }
+  }
+  for (auto key : keys) {
+    if (!std::binary_search(expected.begin(), expected.end(), key)) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, transaction);
+    }
+  }
+  auto check = [&]() {
+    std::vector<int64_t> scanned;
+    for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+      scanned.push_back((*iterator).second.GetSlotNum());
+    }
+    EXPECT_EQ(scanned, expected);
+    scanned.clear();
+    index_key.SetFromInteger(1000);
+    for (auto iterator = tree.RBegin(index_key); !iterator.isEnd(); ++iterator) {
+      scanned.push_back((*iterator).second.GetSlotNum());
+    }
+    EXPECT_EQ(scanned, std::vector<int64_t>(expected.rbegin(), expected.rend()));
+    std::vector<RID> rids;
+    for (int64_t key = 1; key <= 300; key++) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      EXPECT_EQ(tree.GetValue(index_key, &rids), std::binary_search(expected.begin(), expected.end(), key));
+    }
+  };
+  auto count_leaves = [&]() {
+    index_key.SetFromInteger(0);
+    auto *leaf = tree.FindLeafPage(index_key, true);
+    page_id_t leaf_page_id = leaf->GetPageId();
+    bpm->FetchPage(leaf_page_id)->RUnlatch();
+    bpm->UnpinPage(leaf_page_id, false);
+    int leaves = 0;
+    while (leaf_page_id != INVALID_PAGE_ID) {
+      leaf = reinterpret_cast<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>> *>(
+          bpm->FetchPage(leaf_page_id)->GetData());
+      page_id_t next_page_id = leaf->GetNextPageId();
+      bpm->UnpinPage(leaf_page_id, false);
+      leaf_page_id = next_page_id;
+      leaves++;
+    }
+    return leaves;
+  };
+  check();
+  size_t marked = tree.GetUnderfullLeafCount();
+  EXPECT_GT(marked, 0);
+  int leaves = count_leaves();
+
+  // a bounded step handles at most the requested number of leaves
+  EXPECT_EQ(tree.Compact(1), 1);
+  while (tree.Compact(8) > 0) {
+  }
+  EXPECT_EQ(tree.GetUnderfullLeafCount(), 0);
+  EXPECT_LT(count_leaves(), leaves);
+  check();
+
+  // removals after compaction and inserts into the merged leaves
+  for (int64_t key = 5; key <= 300; key += 10) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+    expected.erase(std::find(expected.begin(), expected.end(), key));
+  }
+  for (int64_t key = 26; key <= 300; key += 50) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+    expected.insert(std::lower_bound(expected.begin(), expected.end(), key), key);
+  }
+  tree.Compact(1000);
+  check();
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, StatsTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(500, disk_manager);
+  // create b+ tree with small pages, so that it has several levels
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 8, 6);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // count the pages of every level by following the leaf chain and then the parent page ids
+  auto check = [&]() {
+    auto stats = tree.GetStats();
+    if (tree.IsEmpty()) {
+      EXPECT_EQ(stats.height_, 0);
+      EXPECT_EQ(stats.leaf_entries_, 0);
+      return;
+    }
+    index_key.SetFromInteger(0);
+    auto *leaf = tree.FindLeafPage(index_key, true);
+    page_id_t leaf_page_id = leaf->GetPageId();
+    bpm->FetchPage(leaf_page_id)->RUnlatch();
+    bpm->UnpinPage(leaf_page_id, false);
+    std::vector<page_id_t> level;
+    size_t entries = 0;
+    while (leaf_page_id != INVALID_PAGE_ID) {
+      leaf = reinterpret_cast<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>> *>(
+          bpm->FetchPage(leaf_page_id)->GetData());
+      level.push_back(leaf_page_id);
+      entries += leaf->GetSize();
+      page_id_t next_page_id = leaf->GetNextPageId();
+      bpm->UnpinPage(leaf_page_id, false);
+      leaf_page_id = next_page_id;
+    }
+    std::vector<size_t> level_pages;
+    while (true) {
+      level_pages.push_back(level.size());
+      std::vector<page_id_t> parents;
+      for (auto child_page_id : level) {
+        auto *node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(child_page_id)->GetData());
+        if (node->GetParentPageId() != INVALID_PAGE_ID &&
+            std::find(parents.begin(), parents.end(), node->GetParentPageId()) == parents.end()) {
+          parents.push_back(node->GetParentPageId());
+        }
+        bpm->UnpinPage(child_page_id, false);
+      }
+      if (parents.empty()) {
+        break;
+      }
+      level = std::move(parents);
+    }
+    EXPECT_EQ(stats.height_, static_cast<int>(level_pages.size()));
+    EXPECT_EQ(stats.level_pages_, level_pages);
+    EXPECT_EQ(stats.leaf_entries_, entries);
+    EXPECT_DOUBLE_EQ(stats.leaf_fill_factor_, static_cast<double>(entries) / (level_pages[0] * 8));
+    EXPECT_GT(stats.leaf_fill_factor_, 0.4);
+    EXPECT_LE(stats.internal_fill_factor_, 1.0);
+  };
+
+  const int64_t num_keys = 2000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < num_keys; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+  check();
+  EXPECT_GE(tree.GetStats().height_, 4);
+
+  // the sampled quartiles of 0..num_keys - 1 land near the real ones
+  auto bounds = tree.SampleHistogram(4, 200);
+  ASSERT_EQ(bounds.size(), 4);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_NEAR(bounds[i].ToString(), num_keys * (i + 1) / 4, num_keys / 8);
+    if (i > 0) {
+      EXPECT_LE(bounds[i - 1].ToString(), bounds[i].ToString());
+    }
+  }
+
+  // merges shrink the levels, removing everything empties the tree
+  for (auto key : keys) {
+    if (key % 4 != 0) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, transaction);
+    }
+  }
+  check();
+  for (int64_t key = 0; key < num_keys; key += 4) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  check();
+  EXPECT_TRUE(tree.SampleHistogram(4, 10).empty());
+
+  // bulk loading sets the counters at once
+  std::vector<std::pair<GenericKey<8>, RID>> pairs;
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    pairs.emplace_back(index_key, RID(0, key));
+  }
+  EXPECT_TRUE(tree.BulkLoad(pairs.begin(), pairs.end(), 0.75));
+  check();
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
 
 #include "b_plus_tree_test_util.h"  // NOLINT
 #include "buffer/buffer_pool_manager.h"
@@ -139,4 +140,622 @@ TEST(BPlusTreeTests, InsertTest2) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, SmallPoolLookupTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+  GenericKey<8> index_key;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 200;
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key), transaction);
+  }
+  // lookups without a transaction release every pin they take, far more of them than the pool has frames
+  std::vector<RID> rids;
+  for (int round = 0; round < 5; round++) {
+    for (int64_t key = 0; key < num_keys; key++) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      ASSERT_TRUE(tree.GetValue(index_key, &rids));
+      EXPECT_EQ(rids[0].GetSlotNum(), key);
+    }
+  }
+  page_id_t probe_id;
+  ASSERT_NE(bpm->NewPage(&probe_id), nullptr);
+  bpm->UnpinPage(probe_id, false);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, BulkLoadTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(500, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 8, 6);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // even keys are loaded, odd keys are inserted afterwards
+  std::vector<std::pair<GenericKey<8>, RID>> items;
+  for (int64_t key = 2; key <= 1000; key += 2) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    items.emplace_back(index_key, rid);
+  }
+  EXPECT_TRUE(tree.BulkLoad(items.begin(), items.end(), 0.75, transaction));
+  EXPECT_FALSE(tree.BulkLoad(items.begin(), items.end(), 0.75, transaction));
+
+  // leaves are built at 6 of 8 entries
+  auto *leaf = tree.FindLeafPage(index_key, true);
+  EXPECT_EQ(leaf->GetSize(), 6);
+  bpm->FetchPage(leaf->GetPageId())->RUnlatch();
+  bpm->UnpinPage(leaf->GetPageId(), false);
+
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= 1000; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), key % 2 == 0);
+  }
+
+  // the loaded tree keeps working with regular inserts and removes
+  for (int64_t key = 1; key <= 1000; key += 2) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+  for (int64_t key = 1; key <= 500; key++) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+
+  int64_t current_key = 501;
+  for (auto iterator = tree.begin(); iterator.isEnd() == false; ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key = current_key + 1;
+  }
+  EXPECT_EQ(current_key, 1001);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, DuplicateKeyTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  // create non-unique b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, false);
+  GenericKey<8> index_key;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // key 0 gets enough values to spill over several posting pages, keys 1..50 two each
+  const int hot_values = 4000;
+  for (int i = 0; i < hot_values; i++) {
+    index_key.SetFromInteger(0);
+    // insert out of order
+    EXPECT_TRUE(tree.Insert(index_key, RID(i % 7, i * 1000), transaction));
+  }
+  for (int64_t key = 1; key <= 50; key++) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(1, key), transaction));
+    EXPECT_TRUE(tree.Insert(index_key, RID(2, key), transaction));
+    // the same pair is rejected
+    EXPECT_FALSE(tree.Insert(index_key, RID(2, key), transaction));
+  }
+
+  std::vector<RID> rids;
+  index_key.SetFromInteger(0);
+  tree.GetValue(index_key, &rids);
+  EXPECT_EQ(rids.size(), hot_values);
+  // values come back sorted
+  for (size_t i = 1; i < rids.size(); i++) {
+    EXPECT_TRUE(rids[i - 1].GetPageId() < rids[i].GetPageId() ||
+                (rids[i - 1].GetPageId() == rids[i].GetPageId() && rids[i - 1].GetSlotNum() < rids[i].GetSlotNum()));
+  }
+
+  // remove single values: all but one value of key 0, and one value of every odd key
+  for (int i = 1; i < hot_values; i++) {
+    index_key.SetFromInteger(0);
+    tree.Remove(index_key, RID(i % 7, i * 1000), transaction);
+  }
+  for (int64_t key = 1; key <= 50; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, RID(1, key), transaction);
+    // not in the tree any more
+    tree.Remove(index_key, RID(1, key), transaction);
+  }
+  // remove key 2 with all its values
+  index_key.SetFromInteger(2);
+  tree.Remove(index_key, transaction);
+
+  rids.clear();
+  index_key.SetFromInteger(0);
+  tree.GetValue(index_key, &rids);
+  ASSERT_EQ(rids.size(), 1);
+  EXPECT_EQ(rids[0].GetSlotNum(), 0);
+
+  // the iterator returns every value of a duplicate key, in order
+  std::vector<std::pair<int64_t, RID>> entries;
+  for (auto iterator = tree.begin(); iterator.isEnd() == false; ++iterator) {
+    entries.emplace_back((*iterator).first.ToString(), (*iterator).second);
+  }
+  std::vector<std::pair<int64_t, RID>> expected = {{0, RID(0, 0)}};
+  for (int64_t key = 1; key <= 50; key++) {
+    if (key % 2 == 0 && key != 2) {
+      expected.emplace_back(key, RID(1, key));
+    }
+    if (key != 2) {
+      expected.emplace_back(key, RID(2, key));
+    }
+  }
+  EXPECT_EQ(entries, expected);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, InlineListTest) {
+  using LeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  // a non-unique tree and a unique one of the same shape, to compare the pages they take
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, false);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> unique_tree("bar_pk", bpm, comparator, 4, 4);
+  GenericKey<8> index_key;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // every key gets as many values as an inline list holds, after the tree took its shape
+  const int num_keys = 100;
+  for (int v = 0; v < LeafPage::INLINE_LIST_SIZE; v++) {
+    for (int64_t key = 0; key < num_keys; key++) {
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(tree.Insert(index_key, RID(LeafPage::INLINE_LIST_SIZE - v, key), transaction));
+      if (v == 0) {
+        EXPECT_TRUE(unique_tree.Insert(index_key, RID(0, key), transaction));
+      }
+    }
+  }
+  index_key.SetFromInteger(0);
+  EXPECT_FALSE(tree.Insert(index_key, RID(1, 0), transaction));
+  // both trees took the same number of pages: no posting page was allocated
+  page_id_t first_probe_id;
+  bpm->NewPage(&first_probe_id);
+  bpm->UnpinPage(first_probe_id, false);
+  EXPECT_EQ(unique_tree.GetStats().level_pages_[0], tree.GetStats().level_pages_[0]);
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < num_keys; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(rids.size(), LeafPage::INLINE_LIST_SIZE);
+    for (int v = 0; v < LeafPage::INLINE_LIST_SIZE; v++) {
+      EXPECT_EQ(rids[v], RID(v + 1, key));
+    }
+  }
+
+  // merges and redistributions move the lists of the remaining keys along
+  for (int64_t key = 0; key < num_keys; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  for (int64_t key = 1; key < num_keys; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, RID(1, key), transaction);
+  }
+  std::vector<std::pair<int64_t, RID>> entries;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    entries.emplace_back((*iterator).first.ToString(), (*iterator).second);
+  }
+  std::vector<std::pair<int64_t, RID>> expected;
+  for (int64_t key = 1; key < num_keys; key += 2) {
+    for (int v = 2; v <= LeafPage::INLINE_LIST_SIZE; v++) {
+      expected.emplace_back(key, RID(v, key));
+    }
+  }
+  EXPECT_EQ(entries, expected);
+
+  // a list past INLINE_LIST_SIZE values spills to a posting list, one value turns back into a plain value
+  index_key.SetFromInteger(1);
+  EXPECT_TRUE(tree.Insert(index_key, RID(1, 1), transaction));
+  EXPECT_TRUE(tree.Insert(index_key, RID(100, 1), transaction));
+  page_id_t second_probe_id;
+  bpm->NewPage(&second_probe_id);
+  bpm->UnpinPage(second_probe_id, false);
+  EXPECT_EQ(second_probe_id, first_probe_id + 2);
+  rids.clear();
+  EXPECT_TRUE(tree.GetValue(index_key, &rids));
+  EXPECT_EQ(rids.size(), LeafPage::INLINE_LIST_SIZE + 1);
+  index_key.SetFromInteger(3);
+  for (int v = 2; v < LeafPage::INLINE_LIST_SIZE; v++) {
+    tree.Remove(index_key, RID(v, 3), transaction);
+  }
+  rids.clear();
+  EXPECT_TRUE(tree.GetValue(index_key, &rids));
+  EXPECT_EQ(rids, std::vector<RID>{RID(LeafPage::INLINE_LIST_SIZE, 3)});
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, InlineListFullLeafTest) {
+  // LEAF_PAGE_SIZE is defined in terms of KeyType and ValueType
+  using KeyType = GenericKey<8>;
+  using ValueType = RID;
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  // full size leaves, which run out of room for their lists before they reach their max size
+  BPlusTree<KeyType, ValueType, GenericComparator<8>> tree("foo_pk", bpm, comparator, LEAF_PAGE_SIZE, 100, false);
+  KeyType index_key;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int num_keys = 5000;
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key * 7 % num_keys);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key * 7 % num_keys), transaction));
+    EXPECT_TRUE(tree.Insert(index_key, RID(1, key * 7 % num_keys), transaction));
+  }
+  for (int64_t key = 0; key < num_keys; key++) {
+    std::vector<RID> rids;
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    EXPECT_EQ(rids, (std::vector<RID>{RID(0, key), RID(1, key)}));
+  }
+  // leaves split when their lists fill them up, instead of spilling the lists to a page each
+  EXPECT_LT(tree.GetStats().level_pages_[0], num_keys / 16);
+  page_id_t probe_id;
+  bpm->NewPage(&probe_id);
+  bpm->UnpinPage(probe_id, false);
+  EXPECT_LT(probe_id, num_keys / 10);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, ScanRangeTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create non-unique b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, false);
+  GenericKey<8> index_key;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // empty tree
+  std::vector<std::pair<GenericKey<8>, RID>> batch;
+  EXPECT_FALSE(tree.ScanRange(nullptr, true, nullptr, true, nullptr, &batch, 10));
+  EXPECT_TRUE(batch.empty());
+
+  // keys 1..100, key 50 has three values
+  for (int64_t key = 1; key <= 100; key++) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key), transaction));
+  }
+  index_key.SetFromInteger(50);
+  EXPECT_TRUE(tree.Insert(index_key, RID(1, 50), transaction));
+  EXPECT_TRUE(tree.Insert(index_key, RID(2, 50), transaction));
+
+  // scan (10, 90] in batches of 7, keeping even keys only
+  GenericKey<8> lo;
+  GenericKey<8> hi;
+  lo.SetFromInteger(10);
+  hi.SetFromInteger(90);
+  auto even = [](const GenericKey<8> &key) { return key.ToString() % 2 == 0; };
+  std::vector<std::pair<int64_t, RID>> entries;
+  bool more = tree.ScanRange(&lo, false, &hi, true, even, &batch, 7);
+  while (true) {
+    EXPECT_LE(batch.size(), more ? 9 : 7);
+    for (const auto &item : batch) {
+      entries.emplace_back(item.first.ToString(), item.second);
+    }
+    if (!more) {
+      break;
+    }
+    GenericKey<8> last_key = batch.back().first;
+    more = tree.ScanRange(&last_key, false, &hi, true, even, &batch, 7);
+  }
+  std::vector<std::pair<int64_t, RID>> expected;
+  for (int64_t key = 12; key <= 90; key += 2) {
+    expected.emplace_back(key, RID(0, key));
+    if (key == 50) {
+      expected.emplace_back(key, RID(1, key));
+      expected.emplace_back(key, RID(2, key));
+    }
+  }
+  EXPECT_EQ(entries, expected);
+
+  // open bounds and exclusive upper bound
+  EXPECT_FALSE(tree.ScanRange(nullptr, true, nullptr, true, nullptr, &batch, 1000));
+  EXPECT_EQ(batch.size(), 102);
+  EXPECT_FALSE(tree.ScanRange(nullptr, true, &hi, false, nullptr, &batch, 1000));
+  EXPECT_EQ(batch.size(), 91);
+  EXPECT_EQ(batch.back().first.ToString(), 89);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, SmallPoolScanRangeTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+  GenericKey<8> index_key;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  for (int64_t key = 1; key <= 200; key++) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key), transaction));
+  }
+
+  // many more batches than frames, every batch must give its pins back
+  std::vector<std::pair<GenericKey<8>, RID>> batch;
+  for (int round = 0; round < 3; round++) {
+    int64_t expected = 1;
+    bool more = tree.ScanRange(nullptr, true, nullptr, true, nullptr, &batch, 1);
+    while (true) {
+      for (const auto &item : batch) {
+        EXPECT_EQ(item.first.ToString(), expected++);
+      }
+      if (!more) {
+        break;
+      }
+      GenericKey<8> last_key = batch.back().first;
+      more = tree.ScanRange(&last_key, false, nullptr, true, nullptr, &batch, 1);
+    }
+    EXPECT_EQ(expected, 201);
+  }
+  page_id_t probe_id;
+  EXPECT_NE(bpm->NewPage(&probe_id), nullptr);
+  bpm->UnpinPage(probe_id, false);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, GetValuesTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(200, disk_manager);
+  // create non-unique b+ tree with small pages, so that probes spread over many paths
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, false);
+  GenericKey<8> index_key;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // even keys 0..998, multiples of 10 have a second value
+  for (int64_t key = 0; key < 1000; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key), transaction);
+    if (key % 10 == 0) {
+      tree.Insert(index_key, RID(1, key), transaction);
+    }
+  }
+
+  // unsorted probes with misses and repeated keys
+  std::mt19937 gen(15445);
+  std::vector<GenericKey<8>> keys(300);
+  std::vector<int64_t> probes(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    probes[i] = static_cast<int64_t>(gen() % 1100);
+    keys[i].SetFromInteger(probes[i]);
+  }
+  std::vector<std::vector<RID>> results;
+  int found = tree.GetValues(keys, &results);
+  ASSERT_EQ(results.size(), keys.size());
+
+  int expected_found = 0;
+  std::vector<RID> rids;
+  for (size_t i = 0; i < keys.size(); i++) {
+    rids.clear();
+    expected_found += tree.GetValue(keys[i], &rids) ? 1 : 0;
+    EXPECT_EQ(results[i], rids);
+    EXPECT_EQ(results[i].size(), probes[i] >= 1000 || probes[i] % 2 == 1 ? 0 : probes[i] % 10 == 0 ? 2 : 1);
+  }
+  EXPECT_EQ(found, expected_found);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+TEST(BPlusTreeTests, AppendInsertTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(200, disk_manager);
+  // create b+ tree with small pages, so that appends split many times
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+  GenericKey<8> index_key;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // increasing keys 0, 10, ..., 990
+  for (int64_t key = 0; key < 1000; key += 10) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key), transaction));
+  }
+  // appending leaves every leaf full (100 keys in 25 leaves), where 50/50 splits would leave them half empty
+  index_key.SetFromInteger(0);
+  auto *leaf = tree.FindLeafPage(index_key, true);
+  page_id_t leaf_page_id = leaf->GetPageId();
+  bpm->FetchPage(leaf_page_id)->RUnlatch();
+  bpm->UnpinPage(leaf_page_id, false);
+  int leaves = 0;
+  while (leaf_page_id != INVALID_PAGE_ID) {
+    leaf = reinterpret_cast<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>> *>(
+        bpm->FetchPage(leaf_page_id)->GetData());
+    page_id_t next_page_id = leaf->GetNextPageId();
+    EXPECT_EQ(leaf->GetSize(), 4);
+    bpm->UnpinPage(leaf_page_id, false);
+    leaf_page_id = next_page_id;
+    leaves++;
+  }
+  EXPECT_EQ(leaves, 25);
+
+  // keys in between and removals, then appending again after the right-most leaf was merged away
+  for (int64_t key = 995; key > 0; key -= 10) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key), transaction));
+  }
+  for (int64_t key = 990; key >= 500; key -= 5) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  for (int64_t key = 1000; key < 1100; key++) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key), transaction));
+  }
+  index_key.SetFromInteger(1099);
+  EXPECT_FALSE(tree.Insert(index_key, RID(0, 0), transaction));
+
+  std::vector<int64_t> expected;
+  for (int64_t key = 0; key < 500; key += 5) {
+    expected.push_back(key);
+  }
+  expected.push_back(995);
+  for (int64_t key = 1000; key < 1100; key++) {
+    expected.push_back(key);
+  }
+  std::vector<int64_t> scanned;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    scanned.push_back((*iterator).second.GetSlotNum());
+  }
+  EXPECT_EQ(scanned, expected);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
@@ -0,0 +1,174 @@
+/**
+ * generic_key_test.cpp
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// the bytewise comparison of normalized keys must agree with comparing the Values
+TEST(GenericKeyTest, NormalizedCompareTest) {
+  Schema *key_schema = ParseCreateStatement("a smallint,b integer,c bigint");
+  GenericComparator<16> comparator(key_schema);
+  ASSERT_TRUE(GenericKey<16>::IsNormalizable(key_schema));
+
+  std::mt19937_64 gen(15445);
+  std::vector<int64_t> edges = {0, 1, -1, INT16_MAX, INT16_MIN + 1, INT32_MAX, INT32_MIN + 1};
+  auto random_values = [&]() {
+    auto pick = [&](int64_t bound) {
+      int64_t v = gen() % 4 == 0 ? edges[gen() % edges.size()] : static_cast<int64_t>(gen() % 1000) - 500;
+      return std::max(-bound, std::min(bound, v));
+    };
+    return std::vector<Value>{ValueFactory::GetSmallIntValue(static_cast<int16_t>(pick(INT16_MAX))),
+                              ValueFactory::GetIntegerValue(static_cast<int32_t>(pick(INT32_MAX))),
+                              ValueFactory::GetBigIntValue(static_cast<int64_t>(gen()) >> (gen() % 64))};
+  };
+
+  for (int i = 0; i < 2000; i++) {
+    auto lhs_values = random_values();
+    auto rhs_values = i % 3 == 0 ? lhs_values : random_values();
+    GenericKey<16> lhs;
+    GenericKey<16> rhs;
+    lhs.SetFromKey(Tuple(lhs_values, key_schema), key_schema);
+    rhs.SetFromKey(Tuple(rhs_values, key_schema), key_schema);
+
+    int expected = 0;
+    for (size_t col = 0; col < lhs_values.size() && expected == 0; col++) {
+      if (lhs_values[col].CompareLessThan(rhs_values[col]) == CmpBool::CmpTrue) {
+        expected = -1;
+      } else if (lhs_values[col].CompareGreaterThan(rhs_values[col]) == CmpBool::CmpTrue) {
+        expected = 1;
+      }
+    }
+    EXPECT_EQ(comparator(lhs, rhs), expected);
+
+    // values survive the encoding
+    for (uint32_t col = 0; col < lhs_values.size(); col++) {
+      EXPECT_EQ(lhs.ToValue(key_schema, col).CompareEquals(lhs_values[col]), CmpBool::CmpTrue);
+    }
+  }
+  delete key_schema;
+}
+
+TEST(GenericKeyTest, NormalizedDecimalAndNullTest) {
+  Schema key_schema({Column("a", TypeId::DECIMAL)});
+  GenericComparator<8> comparator(&key_schema);
+
+  // NULL orders first, -0.0 and 0.0 are equal
+  std::vector<Value> values = {ValueFactory::GetNullValueByType(TypeId::DECIMAL),
+                               ValueFactory::GetDecimalValue(-1e300),
+                               ValueFactory::GetDecimalValue(-2.5),
+                               ValueFactory::GetDecimalValue(-0.0),
+                               ValueFactory::GetDecimalValue(0.0),
+                               ValueFactory::GetDecimalValue(1e-300),
+                               ValueFactory::GetDecimalValue(3.25)};
+  std::vector<GenericKey<8>> keys(values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    keys[i].SetFromKey(Tuple({values[i]}, &key_schema), &key_schema);
+  }
+  for (size_t i = 0; i + 1 < keys.size(); i++) {
+    EXPECT_EQ(comparator(keys[i], keys[i + 1]), i == 3 ? 0 : -1);
+    EXPECT_EQ(comparator(keys[i + 1], keys[i]), i == 3 ? 0 : 1);
+  }
+  EXPECT_TRUE(keys[0].ToValue(&key_schema, 0).IsNull());
+  EXPECT_EQ(keys[6].ToValue(&key_schema, 0).GetAs<double>(), 3.25);
+}
+
+// 4 byte test keys are normalized integers, so they sort numerically and not by their low byte
+TEST(GenericKeyTest, SmallIntegerKeyTest) {
+  Schema *key_schema = ParseCreateStatement("a integer");
+  GenericComparator<4> comparator(key_schema);
+  ASSERT_TRUE(GenericKey<4>::IsNormalizable(key_schema));
+
+  std::vector<int64_t> values = {256, 1, 2, 300, -5};
+  std::vector<GenericKey<4>> keys(values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    keys[i].SetFromInteger(values[i]);
+    EXPECT_EQ(keys[i].ToString(), values[i]);
+  }
+  std::sort(keys.begin(), keys.end(),
+            [&](const GenericKey<4> &lhs, const GenericKey<4> &rhs) { return comparator(lhs, rhs) < 0; });
+  std::vector<int64_t> sorted;
+  for (const auto &key : keys) {
+    sorted.push_back(key.ToString());
+  }
+  EXPECT_EQ(sorted, (std::vector<int64_t>{-5, 1, 2, 256, 300}));
+
+  // and agree with the keys built from tuples
+  GenericKey<4> from_tuple;
+  from_tuple.SetFromKey(Tuple({ValueFactory::GetIntegerValue(300)}, key_schema), key_schema);
+  EXPECT_EQ(comparator(from_tuple, keys[4]), 0);
+  EXPECT_EQ(from_tuple.ToValue(key_schema, 0).GetAs<int32_t>(), 300);
+  delete key_schema;
+}
+
+// the integer form and CountLess() of short normalized keys must agree with the comparator
+TEST(GenericKeyTest, IntegerCompareTest) {
+  Schema *key_schema = ParseCreateStatement("a smallint,b integer");
+  GenericComparator<8> comparator(key_schema);
+  ASSERT_TRUE(comparator.IsIntegerComparable());
+
+  std::mt19937_64 gen(15445);
+  std::vector<std::pair<GenericKey<8>, RID>> pairs(37);
+  for (auto &pair : pairs) {
+    auto a = static_cast<int16_t>(static_cast<int64_t>(gen() % 9) - 4);
+    auto b = static_cast<int32_t>(static_cast<int64_t>(gen() % 2001) - 1000);
+    pair.first.SetFromKey(Tuple({ValueFactory::GetSmallIntValue(a), ValueFactory::GetIntegerValue(b)}, key_schema),
+                          key_schema);
+    // bytes after the key columns are not compared
+    pair.first.data_[7] = static_cast<char>(gen());
+    pair.second = RID(static_cast<page_id_t>(gen()), static_cast<uint32_t>(gen()));
+  }
+  std::sort(pairs.begin(), pairs.end(),
+            [&](const auto &lhs, const auto &rhs) { return comparator(lhs.first, rhs.first) < 0; });
+  for (size_t i = 0; i < pairs.size(); i++) {
+    for (size_t j = 0; j < pairs.size(); j++) {
+      uint64_t lhs = comparator.ToInteger(pairs[i].first);
+      uint64_t rhs = comparator.ToInteger(pairs[j].first);
+      EXPECT_EQ((lhs > rhs) - (lhs < rhs), comparator(pairs[i].first, pairs[j].first));
+    }
+  }
+  for (const auto &probe : pairs) {
+    uint64_t target = comparator.ToInteger(probe.first);
+    for (int count = 0; count <= static_cast<int>(pairs.size()); count++) {
+      int less = 0;
+      int not_greater = 0;
+      for (int i = 0; i < count; i++) {
+        less += comparator(pairs[i].first, probe.first) < 0 ? 1 : 0;
+        not_greater += comparator(pairs[i].first, probe.first) <= 0 ? 1 : 0;
+      }
+      EXPECT_EQ(less, comparator.CountLess(&pairs[0].first, sizeof(pairs[0]), count, target, false));
+      EXPECT_EQ(not_greater, comparator.CountLess(&pairs[0].first, sizeof(pairs[0]), count, target, true));
+    }
+  }
+
+  // wider keys keep using the comparator
+  GenericComparator<16> wide_comparator(key_schema);
+  EXPECT_FALSE(wide_comparator.IsIntegerComparable());
+  delete key_schema;
+}
+
+// keys with a variable length column keep the tuple layout
+TEST(GenericKeyTest, VarcharKeyTest) {
+  Schema *key_schema = ParseCreateStatement("a varchar(8)");
+  GenericComparator<32> comparator(key_schema);
+  EXPECT_FALSE(GenericKey<32>::IsNormalizable(key_schema));
+
+  GenericKey<32> lhs;
+  GenericKey<32> rhs;
+  lhs.SetFromKey(Tuple({ValueFactory::GetVarcharValue("abc")}, key_schema), key_schema);
+  rhs.SetFromKey(Tuple({ValueFactory::GetVarcharValue("abd")}, key_schema), key_schema);
+  EXPECT_EQ(comparator(lhs, rhs), -1);
+  EXPECT_EQ(comparator(rhs, lhs), 1);
+  EXPECT_EQ(comparator(lhs, lhs), 0);
+  delete key_schema;
+}
+
+}  // namespace bustub
@@ -0,0 +1,393 @@
+/**
+ * index_benchmark_test.cpp
+ *
+ * YCSB-style workloads against the Index implementations, reported as CSV.
+ * The full suite is DISABLED_YCSBTest, run it with
+ *   ./test/index_benchmark_test --gtest_also_run_disabled_tests --gtest_filter=*YCSB*
+ * and configure it through the environment:
+ *   BUSTUB_BENCH_KEYS        keys loaded before the workloads (default 100000)
+ *   BUSTUB_BENCH_OPS         operations per run, over all threads (default 100000)
+ *   BUSTUB_BENCH_THREADS     comma separated thread counts (default 1,2,4)
+ *   BUSTUB_BENCH_POOL_SIZES  comma separated buffer pool sizes in pages (default 256,50000)
+ *   BUSTUB_BENCH_CSV         output file (default stdout)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/art_index.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "storage/index/cuckoo_hash_table_index.h"
+#include "storage/index/extendible_hash_table_index.h"
+#include "storage/index/linear_probe_hash_table_index.h"
+#include "storage/index/skip_list_index.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/*
+ * Zipfian ranks in [0, n) with the constant of YCSB (0.99), after Gray et al.,
+ * "Quickly Generating Billion-Record Synthetic Databases". Ranks are scrambled
+ * with FNV-1a as in YCSB's ScrambledZipfianGenerator, so the hot keys are
+ * spread over the key space instead of sitting next to each other.
+ */
+class ZipfianGenerator {
+ public:
+  explicit ZipfianGenerator(uint64_t n, double theta = 0.99) : n_(n), theta_(theta) {
+    double zeta2 = 1 + std::pow(0.5, theta_);
+    for (uint64_t i = 1; i <= n_; i++) {
+      zetan_ += 1 / std::pow(static_cast<double>(i), theta_);
+    }
+    alpha_ = 1 / (1 - theta_);
+    eta_ = (1 - std::pow(2.0 / static_cast<double>(n_), 1 - theta_)) / (1 - zeta2 / zetan_);
+  }
+
+  uint64_t Next(std::mt19937_64 *rng) const {
+    double u = std::uniform_real_distribution<double>(0, 1)(*rng);
+    double uz = u * zetan_;
+    uint64_t rank;
+    if (uz < 1) {
+      rank = 0;
+    } else if (uz < 1 + std::pow(0.5, theta_)) {
+      rank = 1;
+    } else {
+      rank = std::min(n_ - 1, static_cast<uint64_t>(static_cast<double>(n_) * std::pow(eta_ * u - eta_ + 1, alpha_)));
+    }
+    return Fnv1a(rank) % n_;
+  }
+
+ private:
+  static uint64_t Fnv1a(uint64_t value) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < 8; i++) {
+      hash = (hash ^ (value & 0xff)) * 0x100000001b3ULL;
+      value >>= 8;
+    }
+    return hash;
+  }
+
+  uint64_t n_;
+  double theta_;
+  double zetan_{0};
+  double alpha_;
+  double eta_;
+};
+
+enum class Distribution { UNIFORM, ZIPFIAN };
+
+// operation mix in percent, the rest are inserts of new keys
+struct Workload {
+  const char *name_;
+  int read_;
+  int update_;
+  int scan_;
+};
+
+// YCSB B, A and E
+const std::vector<Workload> WORKLOADS = {
+    {"read_heavy", 95, 5, 0},
+    {"update_heavy", 50, 50, 0},
+    {"scan_heavy", 0, 0, 95},
+};
+
+const int MAX_SCAN_LENGTH = 100;
+
+struct IndexUnderTest {
+  const char *name_;
+  std::function<Index *(IndexMetadata *, BufferPoolManager *)> create_;
+  // read up to length entries from key on, empty if the index has no range scans
+  std::function<void(Index *, const GenericKey<8> &, int)> scan_;
+};
+
+std::vector<IndexUnderTest> IndexesUnderTest() {
+  using Key = GenericKey<8>;
+  using Comparator = GenericComparator<8>;
+  return {
+      {"b_plus_tree",
+       [](IndexMetadata *metadata, BufferPoolManager *bpm) {
+         return new BPlusTreeIndex<Key, RID, Comparator>(metadata, bpm);
+       },
+       [](Index *index, const Key &key, int length) {
+         std::vector<std::pair<Key, RID>> batch;
+         static_cast<BPlusTreeIndex<Key, RID, Comparator> *>(index)->ScanRange(&key, true, nullptr, false, {}, &batch,
+                                                                               length);
+       }},
+      {"art",
+       [](IndexMetadata *metadata, BufferPoolManager *bpm) {
+         return new ARTIndex<Key, RID, Comparator>(metadata, bpm);
+       },
+       [](Index *index, const Key &key, int length) {
+         int count = 0;
+         static_cast<ARTIndex<Key, RID, Comparator> *>(index)->ScanRange(
+             &key, nullptr, [&](const Key &, const RID &) { return ++count < length; });
+       }},
+      {"skip_list",
+       [](IndexMetadata *metadata, BufferPoolManager *bpm) {
+         return new SkipListIndex<Key, RID, Comparator>(metadata, bpm);
+       },
+       [](Index *index, const Key &key, int length) {
+         auto it = static_cast<SkipListIndex<Key, RID, Comparator> *>(index)->GetBeginIterator(key);
+         for (int i = 0; i < length && !it.isEnd(); i++) {
+           ++it;
+         }
+       }},
+      {"extendible_hash",
+       [](IndexMetadata *metadata, BufferPoolManager *bpm) {
+         return new ExtendibleHashTableIndex<Key, RID, Comparator>(metadata, bpm, HashFunction<Key>());
+       },
+       {}},
+      // starts small, so that the workloads run through several incremental resizes
+      {"linear_probe_hash",
+       [](IndexMetadata *metadata, BufferPoolManager *bpm) {
+         return new LinearProbeHashTableIndex<Key, RID, Comparator>(metadata, bpm, 1000, HashFunction<Key>());
+       },
+       {}},
+      // starts from one block page and doubles while loading
+      {"cuckoo_hash",
+       [](IndexMetadata *metadata, BufferPoolManager *bpm) {
+         return new CuckooHashTableIndex<Key, RID, Comparator>(metadata, bpm, 1, HashFunction<Key>());
+       },
+       {}},
+  };
+}
+
+struct BenchmarkConfig {
+  int64_t keys_{100000};
+  int64_t ops_{100000};
+  std::vector<int> threads_{1, 2, 4};
+  std::vector<size_t> pool_sizes_{256, 50000};
+};
+
+std::vector<int64_t> ParseList(const char *value) {
+  std::vector<int64_t> list;
+  for (const auto &item : StringUtil::Split(value, ',')) {
+    list.push_back(std::stoll(item));
+  }
+  return list;
+}
+
+BenchmarkConfig ConfigFromEnvironment() {
+  BenchmarkConfig config;
+  if (const char *value = std::getenv("BUSTUB_BENCH_KEYS")) {
+    config.keys_ = std::stoll(value);
+  }
+  if (const char *value = std::getenv("BUSTUB_BENCH_OPS")) {
+    config.ops_ = std::stoll(value);
+  }
+  if (const char *value = std::getenv("BUSTUB_BENCH_THREADS")) {
+    auto list = ParseList(value);
+    config.threads_.assign(list.begin(), list.end());
+  }
+  if (const char *value = std::getenv("BUSTUB_BENCH_POOL_SIZES")) {
+    auto list = ParseList(value);
+    config.pool_sizes_.assign(list.begin(), list.end());
+  }
+  return config;
+}
+
+/*
+ * One CSV row from the latencies (in nanoseconds) of all operations of a run.
+ */
+void Report(std::ostream &out, const char *index, const char *workload, const char *distribution, int threads,
+            size_t pool_size, std::vector<uint64_t> *latencies, double seconds) {
+  std::sort(latencies->begin(), latencies->end());
+  auto percentile = [&](double p) {
+    if (latencies->empty()) {
+      return 0.0;
+    }
+    size_t rank = std::min(latencies->size() - 1, static_cast<size_t>(p * static_cast<double>(latencies->size())));
+    return static_cast<double>((*latencies)[rank]) / 1000;
+  };
+  out << index << "," << workload << "," << distribution << "," << threads << "," << pool_size << ","
+      << latencies->size() << "," << static_cast<uint64_t>(static_cast<double>(latencies->size()) / seconds) << ","
+      << percentile(0.5) << "," << percentile(0.99) << "," << percentile(0.999) << std::endl;
+}
+
+/*
+ * For every buffer pool size and index: load config.keys_ keys in random order
+ * (reported as the "load" workload), then run every workload with both key
+ * distributions at every thread count on the loaded index. Updates delete and
+ * re-insert the pair of an existing key; scans read up to MAX_SCAN_LENGTH
+ * entries and are skipped for indexes without range scans.
+ */
+void RunBenchmark(const BenchmarkConfig &config, std::ostream &out) {
+  out << "index,workload,distribution,threads,pool_size,ops,ops_per_sec,p50_us,p99_us,p999_us" << std::endl;
+  Schema *schema = ParseCreateStatement("a bigint");
+  std::vector<Tuple> tuples;
+  tuples.reserve(config.keys_);
+  for (int64_t key = 0; key < config.keys_; key++) {
+    tuples.emplace_back(std::vector<Value>{ValueFactory::GetBigIntValue(key)}, schema);
+  }
+  ZipfianGenerator zipfian(config.keys_);
+
+  for (auto pool_size : config.pool_sizes_) {
+    for (const auto &index_under_test : IndexesUnderTest()) {
+      auto *disk_manager = new DiskManager("bench.db");
+      auto *bpm = new BufferPoolManager(pool_size, disk_manager);
+      page_id_t page_id;
+      bpm->NewPage(&page_id);
+      std::unique_ptr<Index> index(
+          index_under_test.create_(new IndexMetadata("bench_index", "bench", schema, {0}), bpm));
+
+      std::vector<int64_t> order(config.keys_);
+      for (int64_t key = 0; key < config.keys_; key++) {
+        order[key] = key;
+      }
+      std::shuffle(order.begin(), order.end(), std::mt19937_64(15445));
+      // the B+ tree latch crabbing records its latches in the transaction
+      Transaction load_transaction(0);
+      std::vector<uint64_t> latencies;
+      latencies.reserve(config.keys_);
+      auto load_start = std::chrono::steady_clock::now();
+      for (auto key : order) {
+        auto start = std::chrono::steady_clock::now();
+        index->InsertEntry(tuples[key], RID(0, static_cast<uint32_t>(key)), &load_transaction);
+        latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                                .count());
+      }
+      double load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - load_start).count();
+      Report(out, index_under_test.name_, "load", "uniform", 1, pool_size, &latencies, load_seconds);
+
+      std::atomic<int64_t> next_key{config.keys_};
+      for (const auto &workload : WORKLOADS) {
+        if (workload.scan_ > 0 && !index_under_test.scan_) {
+          continue;
+        }
+        for (auto distribution : {Distribution::UNIFORM, Distribution::ZIPFIAN}) {
+          for (auto num_threads : config.threads_) {
+            std::vector<std::vector<uint64_t>> thread_latencies(num_threads);
+            std::vector<std::thread> threads;
+            auto start = std::chrono::steady_clock::now();
+            for (int t = 0; t < num_threads; t++) {
+              threads.emplace_back([&, t] {
+                Transaction transaction(t);
+                std::mt19937_64 rng(15445 + t);
+                std::uniform_int_distribution<int64_t> uniform(0, config.keys_ - 1);
+                std::vector<RID> rids;
+                auto &own_latencies = thread_latencies[t];
+                own_latencies.reserve(config.ops_ / num_threads + 1);
+                for (int64_t i = t; i < config.ops_; i += num_threads) {
+                  int64_t key = distribution == Distribution::UNIFORM ? uniform(rng) : zipfian.Next(&rng);
+                  int op = static_cast<int>(rng() % 100);
+                  auto op_start = std::chrono::steady_clock::now();
+                  if (op < workload.read_) {
+                    rids.clear();
+                    index->ScanKey(tuples[key], &rids, &transaction);
+                  } else if (op < workload.read_ + workload.update_) {
+                    index->DeleteEntry(tuples[key], RID(0, static_cast<uint32_t>(key)), &transaction);
+                    index->InsertEntry(tuples[key], RID(0, static_cast<uint32_t>(key)), &transaction);
+                  } else if (op < workload.read_ + workload.update_ + workload.scan_) {
+                    GenericKey<8> index_key;
+                    index_key.SetFromInteger(key);
+                    index_under_test.scan_(index.get(), index_key, 1 + static_cast<int>(rng() % MAX_SCAN_LENGTH));
+                  } else {
+                    int64_t new_key = next_key++;
+                    Tuple tuple(std::vector<Value>{ValueFactory::GetBigIntValue(new_key)}, schema);
+                    index->InsertEntry(tuple, RID(1, static_cast<uint32_t>(new_key)), &transaction);
+                  }
+                  own_latencies.push_back(
+                      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - op_start)
+                          .count());
+                }
+              });
+            }
+            for (auto &thread : threads) {
+              thread.join();
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            latencies.clear();
+            for (const auto &own_latencies : thread_latencies) {
+              latencies.insert(latencies.end(), own_latencies.begin(), own_latencies.end());
+            }
+            Report(out, index_under_test.name_, workload.name_,
+                   distribution == Distribution::UNIFORM ? "uniform" : "zipfian", num_threads, pool_size, &latencies,
+                   seconds);
+          }
+        }
+      }
+
+      index.reset();
+      bpm->UnpinPage(HEADER_PAGE_ID, true);
+      delete bpm;
+      delete disk_manager;
+      remove("bench.db");
+      remove("bench.log");
+    }
+  }
+  delete schema;
+}
+
+}  // namespace
+
+TEST(IndexBenchmarkTest, ZipfianTest) {
+  const uint64_t n = 1000;
+  ZipfianGenerator zipfian(n);
+  std::mt19937_64 rng(15445);
+  std::vector<int> counts(n, 0);
+  for (int i = 0; i < 100000; i++) {
+    uint64_t key = zipfian.Next(&rng);
+    ASSERT_LT(key, n);
+    counts[key]++;
+  }
+  // the most popular key gets about 1 / zeta(n) of the draws, far above the uniform share
+  std::sort(counts.rbegin(), counts.rend());
+  EXPECT_GT(counts[0], 100000 / 20);
+  EXPECT_GT(counts[0], counts[9] * 5);
+}
+
+TEST(IndexBenchmarkTest, SmokeTest) {
+  BenchmarkConfig config;
+  config.keys_ = 2000;
+  config.ops_ = 2000;
+  config.threads_ = {2};
+  config.pool_sizes_ = {64};
+  std::stringstream out;
+  RunBenchmark(config, out);
+  std::string line;
+  std::getline(out, line);
+  EXPECT_EQ(line, "index,workload,distribution,threads,pool_size,ops,ops_per_sec,p50_us,p99_us,p999_us");
+  int rows = 0;
+  while (std::getline(out, line)) {
+    EXPECT_EQ(std::count(line.begin(), line.end(), ','), 9);
+    rows++;
+  }
+  // per index: the load, and every workload it supports with both distributions
+  int expected_rows = 0;
+  for (const auto &index_under_test : IndexesUnderTest()) {
+    expected_rows++;
+    for (const auto &workload : WORKLOADS) {
+      expected_rows += workload.scan_ == 0 || index_under_test.scan_ ? 2 : 0;
+    }
+  }
+  EXPECT_EQ(rows, expected_rows);
+}
+
+TEST(IndexBenchmarkTest, DISABLED_YCSBTest) {
+  BenchmarkConfig config = ConfigFromEnvironment();
+  if (const char *path = std::getenv("BUSTUB_BENCH_CSV")) {
+    std::ofstream out(path);
+    RunBenchmark(config, out);
+  } else {
+    RunBenchmark(config, std::cout);
+  }
+}
+
+}  // namespace bustub
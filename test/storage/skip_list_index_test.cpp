@@ -0,0 +1,194 @@
+/**
+ * skip_list_index_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "storage/index/skip_list_index.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+TEST(SkipListIndexTest, InsertIterateRemoveTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  SkipList<GenericKey<8>, RID, GenericComparator<8>> list(comparator);
+
+  std::vector<int64_t> keys;
+  for (int64_t key = -1000; key < 1000; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(list.Insert(index_key, RID(0, static_cast<uint32_t>(key + 1000))));
+  }
+  // a key takes several values, but each pair only once
+  index_key.SetFromInteger(5);
+  EXPECT_FALSE(list.Insert(index_key, RID(0, 1005)));
+  EXPECT_TRUE(list.Insert(index_key, RID(1, 0)));
+  std::vector<RID> rids;
+  EXPECT_TRUE(list.GetValue(index_key, &rids));
+  EXPECT_EQ(rids, std::vector<RID>({RID(0, 1005), RID(1, 0)}));
+
+  // remove the odd keys
+  for (int64_t key = -999; key < 1000; key += 2) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(list.Remove(index_key, RID(0, static_cast<uint32_t>(key + 1000))));
+    EXPECT_FALSE(list.Remove(index_key, RID(0, static_cast<uint32_t>(key + 1000))));
+  }
+  index_key.SetFromInteger(5);
+  EXPECT_TRUE(list.Remove(index_key, RID(1, 0)));
+  rids.clear();
+  EXPECT_FALSE(list.GetValue(index_key, &rids));
+
+  // ordered iteration from a removed key, as with IndexIterator
+  index_key.SetFromInteger(-1);
+  int64_t expected = 0;
+  for (auto it = list.Begin(index_key); !it.isEnd(); ++it) {
+    EXPECT_EQ((*it).first.ToString(), expected);
+    EXPECT_EQ((*it).second.GetSlotNum(), expected + 1000);
+    expected += 2;
+  }
+  EXPECT_EQ(expected, 1000);
+  int count = 0;
+  for (auto it = list.Begin(); !it.isEnd(); ++it) {
+    count++;
+  }
+  EXPECT_EQ(count, 1000);
+  EXPECT_TRUE(list.End().isEnd());
+  delete key_schema;
+}
+
+TEST(SkipListIndexTest, ConcurrentTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  SkipList<GenericKey<8>, RID, GenericComparator<8>> list(comparator);
+  const int num_threads = 4;
+  const int per_thread = 20000;
+  // every thread inserts its keys and removes the odd ones; an iterator runs alongside
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      GenericKey<8> index_key;
+      for (int i = 0; i < per_thread; i++) {
+        int64_t key = static_cast<int64_t>(i) * num_threads + t;
+        index_key.SetFromInteger(key);
+        EXPECT_TRUE(list.Insert(index_key, RID(0, static_cast<uint32_t>(key))));
+      }
+      for (int i = 1; i < per_thread; i += 2) {
+        int64_t key = static_cast<int64_t>(i) * num_threads + t;
+        index_key.SetFromInteger(key);
+        EXPECT_TRUE(list.Remove(index_key, RID(0, static_cast<uint32_t>(key))));
+      }
+    });
+  }
+  threads.emplace_back([&] {
+    for (int round = 0; round < 20; round++) {
+      int64_t prev = -1;
+      for (auto it = list.Begin(); !it.isEnd(); ++it) {
+        EXPECT_GT((*it).first.ToString(), prev);
+        prev = (*it).first.ToString();
+      }
+    }
+  });
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  int64_t expected = 0;
+  for (auto it = list.Begin(); !it.isEnd(); ++it) {
+    EXPECT_EQ((*it).first.ToString(), expected);
+    expected += expected % num_threads == num_threads - 1 ? num_threads + 1 : 1;
+  }
+  EXPECT_EQ(expected, static_cast<int64_t>(per_thread) * num_threads);
+  delete key_schema;
+}
+
+TEST(SkipListIndexTest, IndexTest) {
+  Schema *schema = ParseCreateStatement("a bigint");
+  // the index owns its metadata
+  SkipListIndex<GenericKey<8>, RID, GenericComparator<8>> index(new IndexMetadata("foo_pk", "foo", schema, {0}),
+                                                                nullptr);
+  for (int64_t key = 0; key < 100; key++) {
+    index.InsertEntry(Tuple({ValueFactory::GetBigIntValue(key)}, schema), RID(0, key), nullptr);
+  }
+  index.DeleteEntry(Tuple({ValueFactory::GetBigIntValue(7)}, schema), RID(0, 7), nullptr);
+  std::vector<RID> rids;
+  index.ScanKey(Tuple({ValueFactory::GetBigIntValue(7)}, schema), &rids, nullptr);
+  EXPECT_TRUE(rids.empty());
+  index.ScanKey(Tuple({ValueFactory::GetBigIntValue(8)}, schema), &rids, nullptr);
+  EXPECT_EQ(rids, std::vector<RID>({RID(0, 8)}));
+  int count = 0;
+  for (auto it = index.GetBeginIterator(); !it.isEnd(); ++it) {
+    count++;
+  }
+  EXPECT_EQ(count, 99);
+  delete schema;
+}
+
+/*
+ * Concurrent random inserts into SkipListIndex and BPlusTreeIndex with a
+ * growing number of threads, run with --gtest_also_run_disabled_tests.
+ */
+TEST(SkipListIndexTest, DISABLED_ScalabilityTest) {
+  const int num_keys = 400000;
+  Schema *schema = ParseCreateStatement("a bigint");
+  std::vector<Tuple> tuples;
+  std::mt19937_64 rng(15445);
+  for (int i = 0; i < num_keys; i++) {
+    tuples.emplace_back(std::vector<Value>{ValueFactory::GetBigIntValue(static_cast<int64_t>(rng() >> 1))}, schema);
+  }
+  auto run = [&](const char *name, Index *index, int num_threads) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&, t] {
+        // the B+ tree latch crabbing records its latches in the transaction
+        Transaction transaction(0);
+        for (int i = t; i < num_keys; i += num_threads) {
+          index->InsertEntry(tuples[i], RID(0, i), &transaction);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << " " << num_threads << " threads: " << ms << " ms" << std::endl;
+  };
+  for (int num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    DiskManager *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManager(50000, disk_manager);
+    page_id_t page_id;
+    bpm->NewPage(&page_id);
+    {
+      BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> b_plus_tree(
+          new IndexMetadata("foo_pk", "foo", schema, {0}), bpm);
+      SkipListIndex<GenericKey<8>, RID, GenericComparator<8>> skip_list(
+          new IndexMetadata("foo_sl", "foo", schema, {0}), bpm);
+      run("b+ tree", &b_plus_tree, num_threads);
+      run("skip list", &skip_list, num_threads);
+    }
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete bpm;
+    delete disk_manager;
+    remove("test.db");
+    remove("test.log");
+  }
+  delete schema;
+}
+
+}  // namespace bustub
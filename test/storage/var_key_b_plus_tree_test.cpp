@@ -0,0 +1,194 @@
+/**
+ * var_key_b_plus_tree_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/var_key_b_plus_tree.h"
+#include "storage/page/b_plus_tree_slotted_page.h"
+
+namespace bustub {
+
+TEST(VarKeyBPlusTreeTest, SlottedPageTest) {
+  char data[PAGE_SIZE];
+  auto *page = reinterpret_cast<BPlusTreeSlottedPage<RID> *>(data);
+  page->Init(1, INVALID_PAGE_ID, IndexPageType::LEAF_PAGE);
+  std::string url_prefix = "https://www.example.com/users/profile/";
+  int count = 0;
+  while (page->Insert(count, url_prefix + std::to_string(10000 + count), RID(count, count))) {
+    count++;
+  }
+  // entries only keep the 5 byte suffix, far more than raw 43 byte keys would allow
+  EXPECT_EQ(page->GetPrefix(), url_prefix + "10");
+  EXPECT_GT(count, PAGE_SIZE / (static_cast<int>(url_prefix.size()) + 5));
+  for (int i = 0; i < count; i++) {
+    EXPECT_EQ(page->KeyAt(i), url_prefix + std::to_string(10000 + i));
+    EXPECT_EQ(page->ValueAt(i).GetPageId(), i);
+  }
+  EXPECT_EQ(page->KeyIndex(url_prefix + "10005"), 5);
+  EXPECT_EQ(page->KeyIndex(url_prefix + "100050"), 6);
+  EXPECT_EQ(page->KeyIndex("a"), 0);
+  EXPECT_EQ(page->KeyIndex("z"), count);
+
+  // a key outside the prefix rebuilds the page with a shorter prefix, which only fits once entries are removed
+  EXPECT_FALSE(page->Insert(0, "https://", RID(-1, 0)));
+  while (page->GetSize() > 10) {
+    page->Remove(page->GetSize() - 1);
+  }
+  EXPECT_TRUE(page->Insert(0, "https://", RID(-1, 0)));
+  EXPECT_EQ(page->GetPrefix(), "https://");
+  EXPECT_EQ(page->KeyAt(0), "https://");
+  EXPECT_EQ(page->KeyAt(1), url_prefix + "10000");
+
+  std::vector<BPlusTreeSlottedPage<RID>::Entry> entries;
+  page->GetEntries(&entries);
+  int split = BPlusTreeSlottedPage<RID>::SplitIndex(entries, true);
+  EXPECT_GT(split, 0);
+  EXPECT_LT(split, static_cast<int>(entries.size()));
+}
+
+TEST(VarKeyBPlusTreeTest, InsertScanRemoveTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  VarKeyBPlusTree tree("foo_pk", bpm);
+  EXPECT_TRUE(tree.IsEmpty());
+
+  // long keys with long shared prefixes and different lengths
+  std::vector<std::string> keys;
+  for (int i = 0; i < 5000; i++) {
+    keys.push_back("/home/user/projects/bustub/src/" + std::to_string(i % 17) + "/" + std::to_string(i) +
+                   std::string(i % 50, 'x'));
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (size_t i = 0; i < keys.size(); i++) {
+    EXPECT_TRUE(tree.Insert(keys[i], RID(static_cast<page_id_t>(i), 0)));
+  }
+  EXPECT_FALSE(tree.Insert(keys[0], RID(0, 1)));
+  EXPECT_FALSE(tree.Insert(std::string(SLOTTED_PAGE_MAX_KEY_SIZE + 1, 'a'), RID(0, 1)));
+  EXPECT_TRUE(tree.Insert(std::string(SLOTTED_PAGE_MAX_KEY_SIZE, 'a'), RID(0, 1)));
+
+  std::vector<RID> rids;
+  for (size_t i = 0; i < keys.size(); i++) {
+    rids.clear();
+    EXPECT_TRUE(tree.GetValue(keys[i], &rids));
+    ASSERT_EQ(rids.size(), 1);
+    EXPECT_EQ(rids[0].GetPageId(), static_cast<page_id_t>(i));
+  }
+  rids.clear();
+  EXPECT_FALSE(tree.GetValue("/home/user/projects/bustub/src/", &rids));
+
+  std::vector<std::string> sorted_keys(keys);
+  sorted_keys.emplace_back(SLOTTED_PAGE_MAX_KEY_SIZE, 'a');
+  std::sort(sorted_keys.begin(), sorted_keys.end());
+  std::vector<std::string> scanned;
+  tree.Scan("", [&](const std::string &key, const RID &rid) {
+    scanned.push_back(key);
+    return true;
+  });
+  EXPECT_EQ(scanned, sorted_keys);
+
+  // remove every other key, then scan from the middle
+  std::vector<std::string> kept;
+  for (size_t i = 0; i < sorted_keys.size(); i++) {
+    if (i % 2 == 0) {
+      tree.Remove(sorted_keys[i]);
+    } else {
+      kept.push_back(sorted_keys[i]);
+    }
+  }
+  for (size_t i = 0; i < sorted_keys.size(); i++) {
+    rids.clear();
+    EXPECT_EQ(tree.GetValue(sorted_keys[i], &rids), i % 2 == 1);
+  }
+  scanned.clear();
+  const std::string &lo = sorted_keys[sorted_keys.size() / 2];
+  tree.Scan(lo, [&](const std::string &key, const RID &rid) {
+    scanned.push_back(key);
+    return scanned.size() < 100;
+  });
+  auto it = std::lower_bound(kept.begin(), kept.end(), lo);
+  EXPECT_EQ(scanned, std::vector<std::string>(it, it + 100));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(VarKeyBPlusTreeTest, ConcurrentTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+  VarKeyBPlusTree tree("foo_pk", bpm);
+
+  const int num_threads = 4;
+  const int per_thread = 3000;
+  auto make_key = [](int key) { return "/var/lib/bustub/" + std::to_string(key) + std::string(key % 40, 'y'); };
+  // threads insert interleaved keys, remove the odd ones, and look up keys of the others meanwhile
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      std::vector<RID> rids;
+      for (int i = 0; i < per_thread; i++) {
+        int key = i * num_threads + t;
+        EXPECT_TRUE(tree.Insert(make_key(key), RID(key, 0)));
+        rids.clear();
+        tree.GetValue(make_key(key ^ 1), &rids);
+      }
+      for (int i = 1; i < per_thread; i += 2) {
+        tree.Remove(make_key(i * num_threads + t));
+      }
+    });
+  }
+  // a scanner running alongside only ever sees ascending keys
+  threads.emplace_back([&] {
+    for (int round = 0; round < 20; round++) {
+      std::string prev;
+      tree.Scan("", [&](const std::string &key, const RID &rid) {
+        EXPECT_LT(prev, key);
+        prev = key;
+        return true;
+      });
+    }
+  });
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::vector<std::string> expected;
+  for (int i = 0; i < per_thread; i += 2) {
+    for (int t = 0; t < num_threads; t++) {
+      expected.push_back(make_key(i * num_threads + t));
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+  std::vector<std::string> scanned;
+  tree.Scan("", [&](const std::string &key, const RID &rid) {
+    scanned.push_back(key);
+    return true;
+  });
+  EXPECT_EQ(scanned, expected);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub